@@ -0,0 +1,525 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Checks the wserver station, matrix and subscription messages against
+ *	a wmediumd started in dynamic mode (wmediumd -d -s), see dynamic.sh.
+ *	Given a window in ms, checks the merging of station updates of a
+ *	wmediumd started with that window (-u) instead.
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include "../wmediumd/wserver_messages.h"
+#include <stdlib.h>
+#include <sys/un.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+/* Station IDs carry the slot in their low bits, as in wmediumd_dynamic.h */
+#define ID_INDEX_MASK ((1 << 20) - 1)
+
+/* Stations added in bulk */
+#define NUM_BULK 8
+
+/* How long to wait for a response or notification [s] */
+#define RECV_TIMEOUT 5
+
+#define check(cond, ...) \
+    { \
+        if (!(cond)) { \
+            fprintf(stderr, "FAILED line %d: ", __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+            exit(EXIT_FAILURE); \
+        } \
+    }
+
+#define send_request(connection_soc, request, type) \
+    { \
+        int ret = wserver_send_msg(connection_soc, request, type); \
+        check(ret >= 0, "error while sending " #type); \
+    }
+
+#define send_entries(connection_soc, entries, count, type) \
+    { \
+        int ret = wserver_send_entries(connection_soc, entries, count, type); \
+        check(ret >= 0, "error while sending " #type); \
+    }
+
+#define receive_response(connection_soc, response, elemtype, typeint) \
+    { \
+        wserver_msg base; \
+        int recv_type; \
+        int ret = wserver_recv_msg_base(connection_soc, &base, &recv_type); \
+        check(ret >= 0, "error while receiving " #elemtype); \
+        check(recv_type == typeint, "received type %d instead of %d", recv_type, typeint); \
+        ret = wserver_recv_msg(connection_soc, response, elemtype); \
+        check(ret >= 0, "error while receiving " #elemtype); \
+    }
+
+#define receive_entries(connection_soc, entries, count, type) \
+    { \
+        int ret = wserver_recv_entries(connection_soc, entries, count, type); \
+        check(ret >= 0, "error while receiving " #type); \
+    }
+
+static void bulk_addr(int i, u8 *addr) {
+    u8 bulk[ETH_ALEN] = {0x02, 0x00, 0x00, 0xee, 0x01, (u8) i};
+    memcpy(addr, bulk, ETH_ALEN);
+}
+
+static const u8 addr_a[ETH_ALEN] = {0x02, 0x00, 0x00, 0xee, 0x00, 0x01};
+static const u8 addr_b[ETH_ALEN] = {0x02, 0x00, 0x00, 0xee, 0x00, 0x02};
+static const u8 addr_c[ETH_ALEN] = {0x02, 0x00, 0x00, 0xee, 0x00, 0x03};
+
+static i32 matrix_snr(int from, int to) {
+    return 10 + from * NUM_BULK + to;
+}
+
+static int connect_server(void) {
+    struct sockaddr_un address;
+    struct timeval timeout = {RECV_TIMEOUT, 0};
+    int soc = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    check(soc >= 0, "socket creation failed");
+    address.sun_family = AF_LOCAL;
+    strcpy(address.sun_path, WSERVER_SOCKET_PATH);
+    check(connect(soc, (struct sockaddr *) &address, sizeof(address)) == 0,
+          "server connection failed");
+    setsockopt(soc, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return soc;
+}
+
+static station_add_response add_station(int soc, const u8 *addr) {
+    station_add_request request;
+    station_add_response response;
+
+    memcpy(request.addr, addr, ETH_ALEN);
+    send_request(soc, &request, station_add_request);
+    receive_response(soc, &response, station_add_response, WSERVER_ADD_RESPONSE_TYPE);
+    return response;
+}
+
+static u8 del_station_by_id(int soc, i32 id) {
+    station_del_by_id_request request;
+    station_del_by_id_response response;
+
+    request.id = id;
+    send_request(soc, &request, station_del_by_id_request);
+    receive_response(soc, &response, station_del_by_id_response, WSERVER_DEL_BY_ID_RESPONSE_TYPE);
+    return response.update_result;
+}
+
+static link_query_response query_link(int soc, const u8 *from, const u8 *to) {
+    link_query_request request;
+    link_query_response response;
+
+    memcpy(request.from_addr, from, ETH_ALEN);
+    memcpy(request.to_addr, to, ETH_ALEN);
+    send_request(soc, &request, link_query_request);
+    receive_response(soc, &response, link_query_response, WSERVER_LINK_QUERY_RESPONSE_TYPE);
+    return response;
+}
+
+/**
+ * Query one station
+ * @param version Receives the link state version, may be NULL
+ * @return The update_result of its entry
+ */
+static u8 query_station(int soc, const u8 *addr, station_info_entry *info, u32 *version) {
+    station_query_request request = {.count = 1};
+    station_query_response response;
+    matrix_addr_entry entry;
+
+    memcpy(entry.addr, addr, ETH_ALEN);
+    send_request(soc, &request, station_query_request);
+    send_entries(soc, &entry, 1, matrix_addr_entry);
+    receive_response(soc, &response, station_query_response, WSERVER_STATION_QUERY_RESPONSE_TYPE);
+    check(response.count == 1, "station query returned %u entries", response.count);
+    receive_entries(soc, info, 1, station_info_entry);
+    if (version)
+        *version = response.version;
+    return info->update_result;
+}
+
+/**
+ * Wait for a delta of the link from -> to in the notifications of soc
+ */
+static link_delta_entry wait_for_delta(int soc, const u8 *from, const u8 *to) {
+    for (;;) {
+        link_delta_notification notification;
+        receive_response(soc, &notification, link_delta_notification, WSERVER_LINK_DELTA_NOTIFICATION_TYPE);
+        check(notification.count > 0, "empty delta notification");
+
+        link_delta_entry *entries = malloc(sizeof(*entries) * notification.count);
+        check(entries != NULL, "out of memory");
+        receive_entries(soc, entries, notification.count, link_delta_entry);
+        for (u32 i = 0; i < notification.count; i++) {
+            if (!memcmp(entries[i].from_addr, from, ETH_ALEN) && !memcmp(entries[i].to_addr, to, ETH_ALEN)) {
+                link_delta_entry found = entries[i];
+                free(entries);
+                return found;
+            }
+        }
+        free(entries);
+    }
+}
+
+/* Add, delete and re-add stations, stale IDs must not match the new station */
+static void test_station_ids(int soc) {
+    printf("==== station ids\n");
+    station_add_response added = add_station(soc, addr_a);
+    check(added.update_result == WUPDATE_SUCCESS, "add failed: %d", added.update_result);
+    i32 id_a = added.created_id;
+
+    added = add_station(soc, addr_a);
+    check(added.update_result == WUPDATE_INTF_DUPLICATE, "duplicate add returned %d", added.update_result);
+
+    check(del_station_by_id(soc, id_a) == WUPDATE_SUCCESS, "delete by id failed");
+    check(del_station_by_id(soc, id_a) == WUPDATE_INTF_NOTFOUND, "deleted id still found");
+
+    // the slot of a is reused with a new generation
+    added = add_station(soc, addr_b);
+    check(added.update_result == WUPDATE_SUCCESS, "re-add failed: %d", added.update_result);
+    i32 id_b = added.created_id;
+    check((id_b & ID_INDEX_MASK) == (id_a & ID_INDEX_MASK), "slot %d not reused, got %d",
+          id_a & ID_INDEX_MASK, id_b & ID_INDEX_MASK);
+    check(id_b != id_a, "reused slot kept id %d", id_a);
+
+    check(del_station_by_id(soc, id_a) == WUPDATE_INTF_NOTFOUND, "stale id deleted a station");
+    station_info_entry info;
+    check(query_station(soc, addr_b, &info, NULL) == WUPDATE_SUCCESS, "station lost to a stale id");
+    check(del_station_by_id(soc, id_b) == WUPDATE_SUCCESS, "delete of the re-added station failed");
+    printf("ids %d and %d share slot %d\n", id_a, id_b, id_a & ID_INDEX_MASK);
+}
+
+static void test_bulk_add(int soc) {
+    station_bulk_add_request request = {.count = NUM_BULK};
+    station_bulk_add_entry entries[NUM_BULK];
+    station_bulk_add_response response;
+    station_bulk_add_result results[NUM_BULK];
+
+    printf("==== bulk add\n");
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < NUM_BULK; i++) {
+        bulk_addr(i, entries[i].addr);
+        entries[i].props = WPROP_POSITION | WPROP_TXPOWER;
+        entries[i].posX = (f32) i * 10;
+        entries[i].posY = 5;
+        entries[i].posZ = 1;
+        entries[i].txpower_ = 15;
+    }
+    send_request(soc, &request, station_bulk_add_request);
+    send_entries(soc, entries, NUM_BULK, station_bulk_add_entry);
+    receive_response(soc, &response, station_bulk_add_response, WSERVER_BULK_ADD_RESPONSE_TYPE);
+    check(response.count == NUM_BULK, "bulk add returned %u results", response.count);
+    receive_entries(soc, results, NUM_BULK, station_bulk_add_result);
+    for (int i = 0; i < NUM_BULK; i++) {
+        check(results[i].update_result == WUPDATE_SUCCESS, "bulk add of station %d failed: %d", i,
+              results[i].update_result);
+        for (int j = 0; j < i; j++)
+            check(results[i].created_id != results[j].created_id, "stations %d and %d share id %d", j, i,
+                  results[i].created_id);
+    }
+
+    station_info_entry info;
+    u8 addr[ETH_ALEN];
+    bulk_addr(3, addr);
+    check(query_station(soc, addr, &info, NULL) == WUPDATE_SUCCESS, "bulk station not found");
+    check(info.posX == 30 && info.posY == 5 && info.txpower_ == 15, "bulk station has wrong properties");
+}
+
+/* Upload the full SNR matrix of the bulk stations and read it back */
+static void test_matrix_rows(int soc) {
+    matrix_rows_request request = {.matrix = WMATRIX_SNR, .num_rows = NUM_BULK, .num_cols = NUM_BULK};
+    matrix_addr_entry addrs[NUM_BULK];
+    matrix_value_entry values[NUM_BULK * NUM_BULK];
+    matrix_rows_response response;
+
+    printf("==== matrix rows\n");
+    for (int i = 0; i < NUM_BULK; i++) {
+        bulk_addr(i, addrs[i].addr);
+        for (int j = 0; j < NUM_BULK; j++)
+            values[i * NUM_BULK + j].value = (u32) matrix_snr(i, j);
+    }
+    send_request(soc, &request, matrix_rows_request);
+    send_entries(soc, addrs, NUM_BULK, matrix_addr_entry);
+    send_entries(soc, addrs, NUM_BULK, matrix_addr_entry);
+    send_entries(soc, values, NUM_BULK * NUM_BULK, matrix_value_entry);
+    receive_response(soc, &response, matrix_rows_response, WSERVER_MATRIX_ROWS_RESPONSE_TYPE);
+    check(response.update_result == WUPDATE_SUCCESS, "matrix upload failed: %d", response.update_result);
+    check(response.applied == NUM_BULK * NUM_BULK && response.not_found == 0,
+          "matrix upload applied %u links, %u unknown", response.applied, response.not_found);
+
+    printf("==== matrix query\n");
+    matrix_query_request query = {.matrix = WMATRIX_SNR, .num_rows = NUM_BULK};
+    matrix_query_response answer;
+    send_request(soc, &query, matrix_query_request);
+    send_entries(soc, addrs, NUM_BULK, matrix_addr_entry);
+    receive_response(soc, &answer, matrix_query_response, WSERVER_MATRIX_QUERY_RESPONSE_TYPE);
+    check(answer.update_result == WUPDATE_SUCCESS && answer.num_rows == NUM_BULK,
+          "matrix query failed: %d, %u rows", answer.update_result, answer.num_rows);
+
+    matrix_addr_entry *rows = malloc(sizeof(*rows) * (answer.num_rows + answer.num_cols));
+    matrix_value_entry *cells = malloc(sizeof(*cells) * answer.num_rows * answer.num_cols + 1);
+    check(rows && cells, "out of memory");
+    receive_entries(soc, rows, answer.num_rows + answer.num_cols, matrix_addr_entry);
+    receive_entries(soc, cells, answer.num_rows * answer.num_cols, matrix_value_entry);
+    matrix_addr_entry *cols = rows + answer.num_rows;
+    int compared = 0;
+    for (u32 r = 0; r < answer.num_rows; r++) {
+        for (u32 c = 0; c < answer.num_cols; c++) {
+            // the columns are every station, in the server's order
+            if (memcmp(cols[c].addr, addrs[0].addr, ETH_ALEN - 1))
+                continue;
+            int from = rows[r].addr[ETH_ALEN - 1], to = cols[c].addr[ETH_ALEN - 1];
+            i32 value = (i32) cells[r * answer.num_cols + c].value;
+            check(value == matrix_snr(from, to), "link %d -> %d reads %d instead of %d", from, to, value,
+                  matrix_snr(from, to));
+            compared++;
+        }
+    }
+    check(compared == NUM_BULK * NUM_BULK, "compared %d links", compared);
+    free(rows);
+    free(cells);
+}
+
+static void set_link(int soc, int from, int to, i32 snr, u8 flags) {
+    matrix_triplets_request request = {.matrix = WMATRIX_SNR, .flags = flags, .count = 1};
+    matrix_triplet_entry entry;
+    matrix_triplets_response response;
+
+    bulk_addr(from, entry.from_addr);
+    bulk_addr(to, entry.to_addr);
+    entry.value = (u32) snr;
+    send_request(soc, &request, matrix_triplets_request);
+    send_entries(soc, &entry, 1, matrix_triplet_entry);
+    receive_response(soc, &response, matrix_triplets_response, WSERVER_MATRIX_TRIPLETS_RESPONSE_TYPE);
+    check(response.update_result == WUPDATE_SUCCESS && response.applied == 1,
+          "triplet upload failed: %d, %u applied", response.update_result, response.applied);
+}
+
+static void test_matrix_triplets(int soc) {
+    u8 from[ETH_ALEN], to[ETH_ALEN];
+
+    printf("==== matrix triplets\n");
+    set_link(soc, 0, 1, 42, WMATRIX_F_SYMMETRIC);
+    bulk_addr(0, from);
+    bulk_addr(1, to);
+    link_query_response link = query_link(soc, from, to);
+    check(link.update_result == WUPDATE_SUCCESS && link.snr == 42, "link 0 -> 1 reads %d", link.snr);
+    link = query_link(soc, to, from);
+    check(link.update_result == WUPDATE_SUCCESS && link.snr == 42, "symmetric link 1 -> 0 reads %d", link.snr);
+}
+
+/* Both stations change in one request */
+static void test_station_update(int soc) {
+    station_update_request request = {.count = 2};
+    station_update_entry entries[2];
+    station_update_response response;
+    station_update_result results[2];
+
+    printf("==== station update\n");
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < 2; i++) {
+        bulk_addr(i, entries[i].addr);
+        entries[i].props = WPROP_POSITION | WPROP_GAIN;
+        entries[i].posX = 100 + i;
+        entries[i].posY = 200;
+        entries[i].posZ = 2;
+        entries[i].gain_ = 3;
+    }
+    send_request(soc, &request, station_update_request);
+    send_entries(soc, entries, 2, station_update_entry);
+    receive_response(soc, &response, station_update_response, WSERVER_STATION_UPDATE_RESPONSE_TYPE);
+    check(response.count == 2, "station update returned %u results", response.count);
+    receive_entries(soc, results, 2, station_update_result);
+    for (int i = 0; i < 2; i++) {
+        station_info_entry info;
+        check(results[i].update_result == WUPDATE_SUCCESS, "update of station %d failed", i);
+        check(query_station(soc, entries[i].addr, &info, NULL) == WUPDATE_SUCCESS, "updated station not found");
+        check(info.posX == 100 + i && info.posY == 200 && info.gain_ == 3, "station %d has wrong properties", i);
+    }
+}
+
+/* A second connection follows the changes made on the first one */
+static void test_subscription(int soc) {
+    subscribe_request request = {.enable = 1, .threshold = 5};
+    subscribe_response response;
+    u8 from[ETH_ALEN], to[ETH_ALEN];
+    int sub = connect_server();
+
+    printf("==== subscription\n");
+    send_request(sub, &request, subscribe_request);
+    receive_response(sub, &response, subscribe_response, WSERVER_SUBSCRIBE_RESPONSE_TYPE);
+    check(response.update_result == WUPDATE_SUCCESS, "subscribe failed: %d", response.update_result);
+
+    bulk_addr(2, from);
+    bulk_addr(3, to);
+    set_link(soc, 2, 3, matrix_snr(2, 3) + 20, 0);
+    link_delta_entry delta = wait_for_delta(sub, from, to);
+    check(delta.old_snr == matrix_snr(2, 3) && delta.new_snr == matrix_snr(2, 3) + 20,
+          "delta of 2 -> 3 is %d -> %d", delta.old_snr, delta.new_snr);
+
+    // the links of a removed station are reported as gone
+    station_bulk_del_request del = {.count = 1};
+    station_bulk_del_entry entry;
+    station_bulk_del_response deleted;
+    station_bulk_del_result result;
+    memcpy(entry.addr, to, ETH_ALEN);
+    send_request(soc, &del, station_bulk_del_request);
+    send_entries(soc, &entry, 1, station_bulk_del_entry);
+    receive_response(soc, &deleted, station_bulk_del_response, WSERVER_BULK_DEL_RESPONSE_TYPE);
+    receive_entries(soc, &result, 1, station_bulk_del_result);
+    check(result.update_result == WUPDATE_SUCCESS, "delete of station 3 failed");
+    delta = wait_for_delta(sub, from, to);
+    check(delta.old_snr == matrix_snr(2, 3) + 20 && delta.new_snr == WSERVER_SNR_NONE,
+          "delta of removed link 2 -> 3 is %d -> %d", delta.old_snr, delta.new_snr);
+    close(sub);
+}
+
+/* Quiet SNR updates written back-to-back, the last one of a link wins */
+static void test_snr_stream(int soc) {
+    u8 buf[2 * NUM_BULK * NUM_BULK * sizeof(snr_update_request)];
+    size_t len = 0;
+
+    printf("==== snr stream\n");
+    // station 3 was removed by the subscription test
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < NUM_BULK; i++) {
+            for (int j = i + 1; j < NUM_BULK; j++) {
+                snr_update_request request;
+                if (i == 3 || j == 3)
+                    continue;
+                bulk_addr(i, request.from_addr);
+                bulk_addr(j, request.to_addr);
+                request.snr = matrix_snr(i, j) + 30 + round;
+                len += wserver_pack_quiet_msg(buf + len, &request, snr_update_request);
+            }
+        }
+    }
+    check(write(soc, buf, len) == (ssize_t) len, "error while sending the snr stream");
+
+    // quiet requests only answer on failure, so this must be the next response
+    for (int i = 0; i < NUM_BULK; i++) {
+        for (int j = i + 1; j < NUM_BULK; j++) {
+            u8 from[ETH_ALEN], to[ETH_ALEN];
+            if (i == 3 || j == 3)
+                continue;
+            bulk_addr(i, from);
+            bulk_addr(j, to);
+            link_query_response link = query_link(soc, from, to);
+            check(link.update_result == WUPDATE_SUCCESS && link.snr == matrix_snr(i, j) + 31,
+                  "link %d -> %d reads %d", i, j, link.snr);
+            link = query_link(soc, to, from);
+            check(link.update_result == WUPDATE_SUCCESS && link.snr == matrix_snr(i, j) + 31,
+                  "link %d -> %d reads %d", j, i, link.snr);
+        }
+    }
+}
+
+static void test_bulk_del(int soc) {
+    station_bulk_del_request request = {.count = NUM_BULK};
+    station_bulk_del_entry entries[NUM_BULK];
+    station_bulk_del_response response;
+    station_bulk_del_result results[NUM_BULK];
+
+    printf("==== bulk delete\n");
+    for (int i = 0; i < NUM_BULK; i++)
+        bulk_addr(i, entries[i].addr);
+    send_request(soc, &request, station_bulk_del_request);
+    send_entries(soc, entries, NUM_BULK, station_bulk_del_entry);
+    receive_response(soc, &response, station_bulk_del_response, WSERVER_BULK_DEL_RESPONSE_TYPE);
+    check(response.count == NUM_BULK, "bulk delete returned %u results", response.count);
+    receive_entries(soc, results, NUM_BULK, station_bulk_del_result);
+    for (int i = 0; i < NUM_BULK; i++) {
+        // station 3 is already gone
+        u8 expected = i == 3 ? WUPDATE_INTF_NOTFOUND : WUPDATE_SUCCESS;
+        check(results[i].update_result == expected, "bulk delete of station %d returned %d", i,
+              results[i].update_result);
+    }
+}
+
+static void send_position(int soc, const u8 *addr, f32 x) {
+    position_update_request request;
+    u8 buf[sizeof(request)];
+
+    memcpy(request.sta_addr, addr, ETH_ALEN);
+    request.posX = x;
+    request.posY = 0;
+    request.posZ = 0;
+    size_t len = wserver_pack_quiet_msg(buf, &request, position_update_request);
+    check(write(soc, buf, len) == (ssize_t) len, "error while sending a position update");
+}
+
+/* Needs a server started with -u window_ms */
+static void test_update_window(int soc, int window_ms) {
+    station_info_entry info;
+    u32 version, after;
+
+    printf("==== update window\n");
+    check(add_station(soc, addr_c).update_result == WUPDATE_SUCCESS, "adding station c failed");
+    check(query_station(soc, addr_c, &info, &version) == WUPDATE_SUCCESS, "station c not found");
+
+    // separate batches within the window are applied together, last value wins
+    for (int i = 1; i <= 3; i++) {
+        send_position(soc, addr_c, 10.0f * i);
+        usleep(window_ms * 100);
+    }
+    usleep(window_ms * 2000);
+    check(query_station(soc, addr_c, &info, &after) == WUPDATE_SUCCESS, "station c not found");
+    check(info.posX == 30.0f, "station c is at x = %f", info.posX);
+    check(after == version + 1, "published %u times for one window", after - version);
+
+    // a station deleted within the window drops its pending update
+    station_add_response added = add_station(soc, addr_b);
+    check(added.update_result == WUPDATE_SUCCESS, "adding station b failed");
+    send_position(soc, addr_b, 77.0f);
+    check(del_station_by_id(soc, added.created_id) == WUPDATE_SUCCESS, "deleting station b failed");
+    added = add_station(soc, addr_b);
+    check(added.update_result == WUPDATE_SUCCESS, "re-adding station b failed");
+    usleep(window_ms * 2000);
+    check(query_station(soc, addr_b, &info, NULL) == WUPDATE_SUCCESS, "station b not found");
+    check(info.posX != 77.0f, "re-added station b took the update of the deleted one");
+}
+
+int main(int argc, char *argv[]) {
+    int soc = connect_server();
+    printf("Connected to server\n");
+
+    if (argc > 1) {
+        test_update_window(soc, atoi(argv[1]));
+        close(soc);
+        printf("all checks passed\n");
+        return EXIT_SUCCESS;
+    }
+
+    test_station_ids(soc);
+    test_bulk_add(soc);
+    test_matrix_rows(soc);
+    test_matrix_triplets(soc);
+    test_station_update(soc);
+    test_subscription(soc);
+    test_snr_stream(soc);
+    test_bulk_del(soc);
+
+    close(soc);
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#!/bin/bash
+# Checks the wserver station, matrix and subscription messages:
+# starts wmediumd in dynamic mode and runs client_dynamic against it,
+# then once more with an update window (-u).
+
+socket=/var/run/wmediumd.sock
+window=200
+log=/tmp/wmediumd-dynamic.log
+
+if [[ $UID -ne 0 ]]; then
+	echo "Sorry, run me as root."
+	exit 1
+fi
+
+make client_dynamic || exit 1
+
+modprobe -r mac80211_hwsim
+modprobe mac80211_hwsim radios=0
+
+# start_wmediumd ARGS...: start wmediumd and wait for the server to listen
+start_wmediumd() {
+	rm -f $socket
+	../wmediumd/wmediumd -d -s "$@" > $log 2>&1 &
+	wmediumd_pid=$!
+	for i in `seq 50`; do
+		[[ -S $socket ]] && break
+		sleep 0.2
+	done
+}
+
+stop_wmediumd() {
+	kill -INT $wmediumd_pid
+	wait $wmediumd_pid 2>/dev/null
+}
+
+start_wmediumd -l 5
+./client_dynamic
+ret=$?
+stop_wmediumd
+
+if [[ $ret -eq 0 ]]; then
+	start_wmediumd -l 6 -u $window
+	./client_dynamic $window
+	ret=$?
+	stop_wmediumd
+	if [[ $ret -eq 0 ]] && ! grep -q "is gone, dropped its update" $log; then
+		echo "the update of a deleted station was not dropped"
+		ret=1
+	fi
+fi
+
+modprobe -r mac80211_hwsim
+
+if [[ $ret -eq 0 ]]; then
+	echo "PASS"
+else
+	echo "FAIL"
+fi
+exit $ret
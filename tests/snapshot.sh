@@ -0,0 +1,55 @@
+#!/bin/bash
+# Writes a binary snapshot of a generated topology, loads it again and
+# checks that a snapshot written from the loaded one holds the same
+# stations, model parameters and link matrices.
+
+snap1=snapshot1.wmsnap
+snap2=snapshot2.wmsnap
+
+cat <<__EOM > snapshot.cfg
+ifaces :
+{
+	generators = (
+		{ type = "grid"; count = 16; columns = 4; spacing = 20.0;
+		  tx_power = 15; },
+		{ type = "random"; count = 16; seed = 7; area = (100.0, 100.0);
+		  origin = (0.0, 0.0, 1.5); mac = "02:00:00:01:%02x:%02x"; }
+	);
+};
+
+model :
+{
+	type = "path_loss";
+	model_name = "log_distance";
+	path_loss_exp = 3.5;
+	xg = 0.0;
+	seed = 1234;
+};
+__EOM
+
+rm -f $snap1 $snap2
+../wmediumd/wmediumd -c snapshot.cfg -o $snap1 || exit 1
+../wmediumd/wmediumd -c $snap1 -o $snap2 || exit 1
+
+# The config path and hash differ, the second snapshot was made from the
+# first one.  Everything from num_stas on has to match.
+header_skip=280
+stations_off=`od -An -tu8 -j 408 -N 8 $snap1 | tr -d ' '`
+
+ret=0
+if ! cmp -i $header_skip -n $((408 - header_skip)) $snap1 $snap2; then
+	echo "Model parameters differ"
+	ret=1
+fi
+if ! cmp -i $stations_off $snap1 $snap2; then
+	echo "Stations or link matrices differ"
+	ret=1
+fi
+
+rm -f snapshot.cfg $snap1 $snap2
+if [[ $ret -eq 0 ]]; then
+	echo "PASS"
+else
+	echo "FAIL"
+fi
+exit $ret
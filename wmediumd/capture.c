@@ -0,0 +1,344 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	pcapng capture of the frames handed to the medium
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <endian.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "capture.h"
+
+#define PCAPNG_SHB		0x0a0d0d0a
+#define PCAPNG_IDB		0x00000001
+#define PCAPNG_EPB		0x00000006
+#define PCAPNG_ISB		0x00000005
+#define PCAPNG_BYTE_ORDER	0x1a2b3c4d
+#define LINKTYPE_IEEE802_11_RADIOTAP	127
+
+#define IF_TSRESOL		9
+#define ISB_IFDROP		5
+
+#define IEEE80211_RADIOTAP_FLAGS	1
+#define IEEE80211_RADIOTAP_RATE		2
+#define IEEE80211_RADIOTAP_CHANNEL	3
+#define IEEE80211_RADIOTAP_DBM_ANTSIGNAL	5
+#define IEEE80211_RADIOTAP_TX_FLAGS	15
+#define IEEE80211_RADIOTAP_DATA_RETRIES	17
+
+#define IEEE80211_CHAN_OFDM		0x0040
+#define IEEE80211_CHAN_2GHZ		0x0080
+#define IEEE80211_CHAN_5GHZ		0x0100
+#define IEEE80211_RADIOTAP_F_TX_FAIL	0x0001
+
+/* Fields in the order of their present bits, with their alignment */
+struct capture_radiotap {
+	u8 version;
+	u8 pad;
+	u16 len;
+	u32 present;
+	u8 flags;
+	u8 rate;			/* [500 kbps] */
+	u16 chan_freq;			/* [MHz] */
+	u16 chan_flags;
+	int8_t signal;			/* [dBm] */
+	u8 pad2;
+	u16 tx_flags;
+	u8 data_retries;
+} __attribute__((packed));
+
+struct capture_epb {
+	u32 type;
+	u32 len;
+	u32 interface;
+	u32 ts_high;
+	u32 ts_low;
+	u32 caplen;
+	u32 origlen;
+} __attribute__((packed));
+
+struct capture {
+	int fd;
+	pthread_t writer;
+	bool stopping;
+	u64 head;			/* written by the frame path */
+	u64 tail;			/* written by the writer */
+	u64 frames;
+	u64 dropped;
+	int write_error;		/* stops the writer, keeping the file valid */
+	u8 *buffer;
+};
+
+static u32 pad4(u32 len)
+{
+	return (len + 3) & ~3u;
+}
+
+/* Append len bytes at the producer position pos, wrapping around */
+static void buffer_put(struct capture *capture, u64 pos, const void *data,
+		       size_t len)
+{
+	size_t off = pos & (CAPTURE_BUFFER_SIZE - 1);
+	size_t first = CAPTURE_BUFFER_SIZE - off;
+
+	if (first > len)
+		first = len;
+	memcpy(capture->buffer + off, data, first);
+	memcpy(capture->buffer, (const u8 *)data + first, len - first);
+}
+
+void capture_frame(struct capture *capture, const struct frame *frame)
+{
+	static const u8 zeros[4];
+	struct capture_radiotap rt = {
+		.len = htole16(sizeof(rt)),
+		.present = htole32(1 << IEEE80211_RADIOTAP_FLAGS |
+				   1 << IEEE80211_RADIOTAP_RATE |
+				   1 << IEEE80211_RADIOTAP_CHANNEL |
+				   1 << IEEE80211_RADIOTAP_DBM_ANTSIGNAL |
+				   1 << IEEE80211_RADIOTAP_TX_FLAGS |
+				   1 << IEEE80211_RADIOTAP_DATA_RETRIES),
+	};
+	struct capture_epb epb;
+	struct timespec now;
+	u32 caplen = sizeof(rt) + frame->data_len, len, trailer;
+	u64 head = capture->head, ts;
+	int i, attempts = 0, rate = 0;
+
+	len = sizeof(epb) + pad4(caplen) + sizeof(trailer);
+	if (head + len - __atomic_load_n(&capture->tail, __ATOMIC_ACQUIRE) >
+	    CAPTURE_BUFFER_SIZE) {
+		__atomic_store_n(&capture->dropped, capture->dropped + 1,
+				 __ATOMIC_RELAXED);
+		return;
+	}
+
+	/* the rate of the last attempt made */
+	for (i = 0; i < frame->tx_rates_count && frame->tx_rates[i].idx >= 0;
+	     i++) {
+		attempts += frame->tx_rates[i].count;
+		rate = index_to_rate(frame->tx_rates[i].idx, frame->freq);
+	}
+	rt.rate = rate / 5;
+	rt.chan_freq = htole16(frame->freq);
+	rt.chan_flags = htole16(IEEE80211_CHAN_OFDM | (frame->freq > 5000 ?
+			IEEE80211_CHAN_5GHZ : IEEE80211_CHAN_2GHZ));
+	rt.signal = frame->signal;
+	if (!(frame->flags & HWSIM_TX_STAT_ACK))
+		rt.tx_flags = htole16(IEEE80211_RADIOTAP_F_TX_FAIL);
+	rt.data_retries = attempts > 1 ? attempts - 1 : 0;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	ts = (u64)now.tv_sec * 1000000000ull + now.tv_nsec;
+	epb.type = PCAPNG_EPB;
+	epb.len = len;
+	epb.interface = 0;
+	epb.ts_high = ts >> 32;
+	epb.ts_low = ts;
+	epb.caplen = caplen;
+	epb.origlen = caplen;
+	trailer = len;
+
+	buffer_put(capture, head, &epb, sizeof(epb));
+	head += sizeof(epb);
+	buffer_put(capture, head, &rt, sizeof(rt));
+	head += sizeof(rt);
+	buffer_put(capture, head, frame->data, frame->data_len);
+	head += frame->data_len;
+	buffer_put(capture, head, zeros, pad4(caplen) - caplen);
+	head += pad4(caplen) - caplen;
+	buffer_put(capture, head, &trailer, sizeof(trailer));
+	head += sizeof(trailer);
+
+	__atomic_store_n(&capture->frames, capture->frames + 1,
+			 __ATOMIC_RELAXED);
+	__atomic_store_n(&capture->head, head, __ATOMIC_RELEASE);
+}
+
+static int write_all(int fd, const void *data, size_t len)
+{
+	ssize_t ret;
+
+	while (len) {
+		ret = write(fd, data, len);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret < 0)
+			return -errno;
+		data = (const u8 *)data + ret;
+		len -= ret;
+	}
+	return 0;
+}
+
+/* Write out everything buffered so far, in as few writes as possible */
+static bool flush_buffer(struct capture *capture)
+{
+	u64 head = __atomic_load_n(&capture->head, __ATOMIC_ACQUIRE);
+	u64 tail = capture->tail;
+	size_t off, len;
+
+	if (head == tail)
+		return false;
+	while (tail != head) {
+		off = tail & (CAPTURE_BUFFER_SIZE - 1);
+		len = head - tail;
+		if (len > CAPTURE_BUFFER_SIZE - off)
+			len = CAPTURE_BUFFER_SIZE - off;
+		if (!capture->write_error)
+			capture->write_error = write_all(capture->fd,
+							 capture->buffer + off,
+							 len);
+		tail += len;
+	}
+	__atomic_store_n(&capture->tail, tail, __ATOMIC_RELEASE);
+	return true;
+}
+
+static void *writer_thread(void *arg)
+{
+	struct capture *capture = arg;
+	struct timespec poll = { 0, CAPTURE_POLL_MS * 1000000L };
+
+	while (!__atomic_load_n(&capture->stopping, __ATOMIC_ACQUIRE)) {
+		if (!flush_buffer(capture))
+			nanosleep(&poll, NULL);
+	}
+	flush_buffer(capture);
+	return NULL;
+}
+
+static int write_header(int fd)
+{
+	struct {
+		u32 type, len, byte_order;
+		u16 major, minor;
+		int64_t section_len;
+		u32 trailer;
+	} __attribute__((packed)) shb = {
+		PCAPNG_SHB, sizeof(shb), PCAPNG_BYTE_ORDER, 1, 0, -1,
+		sizeof(shb),
+	};
+	struct {
+		u32 type, len;
+		u16 linktype, reserved;
+		u32 snaplen;
+		u16 tsresol_code, tsresol_len;
+		u8 tsresol, tsresol_pad[3];
+		u32 end_of_opt;
+		u32 trailer;
+	} __attribute__((packed)) idb = {
+		PCAPNG_IDB, sizeof(idb), LINKTYPE_IEEE802_11_RADIOTAP, 0, 0,
+		IF_TSRESOL, 1, 9, { 0 }, 0, sizeof(idb),
+	};
+	int ret;
+
+	ret = write_all(fd, &shb, sizeof(shb));
+	return ret ? ret : write_all(fd, &idb, sizeof(idb));
+}
+
+static int write_statistics(struct capture *capture)
+{
+	struct timespec now;
+	u64 ts;
+	struct {
+		u32 type, len, interface, ts_high, ts_low;
+		u16 ifdrop_code, ifdrop_len;
+		u64 ifdrop;
+		u32 end_of_opt;
+		u32 trailer;
+	} __attribute__((packed)) isb = {
+		PCAPNG_ISB, sizeof(isb), 0, 0, 0, ISB_IFDROP, 8,
+		capture->dropped, 0, sizeof(isb),
+	};
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	ts = (u64)now.tv_sec * 1000000000ull + now.tv_nsec;
+	isb.ts_high = ts >> 32;
+	isb.ts_low = ts;
+	return write_all(capture->fd, &isb, sizeof(isb));
+}
+
+int capture_open(struct wmediumd *ctx, const char *path)
+{
+	struct capture *capture;
+	int ret;
+
+	capture = calloc(1, sizeof(*capture));
+	if (!capture)
+		return -ENOMEM;
+	capture->buffer = malloc(CAPTURE_BUFFER_SIZE);
+	if (!capture->buffer) {
+		ret = -ENOMEM;
+		goto err_free;
+	}
+	capture->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+			   0644);
+	if (capture->fd < 0) {
+		ret = -errno;
+		goto err_free;
+	}
+	ret = write_header(capture->fd);
+	if (ret)
+		goto err_close;
+	ret = -pthread_create(&capture->writer, NULL, writer_thread, capture);
+	if (ret)
+		goto err_close;
+
+	ctx->capture = capture;
+	return 0;
+
+err_close:
+	close(capture->fd);
+	unlink(path);
+err_free:
+	free(capture->buffer);
+	free(capture);
+	return ret;
+}
+
+void capture_close(struct wmediumd *ctx)
+{
+	struct capture *capture = ctx->capture;
+
+	if (!capture)
+		return;
+	ctx->capture = NULL;
+
+	__atomic_store_n(&capture->stopping, true, __ATOMIC_RELEASE);
+	pthread_join(capture->writer, NULL);
+	if (!capture->write_error)
+		capture->write_error = write_statistics(capture);
+	if (capture->write_error)
+		w_logf(ctx, LOG_ERR, "Capture incomplete, writing failed: %s\n",
+		       strerror(-capture->write_error));
+	if (capture->dropped)
+		w_logf(ctx, LOG_WARNING, "Capture dropped %llu of %llu frames\n",
+		       (unsigned long long)capture->dropped,
+		       (unsigned long long)(capture->frames + capture->dropped));
+
+	close(capture->fd);
+	free(capture->buffer);
+	free(capture);
+}
@@ -0,0 +1,48 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	pcapng capture of the frames handed to the medium
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include "wmediumd.h"
+
+/* Bytes of frames that can wait for the writer, a power of two */
+#define CAPTURE_BUFFER_SIZE	(16 << 20)
+/* How often the writer looks for new frames [ms] */
+#define CAPTURE_POLL_MS		10
+
+/*
+ * Start capturing to a pcapng file at path.  Every frame gets a radiotap
+ * header with its signal, final rate, frequency, retries and whether it
+ * was acknowledged.  The frame path only copies the frame into a buffer,
+ * a background thread writes the buffer out; frames that do not fit are
+ * dropped and counted in the interface statistics of the file.
+ * @return 0 on success, otherwise a negative errno value
+ */
+int capture_open(struct wmediumd *ctx, const char *path);
+
+/* Write out what is buffered and close the capture, if any */
+void capture_close(struct wmediumd *ctx);
+
+/* Capture a frame whose tx status is known, from the frame path only */
+void capture_frame(struct capture *capture, const struct frame *frame);
+
+#endif /* CAPTURE_H_ */
@@ -27,15 +27,27 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <math.h>
+#include <sys/mman.h>
 
 #include "wmediumd.h"
+#include "rng.h"
+#include "wmsnap.h"
+#include "wmediumd_dynamic.h"
+#include "link_state.h"
+#include "probes.h"
 
-static void string_to_mac_address(const char *str, u8 *addr)
+static int string_to_mac_address(const char *str, u8 *addr)
 {
-	int a[ETH_ALEN];
-
-	sscanf(str, "%x:%x:%x:%x:%x:%x",
-	       &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]);
+	int a[ETH_ALEN] = { 0 };
+	int i, ret = 0;
+
+	if (sscanf(str, "%x:%x:%x:%x:%x:%x",
+		   &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) != ETH_ALEN)
+		ret = -EINVAL;
+	for (i = 0; i < ETH_ALEN; i++) {
+		if (a[i] < 0 || a[i] > 0xff)
+			ret = -EINVAL;
+	}
 
 	addr[0] = (u8) a[0];
 	addr[1] = (u8) a[1];
@@ -43,6 +55,7 @@ static void string_to_mac_address(const char *str, u8 *addr)
 	addr[3] = (u8) a[3];
 	addr[4] = (u8) a[4];
 	addr[5] = (u8) a[5];
+	return ret;
 }
 
 static int get_link_snr_default(struct wmediumd *ctx, struct station *sender,
@@ -55,7 +68,7 @@ static int get_link_snr_from_snr_matrix(struct wmediumd *ctx,
 					struct station *sender,
 					struct station *receiver)
 {
-	return ctx->snr_matrix[sender->index * ctx->num_stas + receiver->index];
+	return ctx->snr_matrix[sender->index * ctx->sta_capacity + receiver->index];
 }
 
 static double _get_error_prob_from_snr(struct wmediumd *ctx, double snr,
@@ -74,7 +87,7 @@ static double get_error_prob_from_matrix(struct wmediumd *ctx, double snr,
 	if (dst == NULL) // dst is multicast. returned value will not be used.
 		return 0.0;
 
-	return ctx->error_prob_matrix[ctx->num_stas * src->index + dst->index];
+	return ctx->error_prob_matrix[ctx->sta_capacity * src->index + dst->index];
 }
 
 int use_fixed_random_value(struct wmediumd *ctx)
@@ -274,38 +287,147 @@ static int calc_path_loss_two_ray_ground(void *model_param,
         }
 }
 
+struct path_loss_model {
+	const char *name;
+	int (*calc_path_loss)(void *, struct station *, struct station *);
+	size_t param_size;
+};
+
+static const struct path_loss_model path_loss_models[] = {
+	{ "log_distance", calc_path_loss_log_distance,
+	  sizeof(struct log_distance_model_param) },
+	{ "free_space", calc_path_loss_free_space,
+	  sizeof(struct free_space_model_param) },
+	{ "log_normal_shadowing", calc_path_loss_log_normal_shadowing,
+	  sizeof(struct log_normal_shadowing_model_param) },
+	{ "two_ray_ground", calc_path_loss_two_ray_ground,
+	  sizeof(struct two_ray_ground_model_param) },
+	{ "itu", calc_path_loss_itu, sizeof(struct itu_model_param) },
+};
+
+const char *get_path_loss_model_name(struct wmediumd *ctx,
+				     size_t *param_size)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(path_loss_models) /
+		    sizeof(path_loss_models[0]); i++) {
+		if (path_loss_models[i].calc_path_loss == ctx->calc_path_loss) {
+			*param_size = path_loss_models[i].param_size;
+			return path_loss_models[i].name;
+		}
+	}
+	return NULL;
+}
+
+int set_path_loss_model(struct wmediumd *ctx, const char *name,
+			const void *param, size_t param_size)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(path_loss_models) /
+		    sizeof(path_loss_models[0]); i++) {
+		if (strcmp(path_loss_models[i].name, name) != 0)
+			continue;
+		if (param_size != path_loss_models[i].param_size)
+			return -EINVAL;
+		ctx->path_loss_param = malloc(param_size);
+		if (!ctx->path_loss_param)
+			return -ENOMEM;
+		memcpy(ctx->path_loss_param, param, param_size);
+		ctx->calc_path_loss = path_loss_models[i].calc_path_loss;
+		return 0;
+	}
+	return -ENOENT;
+}
+
 /* Existing link is from from -> to; copy to other dir */
 static void mirror_link(struct wmediumd *ctx, int from, int to)
 {
-	ctx->snr_matrix[ctx->num_stas * to + from] =
-		ctx->snr_matrix[ctx->num_stas * from + to];
+	ctx->snr_matrix[ctx->sta_capacity * to + from] =
+		ctx->snr_matrix[ctx->sta_capacity * from + to];
 
 	if (ctx->error_prob_matrix) {
-		ctx->error_prob_matrix[ctx->num_stas * to + from] =
-			ctx->error_prob_matrix[ctx->num_stas * from + to];
+		ctx->error_prob_matrix[ctx->sta_capacity * to + from] =
+			ctx->error_prob_matrix[ctx->sta_capacity * from + to];
     }
 }
 
-static void recalc_path_loss(struct wmediumd *ctx)
+/* Signal of the link start -> end under the path loss model */
+static int calc_link_signal(struct wmediumd *ctx, int start, int end)
+{
+	int path_loss, gains, txpower;
+
+	txpower = ctx->sta_array[start]->tx_power;
+	if (ctx->sta_array[end]->isap == 1)
+		txpower = ctx->sta_array[end]->tx_power;
+
+	path_loss = ctx->calc_path_loss(ctx->path_loss_param,
+		ctx->sta_array[end], ctx->sta_array[start]);
+	gains = txpower + ctx->sta_array[start]->gain + ctx->sta_array[end]->gain;
+	return gains - path_loss - ctx->noise_threshold;
+}
+
+void recalc_path_loss(struct wmediumd *ctx)
 {
-	int start, end, path_loss, gains, txpower, signal;
+	int start, end, signal;
 
+	WMEDIUMD_PROBE2(recompute_start, ctx->num_stas, ctx->num_stas);
 	for (start = 0; start < ctx->num_stas; start++) {
 		for (end = 0; end < ctx->num_stas; end++) {
-			if (start == end)
+			if (start == end || !ctx->sta_array[start] ||
+			    !ctx->sta_array[end])
 				continue;
-			txpower = ctx->sta_array[start]->tx_power;
-			if (ctx->sta_array[end]->isap == 1)
-				txpower = ctx->sta_array[end]->tx_power;
+			signal = calc_link_signal(ctx, start, end);
+			ctx->snr_matrix[ctx->sta_capacity * start + end] = signal;
+			ctx->snr_matrix[ctx->sta_capacity * end + start] = signal;
+		}
+	}
+	WMEDIUMD_PROBE2(recompute_end, ctx->num_stas, ctx->num_stas);
+}
 
-			path_loss = ctx->calc_path_loss(ctx->path_loss_param,
-				ctx->sta_array[end], ctx->sta_array[start]);
-			gains = txpower + ctx->sta_array[start]->gain + ctx->sta_array[end]->gain;
-			signal = gains - path_loss - ctx->noise_threshold;
-            ctx->snr_matrix[ctx->num_stas * start + end] = signal;
-            ctx->snr_matrix[ctx->num_stas * end + start] = signal;
+/*
+ * Recompute only the links touching the stations at indices, each link
+ * once.  The result matches recalc_path_loss(), which lets the pass with
+ * the higher index as start win for both directions.
+ */
+void recalc_station_links(struct wmediumd *ctx, const int *indices, int count)
+{
+	enum { UNCHANGED, CHANGED, DONE } *state;
+	int i, other, signal;
+
+	state = calloc(ctx->num_stas, sizeof(*state));
+	if (!state) {
+		recalc_path_loss(ctx);
+		return;
 	}
-    }
+
+	WMEDIUMD_PROBE2(recompute_start, ctx->num_stas, count);
+	for (i = 0; i < count; i++)
+		state[indices[i]] = CHANGED;
+
+	for (i = 0; i < count; i++) {
+		int index = indices[i];
+
+		if (state[index] == DONE || !ctx->sta_array[index])
+			continue;
+		for (other = 0; other < ctx->num_stas; other++) {
+			/* links to a station done already were computed then */
+			if (other == index || !ctx->sta_array[other] ||
+			    state[other] == DONE)
+				continue;
+			if (other < index)
+				signal = calc_link_signal(ctx, index, other);
+			else
+				signal = calc_link_signal(ctx, other, index);
+			ctx->snr_matrix[ctx->sta_capacity * index + other] = signal;
+			ctx->snr_matrix[ctx->sta_capacity * other + index] = signal;
+		}
+		state[index] = DONE;
+	}
+	WMEDIUMD_PROBE2(recompute_end, ctx->num_stas, count);
+
+	free(state);
 }
 
 static void move_stations_to_direction(struct wmediumd *ctx)
@@ -331,7 +453,7 @@ static void move_stations_donothing(struct wmediumd *ctx)
 {
 }
 
-static int parse_path_loss(struct wmediumd *ctx, config_t *cf)
+static int parse_path_loss(struct wmediumd *ctx, config_t *cf, bool generated)
 {
 	struct station *station;
 	const config_setting_t *positions, *position;
@@ -340,13 +462,14 @@ static int parse_path_loss(struct wmediumd *ctx, config_t *cf)
 	const config_setting_t *isnodeaps;
 	const char *path_loss_model_name;
 
+	/* generated stations already carry a position and tx power */
 	positions = config_lookup(cf, "model.positions");
-	if (!positions) {
+	if (!positions && !generated) {
 		w_flogf(ctx, LOG_ERR, stderr,
 			"No positions found in model\n");
 		return -EINVAL;
 	}
-	if (config_setting_length(positions) != ctx->num_stas) {
+	if (positions && config_setting_length(positions) != ctx->num_stas) {
 		w_flogf(ctx, LOG_ERR, stderr,
 			"Specify %d positions\n", ctx->num_stas);
 		return -EINVAL;
@@ -363,12 +486,12 @@ static int parse_path_loss(struct wmediumd *ctx, config_t *cf)
 	}
 
 	tx_powers = config_lookup(cf, "model.tx_powers");
-	if (!tx_powers) {
+	if (!tx_powers && !generated) {
 		w_flogf(ctx, LOG_ERR, stderr,
 			"No tx_powers found in model\n");
 		return -EINVAL;
 	}
-	if (config_setting_length(tx_powers) != ctx->num_stas) {
+	if (tx_powers && config_setting_length(tx_powers) != ctx->num_stas) {
 		w_flogf(ctx, LOG_ERR, stderr,
 			"Specify %d tx_powers\n", ctx->num_stas);
 		return -EINVAL;
@@ -508,15 +631,18 @@ static int parse_path_loss(struct wmediumd *ctx, config_t *cf)
 	}
 
 	list_for_each_entry(station, &ctx->stations, list) {
-		position = config_setting_get_elem(positions, station->index);
-		if (config_setting_length(position) != 3) {
-			w_flogf(ctx, LOG_ERR, stderr,
-				"Invalid position: expected (double,double,double)\n");
-			return -EINVAL;
+		if (positions) {
+			position = config_setting_get_elem(positions,
+							   station->index);
+			if (config_setting_length(position) != 3) {
+				w_flogf(ctx, LOG_ERR, stderr,
+					"Invalid position: expected (double,double,double)\n");
+				return -EINVAL;
+			}
+			station->x = config_setting_get_float_elem(position, 0);
+			station->y = config_setting_get_float_elem(position, 1);
+			station->z = config_setting_get_float_elem(position, 2);
 		}
-		station->x = config_setting_get_float_elem(position, 0);
-		station->y = config_setting_get_float_elem(position, 1);
-		station->z = config_setting_get_float_elem(position, 2);
 
 		if (directions) {
 			direction = config_setting_get_elem(directions,
@@ -532,8 +658,9 @@ static int parse_path_loss(struct wmediumd *ctx, config_t *cf)
 				direction, 1);
 		}
 
-		station->tx_power = config_setting_get_float_elem(
-			tx_powers, station->index);
+		if (tx_powers)
+			station->tx_power = config_setting_get_float_elem(
+				tx_powers, station->index);
 		if (isnodeaps) {
 			station->isap = config_setting_get_int_elem(
 				isnodeaps, station->index);
@@ -545,51 +672,309 @@ static int parse_path_loss(struct wmediumd *ctx, config_t *cf)
 	return 0;
 }
 
-static double pseudo_normal_distribution(void)
+/*
+ * The fading of a frame is a pure function of the seed, the link and the
+ * frame cookie, so it does not depend on the order frames are handled in.
+ */
+static int _get_fading_signal(struct wmediumd *ctx, struct station *src,
+			      struct station *dst, u64 cookie)
 {
-	int i;
-	double normal = -6.0;
+	return ctx->fading_coefficient *
+		link_random_normal(ctx, src, dst, cookie, RNG_STREAM_FADING);
+}
 
-	for (i = 0; i < 12; i++)
-		normal += drand48();
+static int get_no_fading_signal(struct wmediumd *ctx, struct station *src,
+				struct station *dst, u64 cookie)
+{
+	return 0;
+}
 
-	return normal;
+static struct station *new_station(struct wmediumd *ctx, int index,
+				   const u8 *addr)
+{
+	struct station *station;
+
+	station = malloc(sizeof(*station));
+	if (!station) {
+		w_flogf(ctx, LOG_ERR, stderr, "Out of memory!\n");
+		return NULL;
+	}
+	memset(station, 0, sizeof(*station));
+	station->index = index;
+	memcpy(station->addr, addr, ETH_ALEN);
+	memcpy(station->hwaddr, addr, ETH_ALEN);
+	station->tx_power = SNR_DEFAULT;
+	station->gain = GAIN_DEFAULT;
+	//station->height = HEIGHT_DEFAULT;
+	station->gRandom = GAUSS_RANDOM_DEFAULT;
+	station->isap = AP_DEFAULT;
+	station->medium_id = MEDIUM_ID_DEFAULT;
+	station_init_queues(station);
+	list_add_tail(&station->list, &ctx->stations);
+	ctx->sta_array[index] = station;
+
+	return station;
 }
 
-static int _get_fading_signal(struct wmediumd *ctx)
+/*
+ * Expand a MAC pattern such as "02:00:00:%02x:%02x:00" for a station.
+ * A pattern with one conversion receives the low byte of the index, one
+ * with two conversions receives the high and the low byte.  The pattern
+ * comes from the config file, so only integer conversions with an
+ * optional width (%x, %X, %d, %u) are accepted.
+ */
+static int generate_mac_address(const char *pattern, int index, u8 *addr)
 {
-	return ctx->fading_coefficient * pseudo_normal_distribution();
+	char str[64];
+	const char *p;
+	int conversions = 0;
+
+	for (p = pattern; *p; p++) {
+		if (*p != '%')
+			continue;
+		if (p[1] == '%') {
+			p++;
+			continue;
+		}
+		for (p++; *p >= '0' && *p <= '9'; p++)
+			;
+		if (!*p || !strchr("xXdu", *p))
+			return -EINVAL;
+		conversions++;
+	}
+
+	if (conversions == 1 && index <= 0xff)
+		snprintf(str, sizeof(str), pattern, index);
+	else if (conversions == 2 && index <= 0xffff)
+		snprintf(str, sizeof(str), pattern, index >> 8, index & 0xff);
+	else
+		return -EINVAL;
+
+	return string_to_mac_address(str, addr);
 }
 
-static int get_no_fading_signal(struct wmediumd *ctx)
+/*
+ * A random value for draw n of generator g, independent of the stations
+ * placed before it by the ids list or by other generators
+ */
+static double generator_random(u64 seed, int g, int n, u32 block, int word)
 {
+	u32 out[4];
+
+	rng_link_block(seed, NULL, NULL, (u64)g << 32 | (u32)n,
+		       RNG_STREAM_TOPOLOGY, block, out);
+	return rng_u32_to_double(out[word]);
+}
+
+static int generators_count(struct wmediumd *ctx,
+			    const config_setting_t *generators)
+{
+	const config_setting_t *gen;
+	int i, count, total = 0;
+
+	for (i = 0; generators && i < config_setting_length(generators); i++) {
+		gen = config_setting_get_elem(generators, i);
+		if (config_setting_lookup_int(gen, "count", &count) !=
+		    CONFIG_TRUE || count < 0) {
+			w_flogf(ctx, LOG_ERR, stderr,
+				"generator %d: count not found\n", i);
+			return -EINVAL;
+		}
+		total += count;
+	}
+	return total;
+}
+
+/*
+ * Create the stations described by ifaces.generators, starting at index
+ * first.  Supported types are "line", "grid", "random" and "clustered".
+ */
+static int parse_generators(struct wmediumd *ctx,
+			    const config_setting_t *generators, int first)
+{
+	const config_setting_t *gen, *setting;
+	const char *type, *mac;
+	double spacing, radius, width, height, ox, oy, oz;
+	double cx, cy, r, theta;
+	int i, n, g, count, columns, clusters, tx_power, isap, seed;
+	struct station *station;
+	u8 addr[ETH_ALEN];
+	int index = first;
+
+	for (g = 0; g < config_setting_length(generators); g++) {
+		gen = config_setting_get_elem(generators, g);
+		config_setting_lookup_int(gen, "count", &count);
+
+		if (config_setting_lookup_string(gen, "type", &type) !=
+		    CONFIG_TRUE) {
+			w_flogf(ctx, LOG_ERR, stderr,
+				"generator %d: type not found\n", g);
+			return -EINVAL;
+		}
+		if (config_setting_lookup_string(gen, "mac", &mac) !=
+		    CONFIG_TRUE)
+			mac = "02:00:00:%02x:%02x:00";
+		if (config_setting_lookup_float(gen, "spacing", &spacing) !=
+		    CONFIG_TRUE)
+			spacing = 1.0;
+		if (config_setting_lookup_float(gen, "radius", &radius) !=
+		    CONFIG_TRUE)
+			radius = 1.0;
+		if (config_setting_lookup_int(gen, "columns", &columns) !=
+		    CONFIG_TRUE || columns <= 0)
+			columns = (int)ceil(sqrt(count));
+		if (config_setting_lookup_int(gen, "clusters", &clusters) !=
+		    CONFIG_TRUE || clusters <= 0)
+			clusters = 1;
+		if (config_setting_lookup_int(gen, "tx_power", &tx_power) !=
+		    CONFIG_TRUE)
+			tx_power = SNR_DEFAULT;
+		if (config_setting_lookup_int(gen, "isap", &isap) !=
+		    CONFIG_TRUE)
+			isap = AP_DEFAULT;
+		if (config_setting_lookup_int(gen, "seed", &seed) !=
+		    CONFIG_TRUE)
+			seed = 0;
+
+		ox = oy = oz = 0.0;
+		setting = config_setting_get_member(gen, "origin");
+		if (setting) {
+			if (config_setting_length(setting) != 3) {
+				w_flogf(ctx, LOG_ERR, stderr,
+					"generator %d: invalid origin: expected (double,double,double)\n",
+					g);
+				return -EINVAL;
+			}
+			ox = config_setting_get_float_elem(setting, 0);
+			oy = config_setting_get_float_elem(setting, 1);
+			oz = config_setting_get_float_elem(setting, 2);
+		}
+
+		width = height = 100.0;
+		setting = config_setting_get_member(gen, "area");
+		if (setting) {
+			if (config_setting_length(setting) != 2) {
+				w_flogf(ctx, LOG_ERR, stderr,
+					"generator %d: invalid area: expected (double,double)\n",
+					g);
+				return -EINVAL;
+			}
+			width = config_setting_get_float_elem(setting, 0);
+			height = config_setting_get_float_elem(setting, 1);
+		}
+
+		for (i = 0; i < count; i++, index++) {
+			if (generate_mac_address(mac, index, addr)) {
+				w_flogf(ctx, LOG_ERR, stderr,
+					"generator %d: mac pattern '%s' is invalid or cannot address station %d\n",
+					g, mac, index);
+				return -EINVAL;
+			}
+
+			station = new_station(ctx, index, addr);
+			if (!station)
+				return -ENOMEM;
+			station->tx_power = tx_power;
+			station->isap = isap;
+			station->z = oz;
+
+			if (strcmp(type, "line") == 0) {
+				station->x = ox + i * spacing;
+				station->y = oy;
+			} else if (strcmp(type, "grid") == 0) {
+				station->x = ox + (i % columns) * spacing;
+				station->y = oy + (i / columns) * spacing;
+			} else if (strcmp(type, "random") == 0) {
+				station->x = ox + width *
+					generator_random(seed, g, i, 0, 0);
+				station->y = oy + height *
+					generator_random(seed, g, i, 0, 1);
+			} else if (strcmp(type, "clustered") == 0) {
+				n = i % clusters;
+				cx = ox + width *
+					generator_random(seed, g, n, 1, 0);
+				cy = oy + height *
+					generator_random(seed, g, n, 1, 1);
+				r = radius * sqrt(
+					generator_random(seed, g, i, 2, 0));
+				theta = 2.0 * M_PI *
+					generator_random(seed, g, i, 2, 1);
+				station->x = cx + r * cos(theta);
+				station->y = cy + r * sin(theta);
+			} else {
+				w_flogf(ctx, LOG_ERR, stderr,
+					"generator %d: unknown type '%s'\n",
+					g, type);
+				return -EINVAL;
+			}
+		}
+
+		w_logf(ctx, LOG_NOTICE, "Generated %d stations (%s)\n", count,
+		       type);
+	}
+
 	return 0;
 }
 
+void init_model_callbacks(struct wmediumd *ctx, bool move)
+{
+	ctx->move_stations = move ? move_stations_to_direction :
+				    move_stations_donothing;
+	ctx->get_fading_signal = ctx->fading_coefficient > 0 ?
+				 _get_fading_signal : get_no_fading_signal;
+	ctx->station_err_matrix = NULL;
+
+	if (ctx->error_prob_matrix) {
+		ctx->get_link_snr = get_link_snr_default;
+		ctx->get_error_prob = get_error_prob_from_matrix;
+	} else {
+		ctx->get_link_snr = get_link_snr_from_snr_matrix;
+		ctx->get_error_prob = _get_error_prob_from_snr;
+	}
+}
+
+bool is_moving_stations(struct wmediumd *ctx)
+{
+	return ctx->move_stations == move_stations_to_direction;
+}
+
 /*
  *	Loads a config file into memory
  */
 int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bool full_dynamic)
 {
 	config_t cfg, *cf;
-	const config_setting_t *ids, *links, *model_type;
+	const config_setting_t *ids, *generators, *links, *model_type;
 	const config_setting_t *error_probs = NULL, *error_prob;
 	const config_setting_t *enable_interference;
 	const config_setting_t *fading_coefficient, *noise_threshold, *default_prob;
+	const config_setting_t *seed;
 	const config_setting_t *mediums, *medium_data,*interface_data, *medium_detection;
-	int count_ids, count_mediums, count_interfaces, station_id, i, j;
+	int count_ids, count_generated, count_mediums, count_interfaces;
+	int station_id, i, j;
 	int start, end, snr;
 	struct station *station;
 	const char *model_type_str;
 	float default_prob_value = 0.0;
 	bool *link_map = NULL;
 
+	ctx->snapshot_map = NULL;
+	ctx->snapshot_len = 0;
+	ctx->path_loss_param = NULL;
+	ctx->calc_path_loss = NULL;
+	ctx->sta_capacity = 0;
+	ctx->slot_gen = NULL;
+	ctx->num_slot_gens = 0;
+	ctx->free_slots = NULL;
+	ctx->num_free_slots = 0;
+
 	if (full_dynamic) {
 		ctx->sta_array = malloc(0);
 		ctx->num_stas = 0;
 		ctx->intf = NULL;
 		ctx->get_fading_signal = get_no_fading_signal;
 		ctx->fading_coefficient = 0;
+		ctx->rng_seed = 0;
 		ctx->move_stations = move_stations_donothing;
 		ctx->snr_matrix = malloc(0);
 		ctx->per_matrix = NULL;
@@ -601,6 +986,9 @@ int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bo
 	}
 	ctx->station_err_matrix = NULL;
 
+	if (wmsnap_is_snapshot(file))
+		return wmsnap_load(ctx, file, per_file);
+
 	/*initialize the config file*/
 	cf = &cfg;
 	config_init(cf);
@@ -616,11 +1004,15 @@ int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bo
 	}
 
 	ids = config_lookup(cf, "ifaces.ids");
-	if (!ids) {
+	generators = config_lookup(cf, "ifaces.generators");
+	if (!ids && !generators) {
 		w_logf(ctx, LOG_ERR, "ids not found in config file\n");
 		return -EIO;
 	}
-	count_ids = config_setting_length(ids);
+	count_generated = generators_count(ctx, generators);
+	if (count_generated < 0)
+		return -EINVAL;
+	count_ids = (ids ? config_setting_length(ids) : 0) + count_generated;
 
 	w_logf(ctx, LOG_NOTICE, "#_if = %d\n", count_ids);
 
@@ -630,32 +1022,21 @@ int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bo
 		w_flogf(ctx, LOG_ERR, stderr, "Out of memory(sta_array)!\n");
 		return -ENOMEM;
 	}
-	for (i = 0; i < count_ids; i++) {
+	for (i = 0; ids && i < config_setting_length(ids); i++) {
 		u8 addr[ETH_ALEN];
 		const char *str =  config_setting_get_string_elem(ids, i);
 		string_to_mac_address(str, addr);
 
-		station = malloc(sizeof(*station));
-		if (!station) {
-			w_flogf(ctx, LOG_ERR, stderr, "Out of memory!\n");
+		station = new_station(ctx, i, addr);
+		if (!station)
 			return -ENOMEM;
-		}
-		station->index = i;
-		memcpy(station->addr, addr, ETH_ALEN);
-		memcpy(station->hwaddr, addr, ETH_ALEN);
-		station->tx_power = SNR_DEFAULT;
-		station->gain = GAIN_DEFAULT;
-		//station->height = HEIGHT_DEFAULT;
-		station->gRandom = GAUSS_RANDOM_DEFAULT;
-		station->isap = AP_DEFAULT;
-		station->medium_id = MEDIUM_ID_DEFAULT;
-		station_init_queues(station);
-		list_add_tail(&station->list, &ctx->stations);
-		ctx->sta_array[i] = station;
 
 		w_logf(ctx, LOG_NOTICE, "Added station %d: " MAC_FMT "\n", i, MAC_ARGS(addr));
 	}
+	if (generators && parse_generators(ctx, generators, i))
+		return -EINVAL;
 	ctx->num_stas = count_ids;
+	ctx->sta_capacity = count_ids;
 
 	enable_interference = config_lookup(cf, "ifaces.enable_interference");
 	if (enable_interference &&
@@ -697,6 +1078,12 @@ int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bo
 		ctx->fading_coefficient = 0;
 	}
 
+	seed = config_lookup(cf, "model.seed");
+	if (seed)
+		ctx->rng_seed = (u64)config_setting_get_int64(seed);
+	else
+		ctx->rng_seed = 0;
+
 	ctx->move_stations = move_stations_donothing;
 
 	/* create link quality matrix */
@@ -722,7 +1109,7 @@ int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bo
 			} else if (memcmp("path_loss", model_type_str,
 				strlen("path_loss")) == 0) {
 				/* calculate signal from positions */
-				if (parse_path_loss(ctx, cf))
+				if (parse_path_loss(ctx, cf, count_generated > 0))
 					goto fail;
 			}
 		}
@@ -877,6 +1264,229 @@ int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bo
 fail:
 	free(ctx->snr_matrix);
 	free(ctx->error_prob_matrix);
+	ctx->snr_matrix = NULL;
+	ctx->error_prob_matrix = NULL;
 	config_destroy(cf);
 	return -EINVAL;
 }
+
+static int compare_station_addr(const void *a, const void *b)
+{
+	const struct station *sa = *(struct station * const *)a;
+	const struct station *sb = *(struct station * const *)b;
+
+	return memcmp(sa->addr, sb->addr, ETH_ALEN);
+}
+
+static bool station_config_differs(const struct station *a,
+				   const struct station *b)
+{
+	return a->x != b->x || a->y != b->y || a->z != b->z ||
+	       a->dir_x != b->dir_x || a->dir_y != b->dir_y ||
+	       a->tx_power != b->tx_power || a->gain != b->gain ||
+	       a->gRandom != b->gRandom || a->isap != b->isap ||
+	       a->medium_id != b->medium_id;
+}
+
+static void free_config_matrix(struct wmediumd *ctx, void *matrix)
+{
+	if (!wmsnap_is_mapped(ctx, matrix))
+		free(matrix);
+}
+
+/* Free what load_config() built in the scratch context of a reload */
+static void free_loaded_config(struct wmediumd *next)
+{
+	struct station *station, *tmp;
+
+	list_for_each_entry_safe(station, tmp, &next->stations, list)
+		free(station);
+	free(next->sta_array);
+	free(next->slot_gen);
+	free(next->free_slots);
+	free_config_matrix(next, next->snr_matrix);
+	free_config_matrix(next, next->error_prob_matrix);
+	free(next->station_err_matrix);
+	free(next->intf);
+	free(next->per_matrix);
+	free(next->path_loss_param);
+	if (next->snapshot_map)
+		munmap(next->snapshot_map, next->snapshot_len);
+}
+
+/*
+ *	Re-reads the config file and applies the differences to the running
+ *	state.  The new topology, including every recomputed link, is built
+ *	in a scratch context first, so the write lock is only held while the
+ *	stations are matched up and the matrices are swapped.
+ */
+int reload_config(struct wmediumd *ctx)
+{
+	struct wmediumd next;
+	struct station **sorted = NULL, **match = NULL, **found;
+	struct station *station, *tmp, *old;
+	bool *kept = NULL;
+	u32 *slot_gen = NULL;
+	int added = 0, removed = 0, changed = 0;
+	int i, num_sorted = 0, num_slot_gens, ret;
+
+	if (!ctx->config_file) {
+		w_logf(ctx, LOG_WARNING,
+		       "No config file to reload in dynamic mode\n");
+		return -EINVAL;
+	}
+
+	memset(&next, 0, sizeof(next));
+	INIT_LIST_HEAD(&next.stations);
+	next.log_lvl = ctx->log_lvl;
+	next.config_file = ctx->config_file;
+	next.per_file = ctx->per_file;
+
+	ret = load_config(&next, ctx->config_file, ctx->per_file, false);
+	if (ret) {
+		w_flogf(ctx, LOG_ERR, stderr,
+			"Reload of %s failed, keeping the running config\n",
+			ctx->config_file);
+		free_loaded_config(&next);
+		return ret;
+	}
+
+	pthread_rwlock_wrlock(&snr_lock);
+
+	sorted = malloc(sizeof(*sorted) * (ctx->num_stas + 1));
+	match = calloc(next.num_stas + 1, sizeof(*match));
+	kept = calloc(ctx->num_stas + 1, sizeof(*kept));
+	num_slot_gens = ctx->num_slot_gens > next.sta_capacity ?
+			ctx->num_slot_gens : next.sta_capacity;
+	slot_gen = calloc(num_slot_gens + 1, sizeof(*slot_gen));
+	if (!sorted || !match || !kept || !slot_gen) {
+		free_loaded_config(&next);
+		ret = -ENOMEM;
+		goto out;
+	}
+	/* skip the slots of deleted stations */
+	for (i = 0; i < ctx->num_stas; i++)
+		if (ctx->sta_array[i])
+			sorted[num_sorted++] = ctx->sta_array[i];
+	qsort(sorted, num_sorted, sizeof(*sorted), compare_station_addr);
+
+	for (i = 0; i < next.num_stas; i++) {
+		station = next.sta_array[i];
+		found = bsearch(&station, sorted, num_sorted,
+				sizeof(*sorted), compare_station_addr);
+		if (found && !kept[(*found)->index]) {
+			match[i] = *found;
+			kept[(*found)->index] = true;
+		} else {
+			added++;
+		}
+	}
+
+	list_for_each_entry_safe(station, tmp, &ctx->stations, list) {
+		list_del(&station->list);
+		if (!kept[station->index]) {
+			link_state_retire_station(station);
+			removed++;
+		}
+	}
+
+	/*
+	 * Stations that exist in both keep their object, and with it the
+	 * state learned from the radio (hwaddr, frequency, queues).
+	 */
+	INIT_LIST_HEAD(&ctx->stations);
+	for (i = 0; i < next.num_stas; i++) {
+		station = next.sta_array[i];
+		old = match[i];
+		if (old) {
+			if (station_config_differs(old, station))
+				changed++;
+			old->index = station->index;
+			old->x = station->x;
+			old->y = station->y;
+			old->z = station->z;
+			old->dir_x = station->dir_x;
+			old->dir_y = station->dir_y;
+			old->tx_power = station->tx_power;
+			old->gain = station->gain;
+			old->gRandom = station->gRandom;
+			old->isap = station->isap;
+			old->medium_id = station->medium_id;
+			next.sta_array[i] = old;
+			free(station);
+			station = old;
+		}
+		list_add_tail(&station->list, &ctx->stations);
+	}
+
+	/*
+	 * Slots are renumbered in config order. IDs handed out before must
+	 * not match the station that now sits in their slot, so every slot
+	 * whose occupant changed moves on to a new generation.
+	 */
+	for (i = 0; i < num_slot_gens; i++) {
+		old = i < ctx->num_stas ? ctx->sta_array[i] : NULL;
+		station = i < next.num_stas ? next.sta_array[i] : NULL;
+		if (i < ctx->num_slot_gens)
+			slot_gen[i] = ctx->slot_gen[i];
+		if (old != station)
+			slot_gen[i]++;
+	}
+	free(next.slot_gen);
+	next.slot_gen = slot_gen;
+	next.num_slot_gens = num_slot_gens;
+	slot_gen = NULL;
+
+	free(ctx->sta_array);
+	ctx->sta_array = next.sta_array;
+	ctx->num_stas = next.num_stas;
+	ctx->sta_capacity = next.sta_capacity;
+	free(ctx->slot_gen);
+	free(ctx->free_slots);
+	ctx->slot_gen = next.slot_gen;
+	ctx->num_slot_gens = next.num_slot_gens;
+	ctx->free_slots = next.free_slots;
+	ctx->num_free_slots = next.num_free_slots;
+
+	free_config_matrix(ctx, ctx->snr_matrix);
+	free_config_matrix(ctx, ctx->error_prob_matrix);
+	free(ctx->intf);
+	free(ctx->per_matrix);
+	free(ctx->path_loss_param);
+	if (ctx->snapshot_map)
+		munmap(ctx->snapshot_map, ctx->snapshot_len);
+
+	ctx->snr_matrix = next.snr_matrix;
+	ctx->error_prob_matrix = next.error_prob_matrix;
+	ctx->station_err_matrix = next.station_err_matrix;
+	ctx->intf = next.intf;
+	ctx->per_matrix = next.per_matrix;
+	ctx->per_matrix_row_num = next.per_matrix_row_num;
+	ctx->per_matrix_signal_min = next.per_matrix_signal_min;
+	ctx->path_loss_param = next.path_loss_param;
+	ctx->snapshot_map = next.snapshot_map;
+	ctx->snapshot_len = next.snapshot_len;
+	ctx->noise_threshold = next.noise_threshold;
+	ctx->fading_coefficient = next.fading_coefficient;
+	ctx->rng_seed = next.rng_seed;
+	ctx->enable_medium_detection = next.enable_medium_detection;
+	ctx->get_link_snr = next.get_link_snr;
+	ctx->get_error_prob = next.get_error_prob;
+	ctx->calc_path_loss = next.calc_path_loss;
+	ctx->move_stations = next.move_stations;
+	ctx->get_fading_signal = next.get_fading_signal;
+	link_state_publish(ctx);
+
+out:
+	pthread_rwlock_unlock(&snr_lock);
+	free(sorted);
+	free(match);
+	free(kept);
+	free(slot_gen);
+
+	if (!ret)
+		w_logf(ctx, LOG_NOTICE,
+		       "Reloaded %s: %d stations added, %d removed, %d changed\n",
+		       ctx->config_file, added, removed, changed);
+	return ret;
+}
@@ -26,5 +26,14 @@
 
 int load_config(struct wmediumd *ctx, const char *file, const char *per_file, bool full_dynamic);
 int use_fixed_random_value(struct wmediumd *ctx);
+const char *get_path_loss_model_name(struct wmediumd *ctx,
+				     size_t *param_size);
+int set_path_loss_model(struct wmediumd *ctx, const char *name,
+			const void *param, size_t param_size);
+void init_model_callbacks(struct wmediumd *ctx, bool move);
+bool is_moving_stations(struct wmediumd *ctx);
+int reload_config(struct wmediumd *ctx);
+void recalc_path_loss(struct wmediumd *ctx);
+void recalc_station_links(struct wmediumd *ctx, const int *indices, int count);
 
 #endif /* CONFIG_H_ */
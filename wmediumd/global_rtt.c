@@ -0,0 +1,209 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Round trip times of the link to the global medium
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+
+#include "global_rtt.h"
+#include "metrics.h"
+
+static u64 timespec_ns(const struct timespec *ts)
+{
+	return (u64)ts->tv_sec * 1000000000ull + ts->tv_nsec;
+}
+
+static u64 realtime_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return timespec_ns(&now);
+}
+
+int global_rtt_init(struct global_rtt *rtt, int sock)
+{
+	int flags = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_ACK |
+		    SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+		    SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+
+	memset(rtt, 0, sizeof(*rtt));
+	rtt->sock = sock;
+	if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+		       sizeof(flags)))
+		return -errno;
+	rtt->kernel_stamps = true;
+	return 0;
+}
+
+static struct global_rtt_request *find_tskey(struct global_rtt *rtt, u32 tskey)
+{
+	int i;
+
+	for (i = 0; i < GLOBAL_RTT_PENDING; i++)
+		if (rtt->pending[i].valid && rtt->pending[i].tskey == tskey)
+			return &rtt->pending[i];
+	return NULL;
+}
+
+void global_rtt_sent(struct global_rtt *rtt, u64 cookie, size_t len)
+{
+	struct global_rtt_request *req;
+
+	/* cookies count up, so a slot is only reused GLOBAL_RTT_PENDING later */
+	req = &rtt->pending[cookie % GLOBAL_RTT_PENDING];
+	req->cookie = cookie;
+	req->sent = realtime_now();
+	req->on_wire = 0;
+	req->acked = 0;
+	rtt->bytes_sent += len;
+	/* OPT_ID numbers the bytes of a stream socket from 0 */
+	req->tskey = rtt->bytes_sent - 1;
+	req->valid = true;
+}
+
+/* Collect the tx timestamps the kernel queued for the requests sent */
+static void read_tx_stamps(struct global_rtt *rtt)
+{
+	char control[512];
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct scm_timestamping *stamps;
+	struct sock_extended_err *err;
+	struct global_rtt_request *req;
+
+	for (;;) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		if (recvmsg(rtt->sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+			return;
+
+		stamps = NULL;
+		err = NULL;
+		for (cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+		     cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET &&
+			    cmsg->cmsg_type == SCM_TIMESTAMPING)
+				stamps = (void *)CMSG_DATA(cmsg);
+			else if ((cmsg->cmsg_level == SOL_IP &&
+				  cmsg->cmsg_type == IP_RECVERR) ||
+				 (cmsg->cmsg_level == SOL_IPV6 &&
+				  cmsg->cmsg_type == IPV6_RECVERR))
+				err = (void *)CMSG_DATA(cmsg);
+		}
+		if (!stamps || !err ||
+		    err->ee_origin != SO_EE_ORIGIN_TIMESTAMPING)
+			continue;
+
+		req = find_tskey(rtt, err->ee_data);
+		if (!req)
+			continue;
+		if (err->ee_info == SCM_TSTAMP_SND)
+			req->on_wire = timespec_ns(&stamps->ts[0]);
+		else if (err->ee_info == SCM_TSTAMP_ACK)
+			req->acked = timespec_ns(&stamps->ts[0]);
+	}
+}
+
+ssize_t global_rtt_recv(struct global_rtt *rtt, void *buf, size_t len,
+			u64 *rx_time)
+{
+	char control[256];
+	struct iovec iov = { buf, len };
+	struct msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+		.msg_control = control,
+		.msg_controllen = sizeof(control),
+	};
+	struct cmsghdr *cmsg;
+	ssize_t ret;
+
+	ret = recvmsg(rtt->sock, &msg, 0);
+	*rx_time = 0;
+	if (ret < 0)
+		return ret;
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET &&
+		    cmsg->cmsg_type == SCM_TIMESTAMPING) {
+			struct scm_timestamping *stamps = (void *)CMSG_DATA(cmsg);
+
+			*rx_time = timespec_ns(&stamps->ts[0]);
+		}
+	}
+	if (!*rx_time)
+		*rx_time = realtime_now();
+	return ret;
+}
+
+void global_rtt_replied(struct wmediumd *ctx, struct global_rtt *rtt,
+			u64 cookie, u64 rx_time, int ac)
+{
+	struct global_rtt_request *req;
+	u64 start, total, net = 0, server = 0;
+
+	if (rtt->kernel_stamps)
+		read_tx_stamps(rtt);
+
+	req = &rtt->pending[cookie % GLOBAL_RTT_PENDING];
+	if (!req->valid || req->cookie != cookie)
+		return;
+	req->valid = false;
+
+	/* measure from the kernel's view of the request when there is one */
+	start = req->on_wire ? req->on_wire : req->sent;
+	if (rx_time < start)
+		return;
+	total = rx_time - start;
+	metrics_record(METRICS_STAGE_GLOBAL_RTT, ac, total);
+	if (req->acked >= start &&
+	    req->acked + GLOBAL_RTT_SPLIT_MIN < rx_time) {
+		/* the peer's ACK took one network round trip */
+		net = req->acked - start;
+		server = rx_time - req->acked;
+		metrics_record(METRICS_STAGE_GLOBAL_NET, ac, net);
+		metrics_record(METRICS_STAGE_GLOBAL_SERVER, ac, server);
+	} else {
+		/* no ACK of its own, or it came along with the reply */
+		metrics_count(METRICS_GLOBAL_UNSPLIT);
+	}
+
+	if (rtt->mean && total > GLOBAL_RTT_OUTLIER_MIN &&
+	    total > GLOBAL_RTT_OUTLIER_FACTOR * rtt->mean) {
+		rtt->outliers++;
+		w_logf_ratelimited(ctx, LOG_WARNING, "Slow reply from the "
+				   "global medium for cookie %llu: %llu us "
+				   "(network %llu us, server %llu us), "
+				   "average %llu us\n",
+				   (unsigned long long)cookie,
+				   (unsigned long long)total / 1000,
+				   (unsigned long long)net / 1000,
+				   (unsigned long long)server / 1000,
+				   (unsigned long long)rtt->mean / 1000);
+	}
+	/* moving average over about 64 replies */
+	rtt->mean = rtt->mean ? rtt->mean - rtt->mean / 64 + total / 64 : total;
+}
@@ -0,0 +1,91 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Round trip times of the link to the global medium
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef GLOBAL_RTT_H_
+#define GLOBAL_RTT_H_
+
+#include <sys/types.h>
+#include "wmediumd.h"
+
+/* Requests in flight that can still be matched with their timestamps */
+#define GLOBAL_RTT_PENDING	64
+
+/* Log round trips this many times slower than the average ... */
+#define GLOBAL_RTT_OUTLIER_FACTOR	8
+/* ... and slower than this [ns] */
+#define GLOBAL_RTT_OUTLIER_MIN		1000000
+
+/*
+ * Split a round trip only if the ACK came this much before the reply
+ * [ns].  A delayed ACK rides on the reply and would put the whole round
+ * trip into the network part.
+ */
+#define GLOBAL_RTT_SPLIT_MIN		20000
+
+struct global_rtt_request {
+	u64 cookie;
+	u32 tskey;			/* kernel id of its last byte */
+	bool valid;
+	u64 sent;			/* [ns], CLOCK_REALTIME */
+	u64 on_wire;			/* left the stack, 0 if unknown */
+	u64 acked;			/* acknowledged by the peer, 0 if unknown */
+};
+
+/*
+ * Timestamps of one connection to the global medium.  With
+ * SO_TIMESTAMPING the kernel reports when a request left the stack,
+ * when the peer acknowledged it and when the reply arrived, which
+ * splits the round trip into network and server time.  Without it only
+ * the user space round trip is measured.
+ */
+struct global_rtt {
+	int sock;
+	bool kernel_stamps;
+	u32 bytes_sent;			/* since timestamping was enabled */
+	struct global_rtt_request pending[GLOBAL_RTT_PENDING];
+	u64 mean;			/* moving average of the round trip [ns] */
+	u64 outliers;
+};
+
+/*
+ * Start tracking sock, enabling kernel timestamps if possible
+ * @return 0 if kernel timestamps are used, otherwise a negative errno value
+ */
+int global_rtt_init(struct global_rtt *rtt, int sock);
+
+/* A request for cookie of len bytes was sent */
+void global_rtt_sent(struct global_rtt *rtt, u64 cookie, size_t len);
+
+/*
+ * Receive a reply like recv(), taking its kernel timestamp along
+ * @param rx_time Receives the arrival time [ns], CLOCK_REALTIME
+ */
+ssize_t global_rtt_recv(struct global_rtt *rtt, void *buf, size_t len,
+			u64 *rx_time);
+
+/*
+ * The reply for cookie arrived at rx_time: account the round trip in
+ * the metrics of ac and log it if it is an outlier
+ */
+void global_rtt_replied(struct wmediumd *ctx, struct global_rtt *rtt,
+			u64 cookie, u64 rx_time, int ac);
+
+#endif /* GLOBAL_RTT_H_ */
@@ -0,0 +1,230 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Read-only shared memory export of the link state
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "link_export.h"
+#include "link_state.h"
+
+struct link_export {
+	int fd;
+	char *name;
+	u8 *map;
+	size_t map_size;
+};
+
+static size_t align_up(size_t size)
+{
+	return (size + LINK_EXPORT_ALIGN - 1) & ~(size_t)(LINK_EXPORT_ALIGN - 1);
+}
+
+static size_t buffer_size(const struct link_state *ls, size_t *stations_off,
+			  size_t *snr_off, size_t *errprob_off)
+{
+	size_t n = ls->num_stas, size;
+
+	size = align_up(sizeof(struct link_export_buffer));
+	*stations_off = size;
+	size += align_up(sizeof(struct link_export_station) * n);
+	*snr_off = size;
+	if (ls->snr_matrix)
+		size += align_up(sizeof(int32_t) * n * n);
+	*errprob_off = size;
+	if (ls->error_prob_matrix)
+		size += align_up(sizeof(double) * n * n);
+	return size;
+}
+
+/* Grow the object by size bytes and return the offset of the new space */
+static int grow(struct link_export *exp, size_t size, u64 *offset)
+{
+	struct link_export_header *hdr = (void *)exp->map;
+	size_t file_size = hdr->file_size + size;
+	u8 *map;
+
+	if (ftruncate(exp->fd, file_size))
+		return -errno;
+	map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		   exp->fd, 0);
+	if (map == MAP_FAILED)
+		return -errno;
+	munmap(exp->map, exp->map_size);
+	exp->map = map;
+	exp->map_size = file_size;
+
+	hdr = (void *)map;
+	*offset = hdr->file_size;
+	/* readers remap once they see it */
+	__atomic_store_n(&hdr->file_size, file_size, __ATOMIC_RELEASE);
+	return 0;
+}
+
+int link_export_open(struct wmediumd *ctx, const char *name)
+{
+	struct link_export_header *hdr;
+	struct link_export *exp;
+	size_t size = align_up(sizeof(*hdr));
+	int ret;
+
+	exp = calloc(1, sizeof(*exp));
+	if (!exp)
+		return -ENOMEM;
+	exp->name = strdup(name);
+	if (!exp->name) {
+		free(exp);
+		return -ENOMEM;
+	}
+
+	/* others may only look */
+	exp->fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (exp->fd < 0) {
+		ret = -errno;
+		goto free_exp;
+	}
+	if (ftruncate(exp->fd, size)) {
+		ret = -errno;
+		goto unlink;
+	}
+	exp->map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			exp->fd, 0);
+	if (exp->map == MAP_FAILED) {
+		ret = -errno;
+		goto unlink;
+	}
+	exp->map_size = size;
+
+	hdr = (void *)exp->map;
+	memcpy(hdr->magic, LINK_EXPORT_MAGIC, sizeof(hdr->magic));
+	hdr->version = LINK_EXPORT_VERSION;
+	hdr->header_size = sizeof(*hdr);
+	hdr->file_size = size;
+
+	ctx->link_export = exp;
+	return 0;
+
+unlink:
+	close(exp->fd);
+	shm_unlink(name);
+free_exp:
+	free(exp->name);
+	free(exp);
+	return ret;
+}
+
+void link_export_write(struct wmediumd *ctx, const struct link_state *ls)
+{
+	struct link_export *exp = ctx->link_export;
+	struct link_export_header *hdr;
+	struct link_export_buffer *buf;
+	struct link_export_station *stations;
+	size_t stations_off, snr_off, errprob_off, size;
+	int i, j, n = ls->num_stas, cur;
+	u64 offset = 0;
+	u8 *base;
+	int ret;
+
+	if (!exp)
+		return;
+
+	hdr = (void *)exp->map;
+	cur = (hdr->seq + 1) & 1;
+	/*
+	 * order the previous increment of seq before rewriting the buffer,
+	 * so readers that see the new contents also see that seq moved
+	 */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	size = buffer_size(ls, &stations_off, &snr_off, &errprob_off);
+	if (hdr->buffers[cur].size < size) {
+		/* leave room so that adding stations rarely moves the buffer */
+		size += size / 2;
+		ret = grow(exp, align_up(size), &offset);
+		if (ret) {
+			w_logf(ctx, LOG_ERR, "Cannot grow the link export: %s\n",
+			       strerror(-ret));
+			return;
+		}
+		hdr = (void *)exp->map;
+		__atomic_store_n(&hdr->buffers[cur].offset, offset,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&hdr->buffers[cur].size, align_up(size),
+				 __ATOMIC_RELAXED);
+	}
+
+	base = exp->map + hdr->buffers[cur].offset;
+	buf = (void *)base;
+	buf->version = ls->version;
+	buf->num_stas = n;
+	buf->flags = (ls->snr_matrix ? LINK_EXPORT_F_SNR : 0) |
+		     (ls->error_prob_matrix ? LINK_EXPORT_F_ERRPROB : 0);
+	buf->stations_off = stations_off;
+	buf->snr_off = snr_off;
+	buf->errprob_off = errprob_off;
+
+	stations = (void *)(base + stations_off);
+	for (i = 0; i < n; i++) {
+		const struct link_state_station *sta = &ls->stations[i];
+
+		memset(&stations[i], 0, sizeof(stations[i]));
+		memcpy(stations[i].addr, sta->addr, ETH_ALEN);
+		stations[i].tx_power = sta->tx_power;
+		stations[i].medium_id = sta->medium_id;
+		stations[i].x = sta->x;
+		stations[i].y = sta->y;
+		stations[i].z = sta->z;
+	}
+
+	for (i = 0; i < n; i++) {
+		size_t row = (size_t)ls->stations[i].index * ls->num_slots;
+		size_t out = (size_t)i * n;
+
+		for (j = 0; j < n; j++) {
+			int col = ls->stations[j].index;
+
+			if (ls->snr_matrix)
+				((int32_t *)(base + snr_off))[out + j] =
+					ls->snr_matrix[row + col];
+			if (ls->error_prob_matrix)
+				((double *)(base + errprob_off))[out + j] =
+					ls->error_prob_matrix[row + col];
+		}
+	}
+
+	__atomic_store_n(&hdr->seq, hdr->seq + 1, __ATOMIC_RELEASE);
+}
+
+void link_export_close(struct wmediumd *ctx)
+{
+	struct link_export *exp = ctx->link_export;
+
+	if (!exp)
+		return;
+	munmap(exp->map, exp->map_size);
+	close(exp->fd);
+	shm_unlink(exp->name);
+	free(exp->name);
+	free(exp);
+	ctx->link_export = NULL;
+}
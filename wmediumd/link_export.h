@@ -0,0 +1,116 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Read-only shared memory export of the link state
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef LINK_EXPORT_H_
+#define LINK_EXPORT_H_
+
+#include <stdint.h>
+
+#define LINK_EXPORT_MAGIC	"WMLINKS\0"
+#define LINK_EXPORT_VERSION	1
+#define LINK_EXPORT_ALIGN	64
+
+#define LINK_EXPORT_F_SNR	(1 << 0)
+#define LINK_EXPORT_F_ERRPROB	(1 << 1)
+
+/*
+ * Layout of the POSIX shared memory object, in host byte order:
+ *
+ *   struct link_export_header
+ *   ...
+ *   struct link_export_buffer at buffers[0].offset
+ *   struct link_export_buffer at buffers[1].offset
+ *
+ * A buffer holds one published snapshot:
+ *
+ *   struct link_export_buffer
+ *   struct link_export_station[num_stas]	sorted by addr
+ *   int32_t snr[num_stas^2]			at snr_off (LINK_EXPORT_F_SNR)
+ *   double error_prob[num_stas^2]		at errprob_off (LINK_EXPORT_F_ERRPROB)
+ *
+ * Matrices are dense and indexed by the position in the station array,
+ * row is the sender.  wmediumd writes the buffer that is not current and
+ * then increments seq, so buffers[seq & 1] is the current one.  Readers
+ * use a buffer in place:
+ *
+ *   s = atomic load-acquire of seq
+ *   read buffers[s & 1], remapping first if file_size has grown
+ *   acquire fence, then reload seq
+ *
+ * The read was consistent only if seq is still s, otherwise retry.  Once
+ * seq has moved to s + 1 the writer may already be rewriting buffers[s & 1]
+ * for s + 2.
+ */
+struct link_export_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	uint64_t seq;
+	uint64_t file_size;		/* grows, never shrinks */
+	struct {
+		uint64_t offset;
+		uint64_t size;		/* 0 until first written */
+	} buffers[2];
+};
+
+struct link_export_buffer {
+	uint64_t version;		/* link state version */
+	uint32_t num_stas;
+	uint32_t flags;			/* LINK_EXPORT_F_* */
+	uint64_t stations_off;		/* relative to the buffer */
+	uint64_t snr_off;
+	uint64_t errprob_off;
+	uint64_t reserved[3];
+};
+
+struct link_export_station {
+	uint8_t addr[6];
+	uint8_t pad[2];
+	int32_t tx_power;
+	int32_t medium_id;
+	double x, y, z;
+};
+
+#ifndef LINK_EXPORT_LAYOUT_ONLY
+
+#include "wmediumd.h"
+
+struct link_state;
+
+/*
+ * Create the shared memory object name (as for shm_open()) and export
+ * the link state of ctx there from now on.
+ * @return 0 on success otherwise a negative errno value
+ */
+int link_export_open(struct wmediumd *ctx, const char *name);
+
+/*
+ * Write a newly published snapshot, called by link_state_publish() with
+ * snr_lock held for writing.
+ */
+void link_export_write(struct wmediumd *ctx, const struct link_state *ls);
+
+/* Remove the shared memory object again */
+void link_export_close(struct wmediumd *ctx);
+
+#endif /* LINK_EXPORT_LAYOUT_ONLY */
+
+#endif /* LINK_EXPORT_H_ */
@@ -0,0 +1,172 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Versioned snapshots of the link state
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "link_state.h"
+#include "link_export.h"
+#include "rcu.h"
+
+static int compare_station_addr(const void *a, const void *b)
+{
+	const struct link_state_station *sa = a, *sb = b;
+
+	return memcmp(sa->addr, sb->addr, ETH_ALEN);
+}
+
+/* Called after each publish, see link_state_set_notify() */
+static void (*publish_notify)(void *data);
+static void *publish_notify_data;
+
+static void link_state_free(void *ptr)
+{
+	struct link_state *ls = ptr;
+
+	free(ls->stations);
+	free(ls->snr_matrix);
+	free(ls->error_prob_matrix);
+	free(ls);
+}
+
+static int copy_matrix(void **dst, const void *src, size_t elem_size,
+		       int num_slots, int stride)
+{
+	int row;
+
+	*dst = malloc(elem_size * num_slots * num_slots + 1);
+	if (!*dst)
+		return -ENOMEM;
+	for (row = 0; row < num_slots; row++)
+		memcpy((u8 *)*dst + elem_size * row * num_slots,
+		       (const u8 *)src + elem_size * row * stride,
+		       elem_size * num_slots);
+	return 0;
+}
+
+int link_state_publish(struct wmediumd *ctx)
+{
+	struct link_state *ls, *old;
+	struct link_state_station *entry;
+	struct station *station;
+	void (*notify)(void *data);
+	int i;
+
+	ls = calloc(1, sizeof(*ls));
+	if (!ls)
+		return -ENOMEM;
+
+	ls->num_slots = ctx->num_stas;
+	ls->stations = malloc(sizeof(*ls->stations) * (ctx->num_stas + 1));
+	if (!ls->stations)
+		goto nomem;
+
+	for (i = 0; i < ctx->num_stas; i++) {
+		station = ctx->sta_array[i];
+		if (!station)
+			continue;
+		entry = &ls->stations[ls->num_stas++];
+		memcpy(entry->addr, station->addr, ETH_ALEN);
+		entry->index = station->index;
+		entry->x = station->x;
+		entry->y = station->y;
+		entry->z = station->z;
+		entry->tx_power = station->tx_power;
+		entry->gain = station->gain;
+		entry->gRandom = station->gRandom;
+		entry->isap = station->isap;
+		entry->medium_id = station->medium_id;
+		entry->station = station;
+	}
+	qsort(ls->stations, ls->num_stas, sizeof(*ls->stations),
+	      compare_station_addr);
+
+	if (ctx->snr_matrix &&
+	    copy_matrix((void **)&ls->snr_matrix, ctx->snr_matrix, sizeof(int),
+			ls->num_slots, ctx->sta_capacity))
+		goto nomem;
+	if (ctx->error_prob_matrix &&
+	    copy_matrix((void **)&ls->error_prob_matrix,
+			ctx->error_prob_matrix, sizeof(double),
+			ls->num_slots, ctx->sta_capacity))
+		goto nomem;
+
+	old = __atomic_load_n(&ctx->link_state, __ATOMIC_RELAXED);
+	ls->version = old ? old->version + 1 : 1;
+	__atomic_store_n(&ctx->link_state, ls, __ATOMIC_SEQ_CST);
+	rcu_retire(old, link_state_free);
+	link_export_write(ctx, ls);
+
+	notify = __atomic_load_n(&publish_notify, __ATOMIC_ACQUIRE);
+	if (notify)
+		notify(publish_notify_data);
+	return 0;
+
+nomem:
+	w_logf(ctx, LOG_ERR, "Out of memory publishing the link state\n");
+	link_state_free(ls);
+	return -ENOMEM;
+}
+
+void link_state_set_notify(void (*notify)(void *data), void *data)
+{
+	publish_notify_data = data;
+	__atomic_store_n(&publish_notify, notify, __ATOMIC_RELEASE);
+}
+
+const struct link_state *link_state_acquire(struct wmediumd *ctx)
+{
+	rcu_read_lock();
+	return __atomic_load_n(&ctx->link_state, __ATOMIC_SEQ_CST);
+}
+
+void link_state_release(void)
+{
+	rcu_read_unlock();
+}
+
+const struct link_state_station *
+link_state_find(const struct link_state *ls, const u8 *addr)
+{
+	struct link_state_station key;
+
+	if (!ls)
+		return NULL;
+	memcpy(key.addr, addr, ETH_ALEN);
+	return bsearch(&key, ls->stations, ls->num_stas,
+		       sizeof(*ls->stations), compare_station_addr);
+}
+
+void link_state_retire_station(struct station *station)
+{
+	rcu_retire(station, free);
+}
+
+void link_state_destroy(struct wmediumd *ctx)
+{
+	struct link_state *ls;
+
+	ls = __atomic_exchange_n(&ctx->link_state, NULL, __ATOMIC_SEQ_CST);
+	rcu_retire(ls, link_state_free);
+	rcu_barrier();
+}
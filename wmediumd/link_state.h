@@ -0,0 +1,100 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Versioned snapshots of the link state
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+
+#ifndef LINK_STATE_H_
+#define LINK_STATE_H_
+
+#include "wmediumd.h"
+
+/* Properties of a station as of one snapshot */
+struct link_state_station {
+	u8 addr[ETH_ALEN];
+	int index;			/* row/column in the matrices */
+	double x, y, z;
+	int tx_power;
+	int gain;
+	int gRandom;
+	int isap;
+	int medium_id;
+	/*
+	 * The live station, for the state learned from the radio (hwaddr,
+	 * freq).  Station objects are retired through RCU as well, so it
+	 * stays valid while the snapshot is held.
+	 */
+	struct station *station;
+};
+
+/*
+ * Immutable copy of the link state.  Writers build a new snapshot after
+ * each change under snr_lock and swap it in; readers never take snr_lock.
+ */
+struct link_state {
+	u64 version;
+	int num_stas;			/* entries in stations */
+	int num_slots;			/* dimension of the matrices */
+	struct link_state_station *stations;	/* sorted by addr */
+	int *snr_matrix;		/* num_slots x num_slots */
+	double *error_prob_matrix;	/* num_slots x num_slots or NULL */
+};
+
+/*
+ * Build a snapshot of ctx and make it the current one.  The caller holds
+ * snr_lock for writing (or is the only thread touching ctx).
+ * @return 0 on success otherwise a negative errno value
+ */
+int link_state_publish(struct wmediumd *ctx);
+
+/*
+ * Have notify(data) called after every publish, NULL to stop.  It runs in
+ * the publishing thread with snr_lock held, so it should only wake up
+ * whoever wants to look at the new snapshot.
+ */
+void link_state_set_notify(void (*notify)(void *data), void *data);
+
+/*
+ * Enter a read section and return the current snapshot, or NULL if none
+ * was published yet.  Must be paired with link_state_release().
+ */
+const struct link_state *link_state_acquire(struct wmediumd *ctx);
+
+/* Leave the read section entered by link_state_acquire() */
+void link_state_release(void);
+
+/* Find a station of the snapshot by its address */
+const struct link_state_station *
+link_state_find(const struct link_state *ls, const u8 *addr);
+
+/* SNR of the link from -> to in the snapshot */
+static inline int link_state_snr(const struct link_state *ls,
+				 const struct link_state_station *from,
+				 const struct link_state_station *to)
+{
+	return ls->snr_matrix[from->index * ls->num_slots + to->index];
+}
+
+/* Free a station object once no snapshot can reference it anymore */
+void link_state_retire_station(struct station *station);
+
+/* Drop the current snapshot, e.g. on exit */
+void link_state_destroy(struct wmediumd *ctx);
+
+#endif /* LINK_STATE_H_ */
@@ -0,0 +1,310 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Per-link traffic statistics
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "link_stats.h"
+#include "rcu.h"
+
+#define LINK_STATS_MIN_SLOTS	256
+
+/*
+ * One link in a slab.  Only the owning thread writes it, readers load
+ * the counters with relaxed atomics and may see a frame half counted.
+ */
+struct link_stats_slot {
+	u8 src[ETH_ALEN];
+	u8 dst[ETH_ALEN];
+	u32 in_use;			/* set once src/dst are written */
+	struct link_stats_counters c;
+} __attribute__((aligned(64)));
+
+struct link_stats_table {
+	u32 mask;
+	u32 used;
+	struct link_stats_slot slots[];
+};
+
+/* Per-thread counters, on their own cache lines */
+struct link_stats_slab {
+	struct link_stats_table *table;	/* replaced through RCU on growth */
+	struct link_stats_slab *next;
+} __attribute__((aligned(64)));
+
+static struct link_stats_slab *slabs;
+static __thread struct link_stats_slab *own_slab;
+
+static u32 link_hash(const u8 *src, const u8 *dst)
+{
+	u32 hash = 2166136261u;
+	int i;
+
+	for (i = 0; i < ETH_ALEN; i++)
+		hash = (hash ^ src[i]) * 16777619u;
+	for (i = 0; i < ETH_ALEN; i++)
+		hash = (hash ^ dst[i]) * 16777619u;
+	return hash;
+}
+
+static struct link_stats_table *alloc_table(u32 num_slots)
+{
+	struct link_stats_table *table;
+
+	if (posix_memalign((void **)&table, 64, sizeof(*table) +
+			   sizeof(table->slots[0]) * num_slots))
+		return NULL;
+	memset(table, 0, sizeof(*table) + sizeof(table->slots[0]) * num_slots);
+	table->mask = num_slots - 1;
+	return table;
+}
+
+static struct link_stats_slot *find_slot(struct link_stats_table *table,
+					 const u8 *src, const u8 *dst)
+{
+	u32 i = link_hash(src, dst) & table->mask;
+	struct link_stats_slot *slot;
+
+	for (;;) {
+		slot = &table->slots[i];
+		if (!slot->in_use || (!memcmp(slot->src, src, ETH_ALEN) &&
+				      !memcmp(slot->dst, dst, ETH_ALEN)))
+			return slot;
+		i = (i + 1) & table->mask;
+	}
+}
+
+static struct link_stats_slab *get_slab(void)
+{
+	struct link_stats_slab *slab;
+
+	if (own_slab)
+		return own_slab;
+	if (posix_memalign((void **)&slab, 64, sizeof(*slab)))
+		return NULL;
+	slab->table = alloc_table(LINK_STATS_MIN_SLOTS);
+	if (!slab->table) {
+		free(slab);
+		return NULL;
+	}
+	/* slabs outlive their thread, the counts stay valid */
+	slab->next = __atomic_load_n(&slabs, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&slabs, &slab->next, slab, false,
+					    __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+	own_slab = slab;
+	return slab;
+}
+
+/* Double the table of the own slab, readers keep the old one until RCU frees it */
+static int grow_table(struct link_stats_slab *slab)
+{
+	struct link_stats_table *old = slab->table, *table;
+	struct link_stats_slot *slot;
+	u32 i;
+
+	table = alloc_table((old->mask + 1) * 2);
+	if (!table)
+		return -ENOMEM;
+	for (i = 0; i <= old->mask; i++) {
+		if (!old->slots[i].in_use)
+			continue;
+		slot = find_slot(table, old->slots[i].src, old->slots[i].dst);
+		*slot = old->slots[i];
+	}
+	table->used = old->used;
+	__atomic_store_n(&slab->table, table, __ATOMIC_RELEASE);
+	rcu_retire(old, free);
+	return 0;
+}
+
+#define stats_add(field, n) \
+	__atomic_store_n(&(field), (field) + (n), __ATOMIC_RELAXED)
+
+void link_stats_record(const u8 *src, const u8 *dst, size_t bytes,
+		       bool acked, int attempts, int airtime)
+{
+	struct link_stats_slab *slab = get_slab();
+	struct link_stats_slot *slot;
+
+	if (!slab)
+		return;
+
+	slot = find_slot(slab->table, src, dst);
+	if (!slot->in_use) {
+		/* keep the table at most half full */
+		if ((slab->table->used + 1) * 2 > slab->table->mask + 1) {
+			if (grow_table(slab))
+				return;
+			slot = find_slot(slab->table, src, dst);
+		}
+		memcpy(slot->src, src, ETH_ALEN);
+		memcpy(slot->dst, dst, ETH_ALEN);
+		slab->table->used++;
+		__atomic_store_n(&slot->in_use, 1, __ATOMIC_RELEASE);
+	}
+
+	stats_add(slot->c.frames, 1);
+	if (acked)
+		stats_add(slot->c.acked, 1);
+	else
+		stats_add(slot->c.failed, 1);
+	if (attempts > 1)
+		stats_add(slot->c.retries, attempts - 1);
+	stats_add(slot->c.bytes, bytes);
+	stats_add(slot->c.airtime, airtime);
+}
+
+static int compare_link(const void *a, const void *b)
+{
+	const struct link_stats *la = a, *lb = b;
+	int ret = memcmp(la->src, lb->src, ETH_ALEN);
+
+	return ret ? ret : memcmp(la->dst, lb->dst, ETH_ALEN);
+}
+
+#define stats_load(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+int link_stats_collect(struct link_stats **stats)
+{
+	struct link_stats_slab *slab;
+	struct link_stats_table *table;
+	struct link_stats *out = NULL, *tmp, *link;
+	struct link_stats_slot *slot;
+	int num = 0, capacity = 0, merged, i;
+	u32 j;
+
+	rcu_read_lock();
+	for (slab = __atomic_load_n(&slabs, __ATOMIC_ACQUIRE); slab;
+	     slab = slab->next) {
+		table = __atomic_load_n(&slab->table, __ATOMIC_ACQUIRE);
+		for (j = 0; j <= table->mask; j++) {
+			slot = &table->slots[j];
+			if (!__atomic_load_n(&slot->in_use, __ATOMIC_ACQUIRE))
+				continue;
+			if (num == capacity) {
+				capacity = capacity ? capacity * 2 : 64;
+				tmp = realloc(out, sizeof(*out) * capacity);
+				if (!tmp) {
+					rcu_read_unlock();
+					free(out);
+					return -ENOMEM;
+				}
+				out = tmp;
+			}
+			link = &out[num++];
+			memcpy(link->src, slot->src, ETH_ALEN);
+			memcpy(link->dst, slot->dst, ETH_ALEN);
+			link->c.frames = stats_load(slot->c.frames);
+			link->c.acked = stats_load(slot->c.acked);
+			link->c.failed = stats_load(slot->c.failed);
+			link->c.retries = stats_load(slot->c.retries);
+			link->c.bytes = stats_load(slot->c.bytes);
+			link->c.airtime = stats_load(slot->c.airtime);
+		}
+	}
+	rcu_read_unlock();
+
+	if (!num) {
+		*stats = NULL;
+		return 0;
+	}
+
+	/* the same link counted by several threads */
+	qsort(out, num, sizeof(*out), compare_link);
+	for (i = 0, merged = 0; i < num; i++) {
+		if (merged && !compare_link(&out[merged - 1], &out[i])) {
+			link = &out[merged - 1];
+			link->c.frames += out[i].c.frames;
+			link->c.acked += out[i].c.acked;
+			link->c.failed += out[i].c.failed;
+			link->c.retries += out[i].c.retries;
+			link->c.bytes += out[i].c.bytes;
+			link->c.airtime += out[i].c.airtime;
+		} else {
+			out[merged++] = out[i];
+		}
+	}
+
+	*stats = out;
+	return merged;
+}
+
+static int compare_airtime(const void *a, const void *b)
+{
+	const struct link_stats *la = a, *lb = b;
+
+	if (la->c.airtime != lb->c.airtime)
+		return la->c.airtime < lb->c.airtime ? 1 : -1;
+	return compare_link(a, b);
+}
+
+static void log_counters(struct wmediumd *ctx, const char *what,
+			 const struct link_stats_counters *c)
+{
+	w_logf(ctx, LOG_NOTICE, "%s: %llu frames, %llu acked, %llu failed, "
+	       "%llu retries, %llu bytes, %llu us airtime\n", what,
+	       (unsigned long long)c->frames, (unsigned long long)c->acked,
+	       (unsigned long long)c->failed, (unsigned long long)c->retries,
+	       (unsigned long long)c->bytes, (unsigned long long)c->airtime);
+}
+
+void link_stats_dump(struct wmediumd *ctx, int top)
+{
+	struct link_stats_counters station;
+	struct link_stats *stats;
+	char what[64];
+	int num, i;
+
+	num = link_stats_collect(&stats);
+	if (num < 0) {
+		w_logf(ctx, LOG_ERR, "Out of memory collecting link statistics\n");
+		return;
+	}
+
+	w_logf(ctx, LOG_NOTICE, "Traffic of %d links:\n", num);
+	/* links are sorted by sender, so the stations come out in order */
+	for (i = 0; i < num; i++) {
+		if (!i || memcmp(stats[i].src, stats[i - 1].src, ETH_ALEN))
+			memset(&station, 0, sizeof(station));
+		station.frames += stats[i].c.frames;
+		station.acked += stats[i].c.acked;
+		station.failed += stats[i].c.failed;
+		station.retries += stats[i].c.retries;
+		station.bytes += stats[i].c.bytes;
+		station.airtime += stats[i].c.airtime;
+		if (i + 1 == num || memcmp(stats[i].src, stats[i + 1].src, ETH_ALEN)) {
+			snprintf(what, sizeof(what), "  station " MAC_FMT,
+				 MAC_ARGS(stats[i].src));
+			log_counters(ctx, what, &station);
+		}
+	}
+
+	if (num)
+		qsort(stats, num, sizeof(*stats), compare_airtime);
+	for (i = 0; i < num && i < top; i++) {
+		snprintf(what, sizeof(what), "  link " MAC_FMT " -> " MAC_FMT,
+			 MAC_ARGS(stats[i].src), MAC_ARGS(stats[i].dst));
+		log_counters(ctx, what, &stats[i].c);
+	}
+	free(stats);
+}
@@ -0,0 +1,70 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Per-link traffic statistics
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef LINK_STATS_H_
+#define LINK_STATS_H_
+
+#include "wmediumd.h"
+
+/* Links listed by the periodic dump */
+#define LINK_STATS_DUMP_TOP	10
+
+struct link_stats_counters {
+	u64 frames;			/* handed to the medium */
+	u64 acked;
+	u64 failed;
+	u64 retries;			/* attempts beyond the first */
+	u64 bytes;
+	u64 airtime;			/* [usec], all attempts */
+};
+
+/* Counters of the link src -> dst, dst is the broadcast address for group frames */
+struct link_stats {
+	u8 src[ETH_ALEN];
+	u8 dst[ETH_ALEN];
+	struct link_stats_counters c;
+};
+
+/*
+ * Count one frame on the link src -> dst.  Each thread counts into its
+ * own slab, so this never contends with other threads or with readers.
+ * @attempts is the number of transmissions reported for the frame and
+ * @airtime their total duration.
+ */
+void link_stats_record(const u8 *src, const u8 *dst, size_t bytes,
+		       bool acked, int attempts, int airtime);
+
+/*
+ * Sum the slabs of all threads.  Must not be called from a link state
+ * read section.
+ * @param stats Receives a malloc()ed array sorted by src and dst
+ * @return The number of links, or a negative errno value
+ */
+int link_stats_collect(struct link_stats **stats);
+
+/*
+ * Log the per-station totals and the busiest links
+ * @param ctx The wmediumd context, for logging
+ * @param top How many links to list
+ */
+void link_stats_dump(struct wmediumd *ctx, int top);
+
+#endif /* LINK_STATS_H_ */
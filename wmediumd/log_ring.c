@@ -0,0 +1,438 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Asynchronous logging through per-thread rings
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "log_ring.h"
+
+enum log_length {
+	LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_Z, LEN_J, LEN_T, LEN_BIG_L,
+};
+
+/* One conversion of a format string */
+struct log_spec {
+	const char *start;		/* at the '%' */
+	const char *flags;		/* flags, width and precision ... */
+	int flags_len;			/* ... without the length modifier */
+	int stars;			/* '*' widths and precisions */
+	enum log_length length;
+	char conv;
+};
+
+union log_arg {
+	u64 u;
+	int64_t i;
+	double d;
+};
+
+struct log_record {
+	u64 timestamp;			/* [ns], CLOCK_MONOTONIC */
+	const char *format;		/* NULL if text is the whole message */
+	FILE *stream;
+	u16 text_len;
+	u8 num_args;
+	union log_arg args[LOG_RING_MAX_ARGS];
+	char text[LOG_RING_TEXT];
+};
+
+/* Written by its thread, read by the formatter */
+struct log_ring {
+	u32 head __attribute__((aligned(64)));	/* next record to write */
+	u64 dropped;
+	u32 tail __attribute__((aligned(64)));	/* next record to format */
+	u64 reported;			/* drops already reported */
+	struct log_ring *next;
+	struct log_record records[LOG_RING_SIZE];
+};
+
+static struct log_ring *rings;
+static __thread struct log_ring *own_ring;
+static pthread_t formatter;
+static bool running, stopping;
+
+static u64 monotonic_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (u64)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/*
+ * Parse the conversion at *p == '%'
+ * @return false for conversions the ring does not store
+ */
+static bool parse_spec(const char *p, struct log_spec *spec)
+{
+	spec->start = p++;
+	spec->flags = p;
+	spec->stars = 0;
+	while (*p && strchr("-+ #0123456789.*", *p))
+		spec->stars += *p++ == '*';
+	spec->flags_len = p - spec->flags;
+
+	spec->length = LEN_NONE;
+	switch (*p) {
+	case 'h':
+		spec->length = p[1] == 'h' ? LEN_HH : LEN_H;
+		p += spec->length == LEN_HH ? 2 : 1;
+		break;
+	case 'l':
+		spec->length = p[1] == 'l' ? LEN_LL : LEN_L;
+		p += spec->length == LEN_LL ? 2 : 1;
+		break;
+	case 'z': spec->length = LEN_Z; p++; break;
+	case 'j': spec->length = LEN_J; p++; break;
+	case 't': spec->length = LEN_T; p++; break;
+	case 'L': spec->length = LEN_BIG_L; p++; break;
+	}
+
+	spec->conv = *p;
+	switch (spec->conv) {
+	case 'c':
+	case 's':
+		/* wide characters are rare enough to format in place */
+		return spec->length == LEN_NONE;
+	case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+	case 'a': case 'A': case 'p': case '%':
+		return true;
+	default:
+		/* %n, %m and broken formats */
+		return false;
+	}
+}
+
+static const char *spec_end(const struct log_spec *spec)
+{
+	const char *p = spec->flags + spec->flags_len;
+
+	while (*p != spec->conv)
+		p++;
+	return p + 1;
+}
+
+static int64_t fetch_signed(enum log_length length, va_list *args)
+{
+	switch (length) {
+	case LEN_HH: return (signed char)va_arg(*args, int);
+	case LEN_H: return (short)va_arg(*args, int);
+	case LEN_L: return va_arg(*args, long);
+	case LEN_LL: return va_arg(*args, long long);
+	case LEN_Z: return va_arg(*args, ssize_t);
+	case LEN_J: return va_arg(*args, intmax_t);
+	case LEN_T: return va_arg(*args, ptrdiff_t);
+	default: return va_arg(*args, int);
+	}
+}
+
+static u64 fetch_unsigned(enum log_length length, va_list *args)
+{
+	switch (length) {
+	case LEN_HH: return (unsigned char)va_arg(*args, unsigned int);
+	case LEN_H: return (unsigned short)va_arg(*args, unsigned int);
+	case LEN_L: return va_arg(*args, unsigned long);
+	case LEN_LL: return va_arg(*args, unsigned long long);
+	case LEN_Z: return va_arg(*args, size_t);
+	case LEN_J: return va_arg(*args, uintmax_t);
+	case LEN_T: return va_arg(*args, ptrdiff_t);
+	default: return va_arg(*args, unsigned int);
+	}
+}
+
+/* Store the arguments of format in rec, false if it needs formatting now */
+static bool store_args(struct log_record *rec, const char *format,
+		       va_list *args)
+{
+	struct log_spec spec;
+	union log_arg *arg;
+	const char *p, *s;
+	size_t len;
+	int i;
+
+	for (p = strchr(format, '%'); p; p = strchr(p, '%')) {
+		if (!parse_spec(p, &spec))
+			return false;
+		p = spec_end(&spec);
+		if (spec.conv == '%')
+			continue;
+		if (rec->num_args + spec.stars + 1 > LOG_RING_MAX_ARGS)
+			return false;
+
+		for (i = 0; i < spec.stars; i++)
+			rec->args[rec->num_args++].i = va_arg(*args, int);
+		arg = &rec->args[rec->num_args++];
+		switch (spec.conv) {
+		case 'd':
+		case 'i':
+			arg->i = fetch_signed(spec.length, args);
+			break;
+		case 'u': case 'o': case 'x': case 'X':
+			arg->u = fetch_unsigned(spec.length, args);
+			break;
+		case 'c':
+			arg->i = va_arg(*args, int);
+			break;
+		case 'p':
+			arg->u = (uintptr_t)va_arg(*args, void *);
+			break;
+		case 's':
+			s = va_arg(*args, const char *);
+			if (!s)
+				s = "(null)";
+			if (rec->text_len == LOG_RING_TEXT)
+				return false;
+			len = strnlen(s, LOG_RING_TEXT - 1 - rec->text_len);
+			memcpy(rec->text + rec->text_len, s, len);
+			arg->u = rec->text_len;
+			rec->text_len += len;
+			rec->text[rec->text_len++] = '\0';
+			break;
+		default:
+			if (spec.length == LEN_BIG_L)
+				arg->d = va_arg(*args, long double);
+			else
+				arg->d = va_arg(*args, double);
+		}
+	}
+	return true;
+}
+
+static struct log_ring *get_ring(void)
+{
+	struct log_ring *ring;
+
+	if (own_ring)
+		return own_ring;
+	if (posix_memalign((void **)&ring, 64, sizeof(*ring)))
+		return NULL;
+	memset(ring, 0, sizeof(*ring));
+	/* rings outlive their thread, the formatter drains them later */
+	ring->next = __atomic_load_n(&rings, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&rings, &ring->next, ring, false,
+					    __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+	own_ring = ring;
+	return ring;
+}
+
+int log_ring_vlog(FILE *stream, const char *format, va_list args)
+{
+	struct log_ring *ring;
+	struct log_record *rec;
+	va_list copy;
+	u32 head;
+
+	if (!__atomic_load_n(&running, __ATOMIC_ACQUIRE))
+		return -1;
+	ring = get_ring();
+	if (!ring)
+		return -1;
+
+	head = ring->head;
+	if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) ==
+	    LOG_RING_SIZE) {
+		__atomic_store_n(&ring->dropped, ring->dropped + 1,
+				 __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	rec = &ring->records[head & (LOG_RING_SIZE - 1)];
+	rec->timestamp = monotonic_ns();
+	rec->stream = stream;
+	rec->format = format;
+	rec->num_args = 0;
+	rec->text_len = 0;
+	va_copy(copy, args);
+	if (!store_args(rec, format, &copy)) {
+		rec->format = NULL;
+		vsnprintf(rec->text, sizeof(rec->text), format, args);
+	}
+	va_end(copy);
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/* Print one conversion, resolving '*' from the stored arguments */
+static void print_arg(FILE *stream, const struct log_record *rec,
+		      const struct log_spec *spec, int *next)
+{
+	char conv[64];
+	const union log_arg *arg;
+	const char *p;
+	int len = 0;
+
+	conv[len++] = '%';
+	for (p = spec->flags; p < spec->flags + spec->flags_len &&
+	     len < (int)sizeof(conv) - 16; p++) {
+		if (*p == '*')
+			len += snprintf(conv + len, sizeof(conv) - len, "%d",
+					(int)rec->args[(*next)++].i);
+		else
+			conv[len++] = *p;
+	}
+	arg = &rec->args[(*next)++];
+
+	switch (spec->conv) {
+	case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+		snprintf(conv + len, sizeof(conv) - len, "ll%c", spec->conv);
+		fprintf(stream, conv, arg->u);
+		break;
+	case 'c':
+		snprintf(conv + len, sizeof(conv) - len, "c");
+		fprintf(stream, conv, (int)arg->i);
+		break;
+	case 'p':
+		snprintf(conv + len, sizeof(conv) - len, "p");
+		fprintf(stream, conv, (void *)(uintptr_t)arg->u);
+		break;
+	case 's':
+		snprintf(conv + len, sizeof(conv) - len, "s");
+		fprintf(stream, conv, rec->text + arg->u);
+		break;
+	default:
+		snprintf(conv + len, sizeof(conv) - len, "%c", spec->conv);
+		fprintf(stream, conv, arg->d);
+	}
+}
+
+static void print_record(const struct log_record *rec)
+{
+	struct log_spec spec;
+	const char *p = rec->format, *pct;
+	int next = 0;
+
+	if (!p) {
+		fputs(rec->text, rec->stream);
+		return;
+	}
+	while ((pct = strchr(p, '%'))) {
+		fwrite(p, 1, pct - p, rec->stream);
+		/* the format was accepted when the record was stored */
+		parse_spec(pct, &spec);
+		if (spec.conv == '%')
+			fputc('%', rec->stream);
+		else
+			print_arg(rec->stream, rec, &spec, &next);
+		p = spec_end(&spec);
+	}
+	fputs(p, rec->stream);
+}
+
+/* Format everything queued so far, oldest first across the threads */
+static bool drain(void)
+{
+	struct log_ring *ring, *oldest;
+	const struct log_record *rec;
+	u64 dropped;
+	bool any = false;
+	u32 tail;
+
+	for (;;) {
+		oldest = NULL;
+		for (ring = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); ring;
+		     ring = ring->next) {
+			tail = ring->tail;
+			if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE))
+				continue;
+			if (!oldest || ring->records[tail & (LOG_RING_SIZE - 1)].timestamp <
+			    oldest->records[oldest->tail & (LOG_RING_SIZE - 1)].timestamp)
+				oldest = ring;
+		}
+		if (!oldest)
+			break;
+
+		rec = &oldest->records[oldest->tail & (LOG_RING_SIZE - 1)];
+		print_record(rec);
+		__atomic_store_n(&oldest->tail, oldest->tail + 1,
+				 __ATOMIC_RELEASE);
+		any = true;
+	}
+
+	for (ring = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); ring;
+	     ring = ring->next) {
+		dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+		if (dropped == ring->reported)
+			continue;
+		fprintf(stderr, "wmediumd: %llu log messages dropped\n",
+			(unsigned long long)(dropped - ring->reported));
+		ring->reported = dropped;
+		any = true;
+	}
+
+	if (any) {
+		fflush(stdout);
+		fflush(stderr);
+	}
+	return any;
+}
+
+static void *formatter_thread(void *arg)
+{
+	struct timespec poll = { 0, LOG_RING_POLL_MS * 1000000L };
+
+	while (!__atomic_load_n(&stopping, __ATOMIC_ACQUIRE)) {
+		if (!drain())
+			nanosleep(&poll, NULL);
+	}
+	drain();
+	return NULL;
+}
+
+int log_ring_start(void)
+{
+	int ret;
+
+	if (running)
+		return 0;
+	stopping = false;
+	ret = pthread_create(&formatter, NULL, formatter_thread, NULL);
+	if (ret)
+		return -ret;
+	__atomic_store_n(&running, true, __ATOMIC_RELEASE);
+	atexit(log_ring_stop);
+	return 0;
+}
+
+void log_ring_stop(void)
+{
+	if (!running)
+		return;
+	/* later messages are printed synchronously again */
+	__atomic_store_n(&running, false, __ATOMIC_RELEASE);
+	__atomic_store_n(&stopping, true, __ATOMIC_RELEASE);
+	pthread_join(formatter, NULL);
+}
+
+u64 log_ring_dropped(void)
+{
+	struct log_ring *ring;
+	u64 dropped = 0;
+
+	for (ring = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); ring;
+	     ring = ring->next)
+		dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+	return dropped;
+}
@@ -0,0 +1,64 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Asynchronous logging through per-thread rings
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef LOG_RING_H_
+#define LOG_RING_H_
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "wmediumd.h"
+
+/* Records per thread, a power of two */
+#define LOG_RING_SIZE		1024
+/* Arguments and bytes of string arguments a record holds */
+#define LOG_RING_MAX_ARGS	12
+#define LOG_RING_TEXT		384
+/* How often the formatter looks for new records [ms] */
+#define LOG_RING_POLL_MS	10
+
+/*
+ * A log call is stored as its format string, the raw values of its
+ * arguments and a timestamp.  Formatting and I/O happen on a background
+ * thread, which merges the rings of all threads by timestamp.  Format
+ * strings must outlive the process (string literals); strings passed as
+ * arguments are copied and may be truncated.
+ */
+
+/*
+ * Start the formatter thread, the rings are drained at exit.  Messages
+ * racing with log_ring_stop() may be lost.
+ */
+int log_ring_start(void);
+
+/* Drain all rings and stop the formatter thread */
+void log_ring_stop(void);
+
+/*
+ * Queue a message for stream
+ * @return 0 if it was queued or dropped because the ring was full, -1 if
+ * the caller has to print it itself
+ */
+int log_ring_vlog(FILE *stream, const char *format, va_list args);
+
+/* Messages dropped on full rings so far */
+u64 log_ring_dropped(void);
+
+#endif /* LOG_RING_H_ */
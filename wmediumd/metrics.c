@@ -0,0 +1,203 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Frame path counters and latency histograms
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "metrics.h"
+
+#define METRICS_SUB_COUNT	(1 << METRICS_SUB_BITS)
+
+struct metrics_hist {
+	u64 count;
+	u64 sum;
+	u64 max;
+	u64 buckets[METRICS_HIST_BUCKETS];
+} __attribute__((aligned(64)));
+
+/* Registry of everything measured, updated with relaxed atomics */
+static struct {
+	u64 counters[METRICS_NUM_COUNTERS];
+	struct metrics_hist hists[METRICS_NUM_STAGES][IEEE80211_NUM_ACS];
+} metrics;
+
+const char *const metrics_stage_names[METRICS_NUM_STAGES] = {
+	[METRICS_STAGE_PARSE] = "parse",
+	[METRICS_STAGE_SEND] = "send",
+	[METRICS_STAGE_GLOBAL] = "global",
+	[METRICS_STAGE_TX_STATUS] = "tx_status",
+	[METRICS_STAGE_TOTAL] = "total",
+	[METRICS_STAGE_GLOBAL_RTT] = "rtt",
+	[METRICS_STAGE_GLOBAL_NET] = "rtt_net",
+	[METRICS_STAGE_GLOBAL_SERVER] = "rtt_srv",
+};
+
+const char *const metrics_counter_names[METRICS_NUM_COUNTERS] = {
+	[METRICS_FRAMES] = "frames",
+	[METRICS_DROPPED] = "dropped",
+	[METRICS_GLOBAL_ERRORS] = "global_errors",
+	[METRICS_TX_STATUS_ERRORS] = "tx_status_errors",
+	[METRICS_GLOBAL_UNSPLIT] = "rtt_unsplit",
+};
+
+static const char *const ac_names[IEEE80211_NUM_ACS] = {
+	[IEEE80211_AC_VO] = "VO",
+	[IEEE80211_AC_VI] = "VI",
+	[IEEE80211_AC_BE] = "BE",
+	[IEEE80211_AC_BK] = "BK",
+};
+
+static int bucket_index(u64 ns)
+{
+	int shift;
+
+	if (ns < METRICS_SUB_COUNT)
+		return ns;
+	if (ns >> METRICS_MAX_BITS)
+		return METRICS_HIST_BUCKETS - 1;
+	shift = 63 - __builtin_clzll(ns) - METRICS_SUB_BITS;
+	return ((shift + 1) << METRICS_SUB_BITS) +
+		(int)(ns >> shift) - METRICS_SUB_COUNT;
+}
+
+/* Largest value that falls into a bucket */
+static u64 bucket_upper(int index)
+{
+	int shift;
+
+	if (index < 2 * METRICS_SUB_COUNT)
+		return index;
+	shift = (index >> METRICS_SUB_BITS) - 1;
+	return (((u64)(METRICS_SUB_COUNT + (index & (METRICS_SUB_COUNT - 1)))
+		 << shift) | ((1ull << shift) - 1));
+}
+
+void metrics_count(enum metrics_counter counter)
+{
+	__atomic_fetch_add(&metrics.counters[counter], 1, __ATOMIC_RELAXED);
+}
+
+void metrics_record_frame(const u64 marks[METRICS_NUM_MARKS], int ac)
+{
+	int stage;
+
+	for (stage = 0; stage < METRICS_STAGE_TOTAL; stage++)
+		metrics_record(stage, ac, marks[stage + 1] - marks[stage]);
+	metrics_record(METRICS_STAGE_TOTAL, ac,
+		       marks[METRICS_NUM_MARKS - 1] - marks[0]);
+}
+
+u64 metrics_counter_value(enum metrics_counter counter)
+{
+	return __atomic_load_n(&metrics.counters[counter], __ATOMIC_RELAXED);
+}
+
+void metrics_record(enum metrics_stage stage, int ac, u64 ns)
+{
+	struct metrics_hist *hist = &metrics.hists[stage][ac];
+	u64 max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&hist->buckets[bucket_index(ns)], 1,
+			   __ATOMIC_RELAXED);
+	__atomic_fetch_add(&hist->sum, ns, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+	while (ns > max &&
+	       !__atomic_compare_exchange_n(&hist->max, &max, ns, true,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+void metrics_summarize(enum metrics_stage stage, int ac,
+		       struct metrics_summary *summary)
+{
+	static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	u64 *results[] = { &summary->p50, &summary->p90, &summary->p99,
+			   &summary->p999 };
+	u64 buckets[METRICS_HIST_BUCKETS] = { 0 }, seen = 0, max;
+	int first = ac, last = ac, a, i, q = 0;
+
+	if (ac == METRICS_ALL_ACS) {
+		first = 0;
+		last = IEEE80211_NUM_ACS - 1;
+	}
+
+	memset(summary, 0, sizeof(*summary));
+	for (a = first; a <= last; a++) {
+		struct metrics_hist *hist = &metrics.hists[stage][a];
+
+		for (i = 0; i < METRICS_HIST_BUCKETS; i++) {
+			u64 n = __atomic_load_n(&hist->buckets[i],
+						__ATOMIC_RELAXED);
+
+			buckets[i] += n;
+			/* the count as seen by the buckets, for the quantiles */
+			summary->count += n;
+		}
+		summary->sum += __atomic_load_n(&hist->sum, __ATOMIC_RELAXED);
+		max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+		if (max > summary->max)
+			summary->max = max;
+	}
+
+	for (i = 0; i < METRICS_HIST_BUCKETS && q < 4; i++) {
+		seen += buckets[i];
+		while (q < 4 && buckets[i] &&
+		       seen >= quantiles[q] * summary->count) {
+			*results[q] = bucket_upper(i) < summary->max ?
+				bucket_upper(i) : summary->max;
+			q++;
+		}
+	}
+}
+
+static void log_summary(struct wmediumd *ctx, const char *stage,
+			const char *ac, const struct metrics_summary *s)
+{
+	w_logf(ctx, LOG_NOTICE, "  %-9s %-3s %10llu frames, mean %llu ns, "
+	       "p50 %llu, p90 %llu, p99 %llu, p99.9 %llu, max %llu ns\n",
+	       stage, ac, (unsigned long long)s->count,
+	       (unsigned long long)(s->count ? s->sum / s->count : 0),
+	       (unsigned long long)s->p50, (unsigned long long)s->p90,
+	       (unsigned long long)s->p99, (unsigned long long)s->p999,
+	       (unsigned long long)s->max);
+}
+
+void metrics_dump(struct wmediumd *ctx)
+{
+	struct metrics_summary summary;
+	int stage, ac, i;
+
+	w_logf(ctx, LOG_NOTICE, "Frame path metrics:\n");
+	for (i = 0; i < METRICS_NUM_COUNTERS; i++)
+		w_logf(ctx, LOG_NOTICE, "  %-16s %llu\n",
+		       metrics_counter_names[i],
+		       (unsigned long long)metrics_counter_value(i));
+
+	for (stage = 0; stage < METRICS_NUM_STAGES; stage++) {
+		metrics_summarize(stage, METRICS_ALL_ACS, &summary);
+		log_summary(ctx, metrics_stage_names[stage], "all", &summary);
+		for (ac = 0; ac < IEEE80211_NUM_ACS; ac++) {
+			metrics_summarize(stage, ac, &summary);
+			if (summary.count)
+				log_summary(ctx, metrics_stage_names[stage],
+					    ac_names[ac], &summary);
+		}
+	}
+}
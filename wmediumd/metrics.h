@@ -0,0 +1,120 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Frame path counters and latency histograms
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <time.h>
+#include "wmediumd.h"
+
+/*
+ * Stages of a frame, each measured from the end of the previous one:
+ * netlink receive -> parsed -> sent to the global medium -> reply
+ * received -> tx status sent to the kernel.  TOTAL spans all of them.
+ */
+enum metrics_stage {
+	METRICS_STAGE_PARSE,
+	METRICS_STAGE_SEND,
+	METRICS_STAGE_GLOBAL,
+	METRICS_STAGE_TX_STATUS,
+	METRICS_STAGE_TOTAL,
+	/* the global stage split by kernel timestamps, see global_rtt.h */
+	METRICS_STAGE_GLOBAL_RTT,
+	METRICS_STAGE_GLOBAL_NET,
+	METRICS_STAGE_GLOBAL_SERVER,
+	METRICS_NUM_STAGES,
+};
+
+/* Points in the life of a frame, the stages lie between them */
+enum metrics_mark {
+	METRICS_MARK_RECEIVED,
+	METRICS_MARK_PARSED,
+	METRICS_MARK_SENT,
+	METRICS_MARK_REPLIED,
+	METRICS_MARK_STATUS_SENT,
+	METRICS_NUM_MARKS,
+};
+
+enum metrics_counter {
+	METRICS_FRAMES,			/* received from the kernel */
+	METRICS_DROPPED,		/* unknown sender or no memory */
+	METRICS_GLOBAL_ERRORS,		/* exchange with the global medium failed */
+	METRICS_TX_STATUS_ERRORS,	/* tx status not sent to the kernel */
+	METRICS_GLOBAL_UNSPLIT,		/* round trips without a network/server split */
+	METRICS_NUM_COUNTERS,
+};
+
+/* Merge the access categories of a stage */
+#define METRICS_ALL_ACS		IEEE80211_NUM_ACS
+
+/*
+ * Log-linear buckets: values below 2^METRICS_SUB_BITS are exact, above
+ * that every power of two is split into 2^METRICS_SUB_BITS buckets, so a
+ * value is known within 1/16 of itself.  Values from 2^METRICS_MAX_BITS
+ * ns (about 18 minutes) on share the last bucket.
+ */
+#define METRICS_SUB_BITS	4
+#define METRICS_MAX_BITS	40
+#define METRICS_HIST_BUCKETS	\
+	((METRICS_MAX_BITS - METRICS_SUB_BITS + 1) << METRICS_SUB_BITS)
+
+struct metrics_summary {
+	u64 count;
+	u64 sum;			/* [ns] */
+	u64 max;			/* [ns] */
+	u64 p50, p90, p99, p999;	/* [ns], upper bounds of their buckets */
+};
+
+extern const char *const metrics_stage_names[METRICS_NUM_STAGES];
+extern const char *const metrics_counter_names[METRICS_NUM_COUNTERS];
+
+/* Timestamp for the stage boundaries */
+static inline u64 metrics_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (u64)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/* Count an event */
+void metrics_count(enum metrics_counter counter);
+
+/* Add the duration of a stage, ac is an enum ieee80211_ac_number */
+void metrics_record(enum metrics_stage stage, int ac, u64 ns);
+
+/* Add all stages of a frame from its marks */
+void metrics_record_frame(const u64 marks[METRICS_NUM_MARKS], int ac);
+
+/* Current value of a counter */
+u64 metrics_counter_value(enum metrics_counter counter);
+
+/*
+ * Summarize a histogram
+ * @param ac An enum ieee80211_ac_number or METRICS_ALL_ACS
+ */
+void metrics_summarize(enum metrics_stage stage, int ac,
+		       struct metrics_summary *summary);
+
+/* Log all counters and the stage latencies, e.g. on SIGUSR1 */
+void metrics_dump(struct wmediumd *ctx);
+
+#endif /* METRICS_H_ */
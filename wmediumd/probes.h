@@ -0,0 +1,59 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Static tracepoints (USDT) for perf, bpftrace and SystemTap
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef PROBES_H_
+#define PROBES_H_
+
+/*
+ * Probes of the provider "wmediumd", e.g.
+ *   bpftrace -e 'usdt:./wmediumd:wmediumd:global_recv { @[arg1] = count(); }'
+ *
+ * nl_receive(cmd, len)			netlink message from the kernel
+ * frame_parse(cookie, sender, len)	frame parsed, sender is the station index
+ * global_send(cookie, sender, len)	request sent to the global medium
+ * global_recv(cookie, flags, signal)	reply of the global medium received
+ * tx_status_send(cookie, flags, ret)	tx status handed to the kernel
+ * recompute_start(stations, changed)	link recomputation for changed stations
+ * recompute_end(stations, changed)
+ * request_start(type, len)		wserver request of a client
+ * request_done(type, action)		... handled, action is a WACTION_*
+ *
+ * With <sys/sdt.h> a disabled probe is a single nop.  Without it, or with
+ * make NO_PROBES=1, the probes compile to nothing.
+ */
+#if !defined(WMEDIUMD_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define WMEDIUMD_HAVE_PROBES
+#endif
+#endif
+
+#ifdef WMEDIUMD_HAVE_PROBES
+#define WMEDIUMD_PROBE2(name, a, b) \
+	DTRACE_PROBE2(wmediumd, name, a, b)
+#define WMEDIUMD_PROBE3(name, a, b, c) \
+	DTRACE_PROBE3(wmediumd, name, a, b, c)
+#else
+#define WMEDIUMD_PROBE2(name, a, b) do { } while (0)
+#define WMEDIUMD_PROBE3(name, a, b, c) do { } while (0)
+#endif
+
+#endif /* PROBES_H_ */
@@ -0,0 +1,200 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Epoch-based reclamation for lock-free readers
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rcu.h"
+
+struct rcu_reader {
+	uint64_t epoch;		/* epoch seen on entry, 0 when outside */
+	int in_use;
+} __attribute__((aligned(64)));
+
+struct rcu_retired {
+	struct rcu_retired *next;
+	void *ptr;
+	void (*free_fn)(void *);
+	uint64_t epoch;
+};
+
+static uint64_t global_epoch = 1;
+static struct rcu_reader readers[RCU_MAX_READERS];
+static __thread struct rcu_reader *self;
+
+static pthread_mutex_t retire_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rcu_retired *retired;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t reader_key;
+
+static void release_reader(void *arg)
+{
+	struct rcu_reader *reader = arg;
+
+	__atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&reader->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void make_key(void)
+{
+	pthread_key_create(&reader_key, release_reader);
+}
+
+static struct rcu_reader *register_reader(void)
+{
+	int i, expected;
+
+	pthread_once(&key_once, make_key);
+
+	for (;;) {
+		for (i = 0; i < RCU_MAX_READERS; i++) {
+			expected = 0;
+			if (__atomic_compare_exchange_n(&readers[i].in_use,
+							&expected, 1, false,
+							__ATOMIC_ACQ_REL,
+							__ATOMIC_RELAXED)) {
+				pthread_setspecific(reader_key, &readers[i]);
+				return &readers[i];
+			}
+		}
+		/* more concurrent readers than slots: wait for one to exit */
+		sched_yield();
+	}
+}
+
+void rcu_read_lock(void)
+{
+	if (!self)
+		self = register_reader();
+
+	/*
+	 * The store of the epoch must be visible before any load of a shared
+	 * pointer, see the pairing comment in rcu_reclaim().
+	 */
+	__atomic_store_n(&self->epoch,
+			 __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST),
+			 __ATOMIC_SEQ_CST);
+}
+
+void rcu_read_unlock(void)
+{
+	__atomic_store_n(&self->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* Oldest epoch still observed by a reader, or the current epoch */
+static uint64_t oldest_reader_epoch(uint64_t current)
+{
+	uint64_t oldest = current, epoch;
+	int i;
+
+	for (i = 0; i < RCU_MAX_READERS; i++) {
+		epoch = __atomic_load_n(&readers[i].epoch, __ATOMIC_SEQ_CST);
+		if (epoch && epoch < oldest)
+			oldest = epoch;
+	}
+	return oldest;
+}
+
+void rcu_reclaim(void)
+{
+	struct rcu_retired **pos, *entry, *done = NULL;
+	uint64_t current, oldest;
+
+	pthread_mutex_lock(&retire_lock);
+
+	/*
+	 * An object retired in epoch E was unlinked before the epoch moved
+	 * past E.  A reader that entered with an epoch > E therefore loaded
+	 * the pointer after the unlink and cannot see the object, and a
+	 * reader that entered with epoch <= E is still visible in its slot
+	 * (both sides use sequentially consistent accesses).
+	 */
+	current = __atomic_add_fetch(&global_epoch, 1, __ATOMIC_SEQ_CST);
+	oldest = oldest_reader_epoch(current);
+
+	pos = &retired;
+	while ((entry = *pos)) {
+		if (entry->epoch < oldest) {
+			*pos = entry->next;
+			entry->next = done;
+			done = entry;
+		} else {
+			pos = &entry->next;
+		}
+	}
+	pthread_mutex_unlock(&retire_lock);
+
+	while ((entry = done)) {
+		done = entry->next;
+		entry->free_fn(entry->ptr);
+		free(entry);
+	}
+}
+
+void rcu_retire(void *ptr, void (*free_fn)(void *))
+{
+	struct rcu_retired *entry;
+
+	if (!ptr)
+		return;
+
+	entry = malloc(sizeof(*entry));
+	if (!entry) {
+		/* cannot defer: wait for the readers instead */
+		rcu_barrier();
+		free_fn(ptr);
+		return;
+	}
+	entry->ptr = ptr;
+	entry->free_fn = free_fn;
+
+	pthread_mutex_lock(&retire_lock);
+	entry->epoch = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+	entry->next = retired;
+	retired = entry;
+	pthread_mutex_unlock(&retire_lock);
+
+	rcu_reclaim();
+}
+
+void rcu_barrier(void)
+{
+	uint64_t target;
+	int i;
+
+	target = __atomic_add_fetch(&global_epoch, 1, __ATOMIC_SEQ_CST);
+	for (i = 0; i < RCU_MAX_READERS; i++) {
+		while (1) {
+			uint64_t epoch = __atomic_load_n(&readers[i].epoch,
+							 __ATOMIC_SEQ_CST);
+			if (!epoch || epoch >= target)
+				break;
+			sched_yield();
+		}
+	}
+	rcu_reclaim();
+}
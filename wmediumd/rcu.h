@@ -0,0 +1,63 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Epoch-based reclamation for lock-free readers
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+
+#ifndef RCU_H_
+#define RCU_H_
+
+#define RCU_MAX_READERS		64
+
+/*
+ * Minimal read-copy-update with epoch-based reclamation.
+ *
+ * Readers bracket their accesses to shared objects with rcu_read_lock()
+ * and rcu_read_unlock(); they never block and never write shared memory
+ * other than their own reader slot.  Writers replace an object by
+ * publishing a new pointer and hand the old one to rcu_retire(), which
+ * frees it once every reader that could still see it has left its
+ * critical section.  Read sections do not nest.
+ */
+
+/*
+ * Enter a read-side critical section.  The calling thread is registered
+ * on first use and unregistered when it exits.
+ */
+void rcu_read_lock(void);
+
+/* Leave the read-side critical section */
+void rcu_read_unlock(void);
+
+/*
+ * Free @ptr with @free_fn once no reader can reference it anymore.
+ * @ptr must already be unreachable for new readers.
+ */
+void rcu_retire(void *ptr, void (*free_fn)(void *));
+
+/* Free whatever retired objects are no longer referenced */
+void rcu_reclaim(void);
+
+/*
+ * Wait until all current readers have left their critical sections and
+ * free everything retired so far.  Must not be called from a read section.
+ */
+void rcu_barrier(void);
+
+#endif /* RCU_H_ */
@@ -0,0 +1,146 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Flight recorder of the latest frames
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include "recorder.h"
+
+#define RECORDER_WORDS	(sizeof(struct recorder_event) / sizeof(u64))
+
+_Static_assert(sizeof(struct recorder_event) % sizeof(u64) == 0,
+	       "events are copied in words");
+
+/*
+ * seq is 2n + 1 while the n-th event is written and 2n + 2 once it is
+ * complete.  Readers skip slots that change while they copy them.
+ */
+struct recorder_slot {
+	u64 seq;
+	union {
+		struct recorder_event event;
+		u64 words[RECORDER_WORDS];
+	};
+};
+
+static struct recorder_slot slots[RECORDER_SIZE];
+static u64 recorded;
+
+const char *const recorder_outcome_names[RECORDER_NUM_OUTCOMES] = {
+	[RECORDER_ACKED] = "acked",
+	[RECORDER_NOT_ACKED] = "not_acked",
+	[RECORDER_NO_SENDER] = "no_sender",
+	[RECORDER_GLOBAL_ERROR] = "global_error",
+	[RECORDER_TX_STATUS_ERROR] = "tx_status_error",
+};
+
+void recorder_record(const struct recorder_event *event)
+{
+	const u64 *words = (const u64 *)event;
+	u64 n = recorded;
+	struct recorder_slot *slot = &slots[n & (RECORDER_SIZE - 1)];
+	size_t i;
+
+	__atomic_store_n(&slot->seq, 2 * n + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	for (i = 0; i < RECORDER_WORDS; i++)
+		__atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->seq, 2 * n + 2, __ATOMIC_RELEASE);
+	__atomic_store_n(&recorded, n + 1, __ATOMIC_RELEASE);
+}
+
+int recorder_snapshot(struct recorder_event *events, int max, u64 *total)
+{
+	u64 end = __atomic_load_n(&recorded, __ATOMIC_ACQUIRE), n, seq;
+	u64 start = end > RECORDER_SIZE ? end - RECORDER_SIZE : 0;
+	struct recorder_slot *slot;
+	u64 *words;
+	int count = 0;
+	size_t i;
+
+	if (max >= 0 && end - start > (u64)max)
+		start = end - max;
+	for (n = start; n < end; n++) {
+		slot = &slots[n & (RECORDER_SIZE - 1)];
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if (seq != 2 * n + 2)
+			continue;
+		words = (u64 *)&events[count];
+		for (i = 0; i < RECORDER_WORDS; i++)
+			words[i] = __atomic_load_n(&slot->words[i],
+						   __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+			count++;
+	}
+	*total = end;
+	return count;
+}
+
+static u64 since(const struct recorder_event *event, int mark)
+{
+	if (!event->marks[mark] || event->marks[mark] < event->marks[0])
+		return 0;
+	return event->marks[mark] - event->marks[0];
+}
+
+int recorder_dump(const char *path)
+{
+	struct recorder_event *events, *e;
+	u64 total;
+	FILE *file;
+	int num, i, ret = 0;
+
+	events = malloc(sizeof(*events) * RECORDER_SIZE);
+	if (!events)
+		return -ENOMEM;
+	file = fopen(path, "w");
+	if (!file) {
+		ret = -errno;
+		goto out;
+	}
+
+	num = recorder_snapshot(events, RECORDER_SIZE, &total);
+	fprintf(file, "# %d of %llu frames, times in ns since received\n"
+		"# received cookie sender receiver freq signal rate_idx "
+		"attempts ac flags len outcome parsed sent replied status_sent\n",
+		num, (unsigned long long)total);
+	for (i = 0; i < num; i++) {
+		e = &events[i];
+		fprintf(file, "%llu %llu " MAC_FMT " " MAC_FMT " %u %d %d %u "
+			"%u 0x%x %u %s %llu %llu %llu %llu\n",
+			(unsigned long long)e->marks[METRICS_MARK_RECEIVED],
+			(unsigned long long)e->cookie, MAC_ARGS(e->sender),
+			MAC_ARGS(e->receiver), e->freq, e->signal, e->rate_idx,
+			e->attempts, e->ac, e->flags, e->data_len,
+			e->outcome < RECORDER_NUM_OUTCOMES ?
+			recorder_outcome_names[e->outcome] : "?",
+			(unsigned long long)since(e, METRICS_MARK_PARSED),
+			(unsigned long long)since(e, METRICS_MARK_SENT),
+			(unsigned long long)since(e, METRICS_MARK_REPLIED),
+			(unsigned long long)since(e, METRICS_MARK_STATUS_SENT));
+	}
+	if (fclose(file))
+		ret = -errno;
+out:
+	free(events);
+	return ret;
+}
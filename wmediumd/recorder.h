@@ -0,0 +1,79 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Flight recorder of the latest frames
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include "wmediumd.h"
+#include "metrics.h"
+
+/* Frames kept, a power of two */
+#define RECORDER_SIZE		4096
+
+/* Where SIGUSR2 dumps the recorder, %d is the pid */
+#define RECORDER_DUMP_PATH	"/tmp/wmediumd-recorder-%d.txt"
+
+enum recorder_outcome {
+	RECORDER_ACKED,
+	RECORDER_NOT_ACKED,
+	RECORDER_NO_SENDER,		/* dropped, sender unknown */
+	RECORDER_GLOBAL_ERROR,		/* no reply from the global medium */
+	RECORDER_TX_STATUS_ERROR,	/* tx status not sent to the kernel */
+	RECORDER_NUM_OUTCOMES,
+};
+
+/* What happened to one frame, fields the frame did not get to are 0 */
+struct recorder_event {
+	u64 cookie;
+	u64 marks[METRICS_NUM_MARKS];	/* [ns], see enum metrics_mark */
+	u8 sender[ETH_ALEN];
+	u8 receiver[ETH_ALEN];		/* addr1 of the frame */
+	u32 freq;
+	int32_t signal;			/* [dBm], as reported by the medium */
+	u32 flags;			/* HWSIM_TX_* */
+	u16 data_len;
+	int8_t rate_idx;		/* of the last attempt */
+	u8 attempts;
+	u8 ac;
+	u8 outcome;			/* enum recorder_outcome */
+	u8 pad[2];
+};
+
+extern const char *const recorder_outcome_names[RECORDER_NUM_OUTCOMES];
+
+/* Remember a frame, from the frame path only */
+void recorder_record(const struct recorder_event *event);
+
+/*
+ * Copy the latest events, oldest first.  Events overwritten while they
+ * are copied are left out.
+ * @param total Receives the number of events recorded so far
+ * @return The number of events copied, at most max
+ */
+int recorder_snapshot(struct recorder_event *events, int max, u64 *total);
+
+/*
+ * Write the recorder as text to path
+ * @return 0 on success, otherwise a negative errno value
+ */
+int recorder_dump(const char *path);
+
+#endif /* RECORDER_H_ */
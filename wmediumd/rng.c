@@ -0,0 +1,99 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Counter-based random numbers for per-link decisions
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include "rng.h"
+
+static u64 mac_to_u64(const u8 *addr)
+{
+	u64 v = 0;
+	int i;
+
+	if (!addr)
+		return 0xffffffffffffULL;
+
+	for (i = 0; i < ETH_ALEN; i++)
+		v = (v << 8) | addr[i];
+	return v;
+}
+
+/* splitmix64 finalizer, used to spread the link identity over the key */
+static u64 mix64(u64 z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+void rng_link_block(u64 seed, const u8 *src, const u8 *dst, u64 counter,
+		    u32 stream, u32 block, u32 out[4])
+{
+	u64 key;
+	u32 k[2], c[4];
+
+	/*
+	 * Stations are identified by their MAC address rather than by their
+	 * index, so adding or removing other stations never changes the
+	 * sequence of a link.
+	 */
+	key = mix64(seed ^ mix64(mac_to_u64(src) ^
+				 (mac_to_u64(dst) << 16 | mac_to_u64(dst) >> 48)));
+	k[0] = (u32)key;
+	k[1] = (u32)(key >> 32);
+
+	c[0] = (u32)counter;
+	c[1] = (u32)(counter >> 32);
+	c[2] = stream;
+	c[3] = block;
+
+	philox4x32(c, k, out);
+}
+
+double link_random(struct wmediumd *ctx, const struct station *src,
+		   const struct station *dst, u64 counter, u32 stream)
+{
+	u32 out[4];
+
+	rng_link_block(ctx->rng_seed, src ? src->addr : NULL,
+		       dst ? dst->addr : NULL, counter, stream, 0, out);
+
+	/* 53 significant bits, like drand48() callers expect */
+	return ((u64)(out[0] >> 5) * 67108864.0 + (out[1] >> 6)) *
+		(1.0 / 9007199254740992.0);
+}
+
+double link_random_normal(struct wmediumd *ctx, const struct station *src,
+			  const struct station *dst, u64 counter, u32 stream)
+{
+	double normal = -6.0;
+	u32 out[4];
+	u32 block;
+	int i;
+
+	for (block = 0; block < 3; block++) {
+		rng_link_block(ctx->rng_seed, src ? src->addr : NULL,
+			       dst ? dst->addr : NULL, counter, stream,
+			       block, out);
+		for (i = 0; i < 4; i++)
+			normal += rng_u32_to_double(out[i]);
+	}
+
+	return normal;
+}
@@ -0,0 +1,103 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Counter-based random numbers for per-link decisions
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef RNG_H_
+#define RNG_H_
+
+#include "wmediumd.h"
+
+/*
+ * Independent random streams of a link.  Each kind of decision draws
+ * from its own stream so that adding a new consumer never shifts the
+ * values seen by an existing one.  Loss is decided by the global medium,
+ * stream 0 stays free for it so that the others keep their values.
+ */
+enum rng_stream {
+	RNG_STREAM_FADING = 1,
+	RNG_STREAM_TOPOLOGY,
+};
+
+#define PHILOX_M0	0xD2511F53u
+#define PHILOX_M1	0xCD9E8D57u
+#define PHILOX_W0	0x9E3779B9u
+#define PHILOX_W1	0xBB67AE85u
+#define PHILOX_ROUNDS	10
+
+/*
+ * Philox4x32-10 block function (Salmon et al., "Parallel random numbers:
+ * as easy as 1, 2, 3", SC'11).  The output is a pure function of the
+ * counter and the key, so it can be evaluated on any thread in any order.
+ */
+static inline void philox4x32(const u32 ctr_in[4], const u32 key_in[2],
+			      u32 out[4])
+{
+	u32 c0 = ctr_in[0], c1 = ctr_in[1], c2 = ctr_in[2], c3 = ctr_in[3];
+	u32 k0 = key_in[0], k1 = key_in[1];
+	int i;
+
+	for (i = 0; i < PHILOX_ROUNDS; i++) {
+		u64 p0 = (u64)PHILOX_M0 * c0;
+		u64 p1 = (u64)PHILOX_M1 * c2;
+
+		c0 = (u32)(p1 >> 32) ^ c1 ^ k0;
+		c1 = (u32)p1;
+		c2 = (u32)(p0 >> 32) ^ c3 ^ k1;
+		c3 = (u32)p0;
+
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+/* Map a 32 bit random value to [0, 1) */
+static inline double rng_u32_to_double(u32 v)
+{
+	return v * (1.0 / 4294967296.0);
+}
+
+/*
+ * Fill @out with four random words for the given link and counter.
+ * @seed is the experiment seed, @src/@dst the MAC addresses of the link,
+ * @counter typically the frame cookie, @stream an enum rng_stream and
+ * @block selects further words for the same decision.
+ */
+void rng_link_block(u64 seed, const u8 *src, const u8 *dst, u64 counter,
+		    u32 stream, u32 block, u32 out[4]);
+
+/*
+ * Uniform random value in [0, 1) for one decision on the link src->dst.
+ */
+double link_random(struct wmediumd *ctx, const struct station *src,
+		   const struct station *dst, u64 counter, u32 stream);
+
+/*
+ * Approximately standard normal random value (sum of twelve uniforms)
+ * for one decision on the link src->dst.
+ */
+double link_random_normal(struct wmediumd *ctx, const struct station *src,
+			  const struct station *dst, u64 counter, u32 stream);
+
+#endif /* RNG_H_ */
@@ -38,6 +38,16 @@
 #include "wserver.h"
 #include "wmediumd_dynamic.h"
 #include "wserver_messages.h"
+#include "wmsnap.h"
+#include "link_state.h"
+#include "link_export.h"
+#include "link_stats.h"
+#include "metrics.h"
+#include "global_rtt.h"
+#include "log_ring.h"
+#include "capture.h"
+#include "recorder.h"
+#include "probes.h"
 
 #include <string.h>	//strlen
 #include <sys/socket.h>	//socket
@@ -48,6 +58,7 @@
 #include <unistd.h>
 
 int socket_to_global = 0;
+static struct global_rtt global_rtt;
 struct wmediumd *ctx_to_pass;
 
 static inline int div_round(int a, int b)
@@ -61,24 +72,67 @@ static inline int pkt_duration(struct wmediumd *ctx, int len, int rate)
 	return 16 + 4 + 4 * div_round((16 + 8 * len + 6) * 10, 4 * rate);
 }
 
-int w_logf(struct wmediumd *ctx, u8 level, const char *format, ...)
+/*
+ * Count a frame whose transmit status came back, on the link to its
+ * receiver address.
+ */
+static void count_frame(struct wmediumd *ctx, struct frame *frame)
 {
-	va_list(args);
-	va_start(args, format);
-	if (ctx->log_lvl >= level) {
-		return vprintf(format, args);
+	struct ieee80211_hdr *hdr = (struct ieee80211_hdr *)frame->data;
+	int i, attempts = 0, airtime = 0;
+
+	for (i = 0; i < frame->tx_rates_count && frame->tx_rates[i].idx >= 0;
+	     i++) {
+		int rate = index_to_rate(frame->tx_rates[i].idx, frame->freq);
+
+		attempts += frame->tx_rates[i].count;
+		airtime += frame->tx_rates[i].count *
+			   pkt_duration(ctx, frame->data_len, rate);
 	}
-	return -1;
+	link_stats_record(frame->sender->addr, hdr->addr1, frame->data_len,
+			  frame->flags & HWSIM_TX_STAT_ACK, attempts, airtime);
 }
 
-int w_flogf(struct wmediumd *ctx, u8 level, FILE *stream, const char *format, ...)
+int w_log_print(FILE *stream, const char *format, ...)
 {
 	va_list(args);
+	int ret;
 	va_start(args, format);
-	if (ctx->log_lvl >= level) {
-		return vfprintf(stream, format, args);
+	ret = log_ring_vlog(stream, format, args);
+	if (ret)
+		ret = vfprintf(stream, format, args);
+	va_end(args);
+	return ret;
+}
+
+bool w_ratelimit(struct wmediumd *ctx, struct w_ratelimit *rl,
+		 const char *func)
+{
+	struct timespec ts;
+	u64 now, begin;
+	u32 suppressed;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+	now = (u64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000 + 1;
+	begin = __atomic_load_n(&rl->begin, __ATOMIC_RELAXED);
+	/* one of the threads hitting the site at the same time starts the interval */
+	if ((!begin || now - begin >= W_LOG_RATELIMIT_INTERVAL) &&
+	    __atomic_compare_exchange_n(&rl->begin, &begin, now, false,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		suppressed = __atomic_exchange_n(&rl->suppressed, 0,
+						 __ATOMIC_RELAXED);
+		__atomic_store_n(&rl->printed, 0, __ATOMIC_RELAXED);
+		if (suppressed)
+			w_flogf(ctx, LOG_WARNING, stderr,
+				"%s: %u messages suppressed\n", func,
+				suppressed);
 	}
-	return -1;
+
+	if (__atomic_fetch_add(&rl->printed, 1, __ATOMIC_RELAXED) <
+	    W_LOG_RATELIMIT_BURST)
+		return true;
+	__atomic_fetch_add(&rl->suppressed, 1, __ATOMIC_RELAXED);
+	return false;
 }
 
 static void wqueue_init(struct wqueue *wqueue, int cw_min, int cw_max)
@@ -189,20 +243,49 @@ static inline u8 *frame_get_qos_ctl(struct frame *frame)
 		return (u8 *)hdr + 24;
 }
 
-bool is_multicast_ether_addr(const u8 *addr)
+/* Access category the sender would have queued the frame on */
+static int frame_ac(struct frame *frame)
 {
-	return 0x01 & addr[0];
+	if (frame_is_mgmt(frame))
+		return IEEE80211_AC_VO;
+	if (frame_is_data_qos(frame))
+		return ieee802_1d_to_ac[*frame_get_qos_ctl(frame) & 7];
+	return IEEE80211_AC_BE;
 }
 
-static struct station *get_station_by_addr(struct wmediumd *ctx, u8 *addr)
+/* Keep what happened to a frame in the flight recorder */
+static void record_frame(struct frame *frame, const u64 *marks,
+			 enum recorder_outcome outcome)
 {
-	struct station *station;
+	struct ieee80211_hdr *hdr = (struct ieee80211_hdr *)frame->data;
+	struct recorder_event event = { 0 };
+	int i;
 
-	list_for_each_entry(station, &ctx->stations, list) {
-		if (memcmp(station->addr, addr, ETH_ALEN) == 0)
-			return station;
+	event.cookie = frame->cookie;
+	memcpy(event.marks, marks, sizeof(event.marks));
+	memcpy(event.sender, frame->sender->addr, ETH_ALEN);
+	memcpy(event.receiver, hdr->addr1, ETH_ALEN);
+	event.freq = frame->freq;
+	event.flags = frame->flags;
+	event.data_len = frame->data_len;
+	event.ac = frame_ac(frame);
+	event.outcome = outcome;
+	event.rate_idx = -1;
+	/* the signal and the attempts come with the reply */
+	if (outcome != RECORDER_GLOBAL_ERROR) {
+		event.signal = frame->signal;
+		for (i = 0; i < frame->tx_rates_count &&
+		     frame->tx_rates[i].idx >= 0; i++) {
+			event.rate_idx = frame->tx_rates[i].idx;
+			event.attempts += frame->tx_rates[i].count;
+		}
 	}
-	return NULL;
+	recorder_record(&event);
+}
+
+bool is_multicast_ether_addr(const u8 *addr)
+{
+	return 0x01 & addr[0];
 }
 
 void detect_mediums(struct wmediumd *ctx, struct station *src, struct station *dest) {
@@ -247,14 +330,14 @@ static int send_tx_info_frame_nl(struct wmediumd *ctx, struct frame *frame)
 	int ret;
 	msg = nlmsg_alloc();
 	if (!msg) {
-		w_logf(ctx, LOG_ERR, "Error allocating new message MSG!\n");
+		w_logf_ratelimited(ctx, LOG_ERR, "Error allocating new message MSG!\n");
 		return -1;
 	}
 
 	if (genlmsg_put(msg, NL_AUTO_PID, NL_AUTO_SEQ, ctx->family_id,
 			0, NLM_F_REQUEST, HWSIM_CMD_TX_INFO_FRAME,
 			VERSION_NR) == NULL) {
-		w_logf(ctx, LOG_ERR, "%s: genlmsg_put failed\n", __func__);
+		w_logf_ratelimited(ctx, LOG_ERR, "%s: genlmsg_put failed\n", __func__);
 		ret = -1;
 		goto out;
 	}
@@ -267,14 +350,14 @@ static int send_tx_info_frame_nl(struct wmediumd *ctx, struct frame *frame)
 		    frame->tx_rates_count * sizeof(struct hwsim_tx_rate),
 		    frame->tx_rates) ||
 	    nla_put_u64(msg, HWSIM_ATTR_COOKIE, frame->cookie)) {
-			w_logf(ctx, LOG_ERR, "%s: Failed to fill a payload\n", __func__);
+			w_logf_ratelimited(ctx, LOG_ERR, "%s: Failed to fill a payload\n", __func__);
 			ret = -1;
 			goto out;
 	}
 
 	ret = nl_send_auto_complete(sock, msg);
 	if (ret < 0) {
-		w_logf(ctx, LOG_ERR, "%s: nl_send_auto failed\n", __func__);
+		w_logf_ratelimited(ctx, LOG_ERR, "%s: nl_send_auto failed\n", __func__);
 		ret = -1;
 		goto out;
 	}
@@ -322,20 +405,27 @@ int send_to_global(int sock_w, mystruct_nlmsg *tosend)
 		puts("TCP send failed");
 		return 1;
 	}
+	global_rtt_sent(&global_rtt, tosend->cookie_t, sizeof(mystruct_nlmsg));
 		
 	return 0;
 }
 
-int recv_from_global(int sock_w, struct wmediumd *ctx, struct frame *frame)
+int recv_from_global(int sock_w, struct wmediumd *ctx, struct frame *frame,
+		     u64 *marks)
 {
 	mystruct_frame server_reply;
 	mystruct_frame *torecv;
 	torecv = &server_reply;
+	u64 rx_time;
+	enum recorder_outcome outcome;
+	int ret;
 	
 	//Receive a reply from the server
-	if(recv(sock_w, torecv, sizeof(mystruct_frame), 0)< 0)
+	if(global_rtt_recv(&global_rtt, torecv, sizeof(mystruct_frame), &rx_time)< 0)
 	{
 		puts("TCP recv failed");
+		metrics_count(METRICS_GLOBAL_ERRORS);
+		record_frame(frame, marks, RECORDER_GLOBAL_ERROR);
 		return 1;
 	}
 	else
@@ -346,7 +436,26 @@ int recv_from_global(int sock_w, struct wmediumd *ctx, struct frame *frame)
 		memcpy(frame->tx_rates, server_reply.tx_rates_tosend, sizeof(server_reply.tx_rates_tosend));
 		frame->signal = server_reply.signal_tosend;
 		
-		send_tx_info_frame_nl(ctx, frame);
+		marks[METRICS_MARK_REPLIED] = metrics_now();
+		WMEDIUMD_PROBE3(global_recv, frame->cookie, frame->flags,
+				frame->signal);
+		global_rtt_replied(ctx, &global_rtt, frame->cookie, rx_time,
+				   frame_ac(frame));
+		count_frame(ctx, frame);
+		if (ctx->capture)
+			capture_frame(ctx->capture, frame);
+		ret = send_tx_info_frame_nl(ctx, frame);
+		WMEDIUMD_PROBE3(tx_status_send, frame->cookie, frame->flags, ret);
+		if (ret) {
+			metrics_count(METRICS_TX_STATUS_ERRORS);
+			outcome = RECORDER_TX_STATUS_ERROR;
+		} else {
+			outcome = frame->flags & HWSIM_TX_STAT_ACK ?
+				RECORDER_ACKED : RECORDER_NOT_ACKED;
+		}
+		marks[METRICS_MARK_STATUS_SENT] = metrics_now();
+		metrics_record_frame(marks, frame_ac(frame));
+		record_frame(frame, marks, outcome);
 		free(frame);
 	}
 	
@@ -370,15 +479,26 @@ static int process_messages_cb(struct nl_msg *msg, void *arg)
 	mystruct_nlmsg* tosend;
     	tosend = &message;
 	
+	u64 marks[METRICS_NUM_MARKS] = { 0 };
+	const struct link_state *ls;
+	const struct link_state_station *entry;
 	struct station *sender;
 	struct frame *frame;
 	struct ieee80211_hdr *hdr;
 	u8 *src;
 	int sock_w = socket_to_global;
 
+	WMEDIUMD_PROBE2(nl_receive, gnlh->cmd, nlh->nlmsg_len);
 	if (gnlh->cmd == HWSIM_CMD_FRAME) {
-		
-		pthread_rwlock_rdlock(&snr_lock);
+		marks[METRICS_MARK_RECEIVED] = metrics_now();
+		metrics_count(METRICS_FRAMES);
+
+		/*
+		 * The frame path works on the published link state and only
+		 * waits for the control plane holding snr_lock when a sender
+		 * changes its hwaddr or frequency.
+		 */
+		ls = link_state_acquire(ctx);
 		/* we get the attributes*/
 		genlmsg_parse(nlh, 0, attrs, HWSIM_ATTR_MAX, NULL);
 		
@@ -402,19 +522,46 @@ static int process_messages_cb(struct nl_msg *msg, void *arg)
 			hdr = (struct ieee80211_hdr *)data;
 
 			if (data_len < 6 + 6 + 4)
-				goto out;
+				goto drop;
 			frame = malloc(sizeof(*frame) + data_len);
 			
 			src = hdr->addr2; 
-			sender = get_station_by_addr(ctx, src);
+			entry = link_state_find(ls, src);
+			sender = entry ? entry->station : NULL;
 			if (!sender) {
-				w_flogf(ctx, LOG_ERR, stderr, "Unable to find sender station " MAC_FMT "\n", MAC_ARGS(src));
-				goto out;
+				struct recorder_event event = {
+					.cookie = cookie,
+					.marks[METRICS_MARK_RECEIVED] =
+						marks[METRICS_MARK_RECEIVED],
+					.freq = freq,
+					.flags = flags,
+					.data_len = data_len,
+					.rate_idx = -1,
+					.outcome = RECORDER_NO_SENDER,
+				};
+
+				memcpy(event.sender, src, ETH_ALEN);
+				memcpy(event.receiver, hdr->addr1, ETH_ALEN);
+				recorder_record(&event);
+				w_flogf_ratelimited(ctx, LOG_ERR, stderr, "Unable to find sender station " MAC_FMT "\n", MAC_ARGS(src));
+				free(frame);
+				goto drop;
+			}
+			/*
+			 * The frame path is the only writer of the state learned
+			 * from the radio, but the control plane reads it under
+			 * snr_lock, so update it under the lock when it changes.
+			 */
+			if (memcmp(sender->hwaddr, hwaddr, ETH_ALEN) ||
+			    sender->freq != freq) {
+				pthread_rwlock_rdlock(&snr_lock);
+				memcpy(sender->hwaddr, hwaddr, ETH_ALEN);
+				sender->freq = freq;
+				pthread_rwlock_unlock(&snr_lock);
 			}
-			memcpy(sender->hwaddr, hwaddr, ETH_ALEN);
 			
 			if (!frame)
-				goto out;
+				goto drop;
 				
 			memcpy(frame->data, data, data_len);
 			frame->data_len = data_len;
@@ -422,7 +569,6 @@ static int process_messages_cb(struct nl_msg *msg, void *arg)
 			frame->cookie = cookie;
 			frame->freq = freq;
 			frame->sender = sender;
-			sender->freq = freq;
 			frame->tx_rates_count =
 				tx_rates_len / sizeof(struct hwsim_tx_rate);
 			memcpy(frame->tx_rates, tx_rates,
@@ -430,13 +576,23 @@ static int process_messages_cb(struct nl_msg *msg, void *arg)
 				
 			message = serialize_message_tosend(hwaddr, data_len, flags, tx_rates_len, tx_rates, cookie, freq, src, frame->data);
 			
-			send_to_global(sock_w, tosend);
-			recv_from_global(sock_w, ctx, frame);
+			marks[METRICS_MARK_PARSED] = metrics_now();
+			WMEDIUMD_PROBE3(frame_parse, cookie, sender->index, data_len);
+			if (send_to_global(sock_w, tosend))
+				metrics_count(METRICS_GLOBAL_ERRORS);
+			else
+				WMEDIUMD_PROBE3(global_send, cookie, sender->index,
+						sizeof(*tosend));
+			marks[METRICS_MARK_SENT] = metrics_now();
+			recv_from_global(sock_w, ctx, frame, marks);
 			
 		}
 out:
-		pthread_rwlock_unlock(&snr_lock);
+		link_state_release();
 		return 0;
+drop:
+		metrics_count(METRICS_DROPPED);
+		goto out;
 
 	}
 	return 0;
@@ -528,7 +684,7 @@ static int init_netlink(struct wmediumd *ctx)
 void print_help(int exval)
 {
 	printf("wmediumd v%s - a wireless medium simulator\n", VERSION_STR);
-	printf("wmediumd [-h] [-V] [-s] [-l LOG_LVL] [-x FILE] -c FILE\n\n");
+	printf("wmediumd [-h] [-V] [-s] [-u MSEC] [-e NAME] [-w FILE] [-t SEC] [-l LOG_LVL] [-x FILE] [-o FILE] -c FILE\n\n");
 
 	printf("  -h              print this help and exit\n");
 	printf("  -V              print version and exit\n\n");
@@ -539,22 +695,71 @@ void print_help(int exval)
 	printf("                  >= 5: startup msgs are logged\n");
 	printf("                  >= 6: dropped packets are logged (default)\n");
 	printf("                  == 7: all packets will be logged\n");
-	printf("  -c FILE         set input config file\n");
+	printf("  -c FILE         set input config file or .wmsnap snapshot\n");
 	printf("  -x FILE         set input PER file\n");
+	printf("  -o FILE         write a binary snapshot of the config and exit\n");
 	printf("  -s              start the server on a socket\n");
+	printf("  -u MSEC         merge station updates received by the server\n");
+	printf("                  within MSEC milliseconds (default 0: per batch)\n");
+	printf("  -e NAME         export the link state to the read-only shared\n");
+	printf("                  memory object NAME, e.g. /wmediumd-links\n");
+	printf("  -w FILE         capture the frames with radiotap headers to\n");
+	printf("                  the pcapng file FILE\n");
+	printf("  -t SEC          log the traffic of each station and the\n");
+	printf("                  busiest links every SEC seconds\n");
 	printf("  -d              use the dynamic complex mode\n");
 	printf("                  (server only with matrices for each connection)\n");
 
 	exit(exval);
 }
 
+static void reload_cb(int fd, short what, void *data)
+{
+	struct wmediumd *ctx = data;
+
+	w_logf(ctx, LOG_NOTICE, "SIGHUP received, reloading config\n");
+	reload_config(ctx);
+}
+
+static void metrics_cb(int fd, short what, void *data)
+{
+	metrics_dump(data);
+}
+
+static void recorder_cb(int fd, short what, void *data)
+{
+	struct wmediumd *ctx = data;
+	char path[64];
+	int ret;
+
+	snprintf(path, sizeof(path), RECORDER_DUMP_PATH, (int)getpid());
+	ret = recorder_dump(path);
+	if (ret)
+		w_flogf(ctx, LOG_ERR, stderr, "Could not dump the flight "
+			"recorder to %s: %s\n", path, strerror(-ret));
+	else
+		w_logf(ctx, LOG_NOTICE, "Flight recorder dumped to %s\n", path);
+}
+
+static void term_cb(int fd, short what, void *data)
+{
+	event_loopbreak();
+}
+
+static void stats_cb(int fd, short what, void *data)
+{
+	link_stats_dump(data, LINK_STATS_DUMP_TOP);
+}
+
 static void timer_cb(int fd, short what, void *data)
 {
 	struct wmediumd *ctx = data;
 	uint64_t u;
-	pthread_rwlock_rdlock(&snr_lock);
+	pthread_rwlock_wrlock(&snr_lock);
 	read(fd, &u, sizeof(u));
 	ctx->move_stations(ctx);
+	if (is_moving_stations(ctx))
+		link_state_publish(ctx);
 	rearm_timer(ctx);
 	pthread_rwlock_unlock(&snr_lock);
 }
@@ -563,13 +768,23 @@ int main(int argc, char *argv[])
 {
 	struct event ev_cmd;
 	struct event ev_timer;
+	struct event ev_reload;
+	struct event ev_metrics;
+	struct event ev_recorder;
+	struct event ev_stats;
+	struct event ev_int, ev_term;
+	struct timeval stats_interval = { 0 };
 	struct wmediumd ctx;
 	char *config_file = NULL;
 	char *per_file = NULL;
+	char *snapshot_file = NULL;
+	char *export_name = NULL;
+	char *capture_file = NULL;
 	int opt;	
 	int sock_tcp = 0, client_fd;
 	struct sockaddr_in serv_addr;
 	setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+	memset(&ctx, 0, sizeof(ctx));
 
 	if (argc == 1) {
 		print_help(EXIT_FAILURE);
@@ -577,11 +792,13 @@ int main(int argc, char *argv[])
 
 	ctx.log_lvl = 8;
 	unsigned long int parse_log_lvl;
+	unsigned long int parse_window;
+	unsigned long int parse_interval;
 	char* parse_end_token;
 	bool start_server = false;
 	bool full_dynamic = false;
 
-	while ((opt = getopt(argc, argv, "hVc:l:x:sd")) != -1) {
+	while ((opt = getopt(argc, argv, "hVc:l:x:o:su:e:w:t:d")) != -1) {
 		switch (opt) {
 		case 'h':
 			print_help(EXIT_SUCCESS);
@@ -598,6 +815,9 @@ int main(int argc, char *argv[])
 			printf("Input packet error rate file: %s\n", optarg);
 			per_file = optarg;
 			break;
+		case 'o':
+			snapshot_file = optarg;
+			break;
 		case ':':
 			printf("wmediumd: Error - Option `%c' "
 			       "needs a value\n\n", optopt);
@@ -619,6 +839,32 @@ int main(int argc, char *argv[])
 		case 's':
 			start_server = true;
 			break;
+		case 'u':
+			parse_window = strtoul(optarg, &parse_end_token, 10);
+			if (optarg == parse_end_token || *parse_end_token ||
+			    parse_window > 60000) {
+				printf("wmediumd: Error - Invalid update window: "
+				       "%s\n\n", optarg);
+				print_help(EXIT_FAILURE);
+			}
+			ctx.update_window_ms = parse_window;
+			break;
+		case 'e':
+			export_name = optarg;
+			break;
+		case 'w':
+			capture_file = optarg;
+			break;
+		case 't':
+			parse_interval = strtoul(optarg, &parse_end_token, 10);
+			if (optarg == parse_end_token || *parse_end_token ||
+			    !parse_interval || parse_interval > 86400) {
+				printf("wmediumd: Error - Invalid statistics interval: "
+				       "%s\n\n", optarg);
+				print_help(EXIT_FAILURE);
+			}
+			stats_interval.tv_sec = parse_interval;
+			break;
 		case '?':
 			printf("wmediumd: Error - No such option: "
 			       "`%c'\n\n", optopt);
@@ -631,6 +877,11 @@ int main(int argc, char *argv[])
 	if (optind < argc)
 		print_help(EXIT_FAILURE);
 
+	/* format and print log messages off the frame path */
+	if (log_ring_start())
+		w_flogf(&ctx, LOG_WARNING, stderr,
+			"Unable to start the log thread, logging synchronously\n");
+
 	if (full_dynamic) {
 		if (config_file) {
 			print_help(EXIT_FAILURE);
@@ -640,6 +891,12 @@ int main(int argc, char *argv[])
 			print_help(EXIT_FAILURE);
 		}
 
+		/* a snapshot is tied to the config file it was made from */
+		if (snapshot_file) {
+			printf("wmediumd: Error - A snapshot needs a config file\n\n");
+			print_help(EXIT_FAILURE);
+		}
+
 		w_logf(&ctx, LOG_NOTICE, "Using dynamic complex mode instead of config file\n");
 	} else {
 		if (!config_file) {
@@ -649,9 +906,54 @@ int main(int argc, char *argv[])
 		w_logf(&ctx, LOG_NOTICE, "Input configuration file: %s\n", config_file);
 	}
 	INIT_LIST_HEAD(&ctx.stations);
+	ctx.config_file = config_file;
+	ctx.per_file = per_file;
 	if (load_config(&ctx, config_file, per_file, full_dynamic))
 		return EXIT_FAILURE;
 
+	if (snapshot_file) {
+		int ret = wmsnap_write(&ctx, snapshot_file, config_file);
+
+		if (ret) {
+			w_flogf(&ctx, LOG_ERR, stderr,
+				"Could not write snapshot %s: %s\n",
+				snapshot_file, strerror(-ret));
+			return EXIT_FAILURE;
+		}
+		w_logf(&ctx, LOG_NOTICE, "Snapshot written to %s\n",
+		       snapshot_file);
+		return EXIT_SUCCESS;
+	}
+
+	if (export_name) {
+		int ret = link_export_open(&ctx, export_name);
+
+		if (ret) {
+			w_flogf(&ctx, LOG_ERR, stderr,
+				"Could not export the link state to %s: %s\n",
+				export_name, strerror(-ret));
+			return EXIT_FAILURE;
+		}
+		w_logf(&ctx, LOG_NOTICE, "Exporting the link state to %s\n",
+		       export_name);
+	}
+
+	if (capture_file) {
+		int ret = capture_open(&ctx, capture_file);
+
+		if (ret) {
+			w_flogf(&ctx, LOG_ERR, stderr,
+				"Could not capture to %s: %s\n",
+				capture_file, strerror(-ret));
+			return EXIT_FAILURE;
+		}
+		w_logf(&ctx, LOG_NOTICE, "Capturing frames to %s\n",
+		       capture_file);
+	}
+
+	if (link_state_publish(&ctx))
+		return EXIT_FAILURE;
+
 	/* init libevent */
 	event_init();
 
@@ -671,6 +973,35 @@ int main(int argc, char *argv[])
 	event_set(&ev_timer, ctx.timerfd, EV_READ | EV_PERSIST, timer_cb, &ctx);
 	event_add(&ev_timer, NULL);
 
+	/* reload the config on SIGHUP */
+	event_set(&ev_reload, SIGHUP, EV_SIGNAL | EV_PERSIST, reload_cb, &ctx);
+	event_add(&ev_reload, NULL);
+
+	/* log the frame path metrics on SIGUSR1 */
+	event_set(&ev_metrics, SIGUSR1, EV_SIGNAL | EV_PERSIST, metrics_cb, &ctx);
+	event_add(&ev_metrics, NULL);
+
+	/* dump the flight recorder on SIGUSR2 */
+	event_set(&ev_recorder, SIGUSR2, EV_SIGNAL | EV_PERSIST, recorder_cb, &ctx);
+	event_add(&ev_recorder, NULL);
+
+	/*
+	 * leave the main loop on SIGINT and SIGTERM to finish the capture,
+	 * set up before the wserver starts so that it leaves SIGINT alone
+	 */
+	if (ctx.capture) {
+		event_set(&ev_int, SIGINT, EV_SIGNAL | EV_PERSIST, term_cb, &ctx);
+		event_add(&ev_int, NULL);
+		event_set(&ev_term, SIGTERM, EV_SIGNAL | EV_PERSIST, term_cb, &ctx);
+		event_add(&ev_term, NULL);
+	}
+
+	/* periodic traffic statistics */
+	if (stats_interval.tv_sec) {
+		event_set(&ev_stats, -1, EV_PERSIST, stats_cb, &ctx);
+		event_add(&ev_stats, &stats_interval);
+	}
+
 	/* register for new frames */
 	if (send_register_msg(&ctx) == 0) {
 		w_logf(&ctx, LOG_NOTICE, "REGISTER SENT!\n");
@@ -704,6 +1035,9 @@ int main(int argc, char *argv[])
 		< 0) {
 		return -1;
 	}
+	if (global_rtt_init(&global_rtt, sock_tcp))
+		w_logf(&ctx, LOG_NOTICE, "No kernel timestamps for the global "
+		       "medium, measuring round trips in user space\n");
 	
 	sleep(5);
 	
@@ -713,6 +1047,9 @@ int main(int argc, char *argv[])
 	if (start_server == true)
 		stop_wserver();
 
+	link_state_destroy(&ctx);
+	link_export_close(&ctx);
+	capture_close(&ctx);
 	free(ctx.sock);
 	free(ctx.cb);
 	free(ctx.intf);
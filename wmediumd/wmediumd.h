@@ -221,14 +221,23 @@ struct station {
     int medium_id;
 };
 
+struct link_state;
+struct link_export;
+struct capture;
+
 struct wmediumd {
 	int timerfd;
 
 	struct nl_sock *sock;
     bool enable_medium_detection;
-	int num_stas;
+	int num_stas;			/* used slots, including deleted ones */
+	int sta_capacity;		/* allocated slots, row stride of the matrices */
 	struct list_head stations;
-	struct station **sta_array;
+	struct station **sta_array;	/* NULL for deleted stations */
+	u32 *slot_gen;			/* generation of each slot */
+	int num_slot_gens;		/* may exceed sta_capacity after a reload */
+	int *free_slots;		/* slots of deleted stations */
+	int num_free_slots;
 	int *snr_matrix;
 	double *error_prob_matrix;
 	double **station_err_matrix;
@@ -242,6 +251,15 @@ struct wmediumd {
 	int per_matrix_signal_min;
 	int fading_coefficient;
 	int noise_threshold;
+	u64 rng_seed;
+	void *snapshot_map;
+	size_t snapshot_len;
+	const char *config_file;
+	const char *per_file;
+	int update_window_ms;		/* wserver coalescing of station updates */
+	struct link_state *link_state;	/* current snapshot, see link_state.h */
+	struct link_export *link_export;	/* shared memory copy of it, or NULL */
+	struct capture *capture;	/* pcapng file of the frames, or NULL */
 
 	struct nl_cb *cb;
 	int family_id;
@@ -253,7 +271,8 @@ struct wmediumd {
 	int (*calc_path_loss)(void *, struct station *,
 			      struct station *);
 	void (*move_stations)(struct wmediumd *);
-	int (*get_fading_signal)(struct wmediumd *);
+	int (*get_fading_signal)(struct wmediumd *, struct station *,
+				 struct station *, u64);
 
 	u8 log_lvl;
 };
@@ -310,9 +329,52 @@ double get_error_prob_from_snr(double snr, unsigned int rate_idx, u32 freq,
 bool timespec_before(struct timespec *t1, struct timespec *t2);
 int set_default_per(struct wmediumd *ctx);
 int read_per_file(struct wmediumd *ctx, const char *file_name);
-int w_logf(struct wmediumd *ctx, u8 level, const char *format, ...);
-int w_flogf(struct wmediumd *ctx, u8 level, FILE *stream, const char *format, ...);
 int index_to_rate(size_t index, u32 freq);
 void detect_mediums(struct wmediumd *ctx, struct station *src, struct station *dest);
 
+/*
+ * Messages above this level are compiled out together with the
+ * evaluation of their arguments, e.g. make W_LOG_LEVEL_MAX=LOG_NOTICE
+ */
+#ifndef W_LOG_LEVEL_MAX
+#define W_LOG_LEVEL_MAX LOG_DEBUG
+#endif
+
+/* Messages of one call site, printed per interval before suppressing */
+#define W_LOG_RATELIMIT_BURST		10
+#define W_LOG_RATELIMIT_INTERVAL	5000	/* [ms] */
+
+struct w_ratelimit {
+	u64 begin;			/* of the interval [ms], 0 before the first */
+	u32 printed;
+	u32 suppressed;
+};
+
+int w_log_print(FILE *stream, const char *format, ...)
+	__attribute__((format(printf, 2, 3)));
+bool w_ratelimit(struct wmediumd *ctx, struct w_ratelimit *rl,
+		 const char *func);
+
+#define w_log_enabled(ctx, level)	\
+	((level) <= W_LOG_LEVEL_MAX &&					\
+	 ((const struct wmediumd *)(ctx))->log_lvl >= (level))
+
+#define w_flogf(ctx, level, stream, ...) \
+	(w_log_enabled(ctx, level) ? w_log_print(stream, __VA_ARGS__) : -1)
+#define w_logf(ctx, level, ...) \
+	w_flogf(ctx, level, stdout, __VA_ARGS__)
+
+/*
+ * For messages that can fire per frame: each call site prints at most
+ * W_LOG_RATELIMIT_BURST messages per interval and reports how many it
+ * suppressed once the next interval starts.
+ */
+#define w_flogf_ratelimited(ctx, level, stream, ...) ({			\
+	static struct w_ratelimit __rl;					\
+	w_log_enabled(ctx, level) && w_ratelimit(ctx, &__rl, __func__) ?	\
+		w_log_print(stream, __VA_ARGS__) : -1;			\
+})
+#define w_logf_ratelimited(ctx, level, ...) \
+	w_flogf_ratelimited(ctx, level, stdout, __VA_ARGS__)
+
 #endif /* WMEDIUMD_H_ */
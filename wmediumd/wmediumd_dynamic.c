@@ -18,106 +18,271 @@
  *	02110-1301, USA.
  */
 
+
 #include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include "wmediumd_dynamic.h"
+#include "wmsnap.h"
+#include "config.h"
+#include "link_state.h"
 
 #define DEFAULT_DYNAMIC_SNR -10
 #define DEFAULT_DYNAMIC_ERRPROB 1.0
 #define DEFAULT_FULL_DYNAMIC_ERRPROB 1.0
+#define MIN_STATION_CAPACITY 16
+#define ERR_BLOCKS_PER_CHUNK 64
+#define MAX_STATION_CAPACITY (STATION_ID_INDEX_MASK + 1)
 
 pthread_rwlock_t snr_lock = PTHREAD_RWLOCK_INITIALIZER;
 
-#define swap_matrix(matrix_ptr, oldsize, newsize, elem_type, backup_ptr) \
-    backup_ptr = malloc(sizeof(elem_type) * oldsize * oldsize); \
-    memcpy(backup_ptr, matrix_ptr, sizeof(elem_type) * oldsize * oldsize); \
-    free(matrix_ptr); \
-    matrix_ptr = malloc(sizeof(elem_type) * newsize * newsize);
+/*
+ * The matrices are stored with a row stride of ctx->sta_capacity, so adding
+ * a station only copies them when the capacity is exhausted. The capacity
+ * doubles each time, which makes adding n stations O(n^2) in total instead
+ * of O(n^3). Deleting a station leaves a tombstone (a NULL entry in
+ * sta_array) and its slot is handed out again by the next add, so the index
+ * of a station never changes while it exists. ctx->num_stas is the number
+ * of slots in use, including tombstones.
+ */
 
-int add_station(struct wmediumd *ctx, const u8 addr[]) {
-    struct station *sta_loop;
-    list_for_each_entry(sta_loop, &ctx->stations, list) {
-        if (memcmp(sta_loop->addr, addr, ETH_ALEN) == 0)
-            return -EEXIST;
+static void *copy_matrix(const struct wmediumd *ctx, const void *matrix, size_t elem_size,
+                         int new_capacity) {
+    const u8 *old_matrix = matrix;
+    u8 *new_matrix = calloc((size_t) new_capacity * new_capacity, elem_size);
+    if (!new_matrix)
+        return NULL;
+
+    for (int row = 0; row < ctx->num_stas; row++) {
+        memcpy(new_matrix + (size_t) row * new_capacity * elem_size,
+               old_matrix + (size_t) row * ctx->sta_capacity * elem_size,
+               (size_t) ctx->num_stas * elem_size);
     }
+    return new_matrix;
+}
 
-    pthread_rwlock_wrlock(&snr_lock);
-    size_t oldnum = (size_t) ctx->num_stas;
-    size_t newnum = oldnum + 1;
-
-    // Save old matrix and init new matrix
-    union {
-        int *old_snr_matrix;
-        double *old_errprob_matrix;
-        double **old_station_err_matrix;
-    } matrizes;
-    int ret;
-    if (ctx->station_err_matrix != NULL) {
-        swap_matrix(ctx->station_err_matrix, oldnum, newnum, double*, matrizes.old_station_err_matrix);
-    } else if (ctx->error_prob_matrix != NULL) {
-        swap_matrix(ctx->error_prob_matrix, oldnum, newnum, double, matrizes.old_errprob_matrix);
-    } else {
-        swap_matrix(ctx->snr_matrix, oldnum, newnum, int, matrizes.old_snr_matrix);
+static void release_matrix(struct wmediumd *ctx, void *matrix) {
+    if (!wmsnap_is_mapped(ctx, matrix))
+        free(matrix);
+}
+
+/**
+ * Make room for at least count station slots
+ * @param ctx The wmediumd context
+ * @param count The number of slots needed
+ * @return 0 on success otherwise a negative errno value
+ */
+static int reserve_stations(struct wmediumd *ctx, int count) {
+    int new_capacity = ctx->sta_capacity;
+
+    if (count <= ctx->sta_capacity)
+        return 0;
+    if (count > MAX_STATION_CAPACITY)
+        return -ENOSPC;
+
+    if (new_capacity < MIN_STATION_CAPACITY)
+        new_capacity = MIN_STATION_CAPACITY;
+    while (new_capacity < count)
+        new_capacity *= 2;
+    if (new_capacity > MAX_STATION_CAPACITY)
+        new_capacity = MAX_STATION_CAPACITY;
+
+    struct station **sta_array = realloc(ctx->sta_array, sizeof(*sta_array) * new_capacity);
+    if (!sta_array)
+        return -ENOMEM;
+    ctx->sta_array = sta_array;
+
+    // A reload may have left generations beyond the capacity, keep them
+    if (new_capacity > ctx->num_slot_gens) {
+        u32 *slot_gen = realloc(ctx->slot_gen, sizeof(*slot_gen) * new_capacity);
+        if (!slot_gen)
+            return -ENOMEM;
+        memset(slot_gen + ctx->num_slot_gens, 0, sizeof(*slot_gen) * (new_capacity - ctx->num_slot_gens));
+        ctx->slot_gen = slot_gen;
+        ctx->num_slot_gens = new_capacity;
     }
 
-    // Copy old matrix
-    for (size_t x = 0; x < oldnum; x++) {
-        for (size_t y = 0; y < oldnum; y++) {
-            if (ctx->station_err_matrix != NULL) {
-                ctx->station_err_matrix[x * newnum + y] = matrizes.old_station_err_matrix[x * oldnum + y];
-            } else if (ctx->error_prob_matrix != NULL) {
-                ctx->error_prob_matrix[x * newnum + y] = matrizes.old_errprob_matrix[x * oldnum + y];
-            } else {
-                ctx->snr_matrix[x * newnum + y] = matrizes.old_snr_matrix[x * oldnum + y];
-            }
-        }
+    int *free_slots = realloc(ctx->free_slots, sizeof(*free_slots) * new_capacity);
+    if (!free_slots)
+        return -ENOMEM;
+    ctx->free_slots = free_slots;
+
+    // All matrices must change their stride together
+    int *snr_matrix = copy_matrix(ctx, ctx->snr_matrix, sizeof(int), new_capacity);
+    double *errprob_matrix = NULL;
+    double **station_err_matrix = NULL;
+    if (ctx->error_prob_matrix != NULL)
+        errprob_matrix = copy_matrix(ctx, ctx->error_prob_matrix, sizeof(double), new_capacity);
+    if (ctx->station_err_matrix != NULL)
+        station_err_matrix = copy_matrix(ctx, ctx->station_err_matrix, sizeof(double *),
+                                         new_capacity);
+    if (!snr_matrix || (ctx->error_prob_matrix != NULL && !errprob_matrix) ||
+        (ctx->station_err_matrix != NULL && !station_err_matrix)) {
+        free(snr_matrix);
+        free(errprob_matrix);
+        free(station_err_matrix);
+        return -ENOMEM;
     }
 
-    // Fill last lines with default snr
-    for (size_t x = 0; x < newnum; x++) {
-        if (ctx->station_err_matrix != NULL) {
-            ctx->station_err_matrix[x * newnum + oldnum] = malloc(
-                    SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX * sizeof(double));
-            for (int i = 0; i < SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX; i++) {
-                ctx->station_err_matrix[x * newnum + oldnum][i] = DEFAULT_FULL_DYNAMIC_ERRPROB;
-            }
-        } else if (ctx->error_prob_matrix != NULL) {
-            ctx->error_prob_matrix[x * newnum + oldnum] = DEFAULT_DYNAMIC_ERRPROB;
-        } else {
-            ctx->snr_matrix[x * newnum + oldnum] = DEFAULT_DYNAMIC_SNR;
+    release_matrix(ctx, ctx->snr_matrix);
+    ctx->snr_matrix = snr_matrix;
+    if (errprob_matrix != NULL) {
+        release_matrix(ctx, ctx->error_prob_matrix);
+        ctx->error_prob_matrix = errprob_matrix;
+    }
+    if (station_err_matrix != NULL) {
+        free(ctx->station_err_matrix);
+        ctx->station_err_matrix = station_err_matrix;
+    }
+    ctx->sta_capacity = new_capacity;
+    return 0;
+}
+
+/*
+ * Per-link specific error matrices. Links that were never written share
+ * one read-only default block; a link gets a block of its own the first
+ * time it is written (copy-on-write). Blocks are carved out of large cache
+ * line aligned chunks and recycled through a free list, so adding stations
+ * never allocates per link. All of this is protected by snr_lock.
+ */
+union err_block {
+    double probs[SPECIFIC_MATRIX_LEN];
+    union err_block *next_free;
+};
+
+static const union err_block default_err_block __attribute__((aligned(64))) = {
+    .probs = {[0 ... SPECIFIC_MATRIX_LEN - 1] = DEFAULT_FULL_DYNAMIC_ERRPROB}
+};
+
+static union err_block *free_err_blocks;
+
+static double *shared_err_block(void) {
+    // Never written through: it lives in read-only memory
+    return (double *) default_err_block.probs;
+}
+
+static double *alloc_err_block(void) {
+    if (free_err_blocks == NULL) {
+        union err_block *chunk = aligned_alloc(64, sizeof(*chunk) * ERR_BLOCKS_PER_CHUNK);
+        if (!chunk)
+            return NULL;
+        for (int i = 0; i < ERR_BLOCKS_PER_CHUNK; i++) {
+            chunk[i].next_free = free_err_blocks;
+            free_err_blocks = &chunk[i];
         }
     }
-    for (size_t y = 0; y < newnum; y++) {
+    union err_block *block = free_err_blocks;
+    free_err_blocks = block->next_free;
+    return block->probs;
+}
+
+static void release_err_block(double *probs) {
+    if (probs == NULL || probs == shared_err_block())
+        return;
+    union err_block *block = (union err_block *) probs;
+    block->next_free = free_err_blocks;
+    free_err_blocks = block;
+}
+
+int set_specific_error_probs(struct wmediumd *ctx, struct station *from, struct station *to,
+                             const double *probs) {
+    double **link = &ctx->station_err_matrix[(size_t) from->index * ctx->sta_capacity + to->index];
+
+    if (*link == NULL || *link == shared_err_block()) {
+        double *block = alloc_err_block();
+        if (!block)
+            return -ENOMEM;
+        *link = block;
+    }
+    memcpy(*link, probs, sizeof(double) * SPECIFIC_MATRIX_LEN);
+    return 0;
+}
+
+/**
+ * Reset all links of a (new, reused or deleted) slot to the defaults
+ */
+static void reset_slot(struct wmediumd *ctx, int index) {
+    size_t stride = (size_t) ctx->sta_capacity;
+
+    for (int other = 0; other < ctx->num_stas; other++) {
+        ctx->snr_matrix[index * stride + other] = DEFAULT_DYNAMIC_SNR;
+        ctx->snr_matrix[other * stride + index] = DEFAULT_DYNAMIC_SNR;
+        if (ctx->error_prob_matrix != NULL) {
+            ctx->error_prob_matrix[index * stride + other] = DEFAULT_DYNAMIC_ERRPROB;
+            ctx->error_prob_matrix[other * stride + index] = DEFAULT_DYNAMIC_ERRPROB;
+        }
         if (ctx->station_err_matrix != NULL) {
-            ctx->station_err_matrix[oldnum * newnum + y] = malloc(
-                    SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX * sizeof(double));
-            for (int i = 0; i < SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX; i++) {
-                ctx->station_err_matrix[oldnum * newnum + y][i] = DEFAULT_FULL_DYNAMIC_ERRPROB;
+            double **to = &ctx->station_err_matrix[index * stride + other];
+            double **from = &ctx->station_err_matrix[other * stride + index];
+            release_err_block(*to);
+            *to = shared_err_block();
+            if (from != to) {
+                release_err_block(*from);
+                *from = shared_err_block();
             }
-        } else if (ctx->error_prob_matrix != NULL) {
-            ctx->error_prob_matrix[oldnum * newnum + y] = DEFAULT_DYNAMIC_ERRPROB;
-        } else {
-            ctx->snr_matrix[oldnum * newnum + y] = DEFAULT_DYNAMIC_SNR;
         }
     }
+}
 
-    if (ctx->station_err_matrix != NULL) {
-        free(matrizes.old_station_err_matrix);
-    } else if (ctx->error_prob_matrix != NULL) {
-        free(matrizes.old_errprob_matrix);
-    } else {
-        free(matrizes.old_snr_matrix);
+i32 station_id(struct wmediumd *ctx, struct station *station) {
+    u32 generation = ctx->slot_gen ? ctx->slot_gen[station->index] : 0;
+    return (i32) ((generation & STATION_ID_GEN_MASK) << STATION_ID_INDEX_BITS |
+                  (u32) station->index);
+}
+
+struct station *get_station_by_id(struct wmediumd *ctx, const i32 id) {
+    if (id < 0)
+        return NULL;
+    int index = id & STATION_ID_INDEX_MASK;
+    if (index >= ctx->num_stas || ctx->sta_array[index] == NULL)
+        return NULL;
+    if (station_id(ctx, ctx->sta_array[index]) != id)
+        return NULL;
+    return ctx->sta_array[index];
+}
+
+static struct station *find_station_by_addr(struct wmediumd *ctx, const u8 *addr) {
+    struct station *station;
+    list_for_each_entry(station, &ctx->stations, list) {
+        if (memcmp(station->addr, addr, ETH_ALEN) == 0)
+            return station;
     }
+    return NULL;
+}
 
-    // Init new station object
+/**
+ * Add a station, snr_lock must be held for writing
+ * @return The station ID or a negative errno value
+ */
+static int add_station_locked(struct wmediumd *ctx, const u8 addr[]) {
     struct station *station;
+    int index;
+    int ret;
+
+    if (find_station_by_addr(ctx, addr) != NULL)
+        return -EEXIST;
+
     station = malloc(sizeof(*station));
-    if (!station) {
-        ret = -ENOMEM;
-        goto out;
+    if (!station)
+        return -ENOMEM;
+
+    if (ctx->num_free_slots > 0) {
+        index = ctx->free_slots[--ctx->num_free_slots];
+    } else {
+        ret = reserve_stations(ctx, ctx->num_stas + 1);
+        if (ret) {
+            free(station);
+            return ret;
+        }
+        index = ctx->num_stas++;
+        ctx->sta_array[index] = NULL;
     }
-    station->index = (int) oldnum;
+
+    reset_slot(ctx, index);
+
+    // Init new station object
+    memset(station, 0, sizeof(*station));
+    station->index = index;
     memcpy(station->addr, addr, ETH_ALEN);
     memcpy(station->hwaddr, addr, ETH_ALEN);
     station->isap = AP_DEFAULT;
@@ -126,115 +291,137 @@ int add_station(struct wmediumd *ctx, const u8 addr[]) {
     station->medium_id = MEDIUM_ID_DEFAULT;
     station_init_queues(station);
     list_add_tail(&station->list, &ctx->stations);
-    //realloc(ctx->sta_array, 1);
-    ctx->sta_array[station->index] = station;
-    ctx->num_stas = (int) newnum;
-    ret = station->index;
+    ctx->sta_array[index] = station;
+    return station_id(ctx, station);
+}
 
-    out:
+int add_station(struct wmediumd *ctx, const u8 addr[]) {
+    pthread_rwlock_wrlock(&snr_lock);
+    int ret = add_station_locked(ctx, addr);
+    if (ret >= 0)
+        link_state_publish(ctx);
     pthread_rwlock_unlock(&snr_lock);
     return ret;
 }
 
-int del_station(struct wmediumd *ctx, struct station *station) {
-    if (ctx->num_stas == 0) {
-        return -ENXIO;
-    }
-    size_t oldnum = (size_t) ctx->num_stas;
-    size_t newnum = oldnum - 1;
-
-    // Save old matrix and init new matrix
-    union {
-        int *old_snr_matrix;
-        double *old_errprob_matrix;
-        double **old_station_err_matrix;
-    } matrizes;
-    if (ctx->station_err_matrix != NULL) {
-        swap_matrix(ctx->station_err_matrix, oldnum, newnum, double*, matrizes.old_station_err_matrix);
-    } else if (ctx->error_prob_matrix != NULL) {
-        swap_matrix(ctx->error_prob_matrix, oldnum, newnum, double, matrizes.old_errprob_matrix);
-    } else {
-        swap_matrix(ctx->snr_matrix, oldnum, newnum, int, matrizes.old_snr_matrix);
+static void apply_station_props(struct station *station, const struct station_props *props) {
+    if (props->mask & STATION_PROP_POSITION) {
+        station->x = props->x;
+        station->y = props->y;
+        station->z = props->z;
     }
+    if (props->mask & STATION_PROP_TXPOWER)
+        station->tx_power = props->tx_power;
+    if (props->mask & STATION_PROP_GAIN)
+        station->gain = props->gain;
+    if (props->mask & STATION_PROP_GAUSSIAN_RANDOM)
+        station->gRandom = props->gRandom;
+}
 
-    size_t index = (size_t) station->index;
+int add_stations(struct wmediumd *ctx, const struct station_props *props, int count, i32 *ids) {
+    bool recalc = false;
+    int ret;
 
-    // Decreasing index of stations following deleted station
-    struct station *sta_loop = station;
-    list_for_each_entry_from(sta_loop, &ctx->stations, list) {
-        sta_loop->index = sta_loop->index - 1;
-    }
+    pthread_rwlock_wrlock(&snr_lock);
 
-    if (ctx->station_err_matrix != NULL) {
-        for (size_t x = 0; x < oldnum; x++) {
-            // free old specific matrices
-            if (matrizes.old_station_err_matrix[x * oldnum + index] != NULL) {
-                free(matrizes.old_station_err_matrix[x * oldnum + index]);
-            }
-        }
+    // Grow the matrices once for the whole batch
+    int needed = ctx->num_stas + count - ctx->num_free_slots;
+    ret = reserve_stations(ctx, needed < ctx->num_stas ? ctx->num_stas : needed);
+    if (ret)
+        goto out;
 
-        for (size_t y = 0; y < oldnum; y++) {
-            if(y == index){
-                continue;
-            }
-            // free old specific matrices
-            if (matrizes.old_station_err_matrix[index * oldnum + y] != NULL) {
-                free(matrizes.old_station_err_matrix[index * oldnum + y]);
-            }
-        }
+    for (int i = 0; i < count; i++) {
+        ids[i] = add_station_locked(ctx, props[i].addr);
+        if (ids[i] < 0)
+            continue;
+
+        apply_station_props(ctx->sta_array[ids[i] & STATION_ID_INDEX_MASK], &props[i]);
+        if (props[i].mask)
+            recalc = true;
     }
 
-    // Copy all values not related to deleted station
-    int xnew = 0;
-    for (size_t x = 0; x < oldnum; x++) {
-        if (x == index) {
+    if (recalc && ctx->calc_path_loss != NULL)
+        recalc_path_loss(ctx);
+    link_state_publish(ctx);
+
+    out:
+    pthread_rwlock_unlock(&snr_lock);
+    return ret;
+}
+
+int update_stations(struct wmediumd *ctx, const struct station_props *props, int count, int *results) {
+    int *changed = malloc(sizeof(int) * count + 1);
+    int num_changed = 0;
+
+    if (!changed)
+        return -ENOMEM;
+
+    pthread_rwlock_wrlock(&snr_lock);
+
+    for (int i = 0; i < count; i++) {
+        struct station *station = find_station_by_addr(ctx, props[i].addr);
+        if (!station) {
+            results[i] = -ENODEV;
             continue;
         }
-        int ynew = 0;
-        for (size_t y = 0; y < oldnum; y++) {
-            if (y == index) {
-                continue;
-            }
-            if (ctx->station_err_matrix != NULL) {
-                ctx->station_err_matrix[xnew * newnum + ynew] = matrizes.old_station_err_matrix[x * oldnum + y];
-            } else if (ctx->error_prob_matrix != NULL) {
-                ctx->error_prob_matrix[xnew * newnum + ynew] = matrizes.old_errprob_matrix[x * oldnum + y];
-            } else {
-                ctx->snr_matrix[xnew * newnum + ynew] = matrizes.old_snr_matrix[x * oldnum + y];
-            }
-            ynew++;
-        }
-        xnew++;
+        apply_station_props(station, &props[i]);
+        if (props[i].mask)
+            changed[num_changed++] = station->index;
+        results[i] = 0;
     }
 
-    if (ctx->station_err_matrix != NULL) {
-        free(matrizes.old_station_err_matrix);
-    } else if (ctx->error_prob_matrix != NULL) {
-        free(matrizes.old_errprob_matrix);
-    } else {
-        free(matrizes.old_snr_matrix);
+    // Readers keep the previous snapshot until all changes are in
+    if (num_changed && ctx->calc_path_loss != NULL)
+        recalc_station_links(ctx, changed, num_changed);
+    link_state_publish(ctx);
+
+    pthread_rwlock_unlock(&snr_lock);
+    free(changed);
+    return 0;
+}
+
+int del_station(struct wmediumd *ctx, struct station *station) {
+    int index = station->index;
+
+    if (index < 0 || index >= ctx->num_stas || ctx->sta_array[index] != station) {
+        return -ENXIO;
+    }
+    if (ctx->free_slots == NULL || ctx->slot_gen == NULL) {
+        // Stations loaded from a config have no slot bookkeeping yet
+        if (ctx->slot_gen == NULL) {
+            ctx->slot_gen = calloc(ctx->sta_capacity, sizeof(*ctx->slot_gen));
+            ctx->num_slot_gens = ctx->slot_gen ? ctx->sta_capacity : 0;
+        }
+        if (ctx->free_slots == NULL)
+            ctx->free_slots = malloc(sizeof(*ctx->free_slots) * ctx->sta_capacity);
+        if (ctx->slot_gen == NULL || ctx->free_slots == NULL)
+            return -ENOMEM;
     }
 
-    list_del(&station->list);
-    ctx->num_stas = (int) newnum;
+    // Return the specific error matrices of the links to the arena
+    reset_slot(ctx, index);
+    ctx->sta_array[index] = NULL;
+    // Invalidate IDs handed out for this slot
+    ctx->slot_gen[index]++;
+    ctx->free_slots[ctx->num_free_slots++] = index;
 
-    free(station);
+    list_del(&station->list);
+    // The published link state may still reference the station
+    link_state_retire_station(station);
     return 0;
 }
 
 int del_station_by_id(struct wmediumd *ctx, const i32 id) {
     pthread_rwlock_wrlock(&snr_lock);
     int ret;
-    struct station *station;
-    list_for_each_entry(station, &ctx->stations, list) {
-        if (station->index == id) {
-            ret = del_station(ctx, station);
-            goto out;
-        }
+    struct station *station = get_station_by_id(ctx, id);
+    if (station != NULL) {
+        ret = del_station(ctx, station);
+        if (!ret)
+            link_state_publish(ctx);
+    } else {
+        ret = -ENODEV;
     }
-
-    out:
-    ret = -ENODEV;
     pthread_rwlock_unlock(&snr_lock);
     return ret;
 }
@@ -246,6 +433,8 @@ int del_station_by_mac(struct wmediumd *ctx, const u8 *addr) {
     list_for_each_entry(station, &ctx->stations, list) {
         if (memcmp(addr, station->addr, ETH_ALEN) == 0) {
             ret = del_station(ctx, station);
+            if (!ret)
+                link_state_publish(ctx);
             goto out;
         }
     }
@@ -255,3 +444,18 @@ int del_station_by_mac(struct wmediumd *ctx, const u8 *addr) {
     pthread_rwlock_unlock(&snr_lock);
     return ret;
 }
+
+int del_stations_by_mac(struct wmediumd *ctx, const u8 (*addrs)[ETH_ALEN], int count, int *results) {
+    pthread_rwlock_wrlock(&snr_lock);
+    for (int i = 0; i < count; i++) {
+        struct station *station = find_station_by_addr(ctx, addrs[i]);
+        if (station != NULL) {
+            results[i] = del_station(ctx, station);
+        } else {
+            results[i] = -ENODEV;
+        }
+    }
+    link_state_publish(ctx);
+    pthread_rwlock_unlock(&snr_lock);
+    return 0;
+}
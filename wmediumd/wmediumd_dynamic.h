@@ -23,6 +23,7 @@
 
 #define SPECIFIC_MATRIX_MAX_SIZE_IDX (12)
 #define SPECIFIC_MATRIX_MAX_RATE_IDX (12)
+#define SPECIFIC_MATRIX_LEN (SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX)
 
 #include <stdint.h>
 #include <pthread.h>
@@ -31,6 +32,32 @@
 typedef uint8_t u8;
 typedef int32_t i32;
 
+/*
+ * Station IDs carry the slot index in the low bits and the generation of
+ * the slot above it, so an ID of a deleted station is never mistaken for
+ * the station that later reuses its slot.
+ */
+#define STATION_ID_INDEX_BITS 20
+#define STATION_ID_INDEX_MASK ((1 << STATION_ID_INDEX_BITS) - 1)
+#define STATION_ID_GEN_MASK 0x7ff
+
+#define STATION_PROP_POSITION (1 << 0)
+#define STATION_PROP_TXPOWER (1 << 1)
+#define STATION_PROP_GAIN (1 << 2)
+#define STATION_PROP_GAUSSIAN_RANDOM (1 << 3)
+
+/*
+ * Initial properties of a station, only those in mask are applied
+ */
+struct station_props {
+    u8 addr[ETH_ALEN];
+    u8 mask;
+    double x, y, z;
+    int tx_power;
+    int gain;
+    int gRandom;
+};
+
 /**
  * Add a station
  * @param ctx The wmediumd context
@@ -39,6 +66,54 @@ typedef int32_t i32;
  */
 int add_station(struct wmediumd *ctx, const u8 addr[]);
 
+/**
+ * Add several stations, growing the matrices and recalculating the links once
+ * @param ctx The wmediumd context
+ * @param props The address and initial properties of each station
+ * @param count The number of stations
+ * @param ids Receives the station ID or a negative errno value per station
+ * @return 0 on success otherwise a negative errno value for the whole batch
+ */
+int add_stations(struct wmediumd *ctx, const struct station_props *props, int count, i32 *ids);
+
+/**
+ * Change the properties of several existing stations at once, recalculating
+ * each affected link once and publishing them together
+ * @param ctx The wmediumd context
+ * @param props The address and the properties to set per station
+ * @param count The number of stations
+ * @param results Receives 0 or a negative errno value per station
+ * @return 0 on success otherwise a negative errno value for the whole batch
+ */
+int update_stations(struct wmediumd *ctx, const struct station_props *props, int count, int *results);
+
+/**
+ * Set the specific error matrix of a link, snr_lock must be held for writing
+ * @param ctx The wmediumd context
+ * @param from The sending station
+ * @param to The receiving station
+ * @param probs SPECIFIC_MATRIX_LEN error probabilities
+ * @return 0 on success otherwise a negative errno value
+ */
+int set_specific_error_probs(struct wmediumd *ctx, struct station *from, struct station *to,
+                             const double *probs);
+
+/**
+ * Get the ID of a station
+ * @param ctx The wmediumd context
+ * @param station The station
+ * @return The ID, stable for the lifetime of the station
+ */
+i32 station_id(struct wmediumd *ctx, struct station *station);
+
+/**
+ * Look up a station by its ID
+ * @param ctx The wmediumd context
+ * @param id The ID of the station
+ * @return The station or NULL if the ID is unknown or stale
+ */
+struct station *get_station_by_id(struct wmediumd *ctx, const i32 id);
+
 /**
  * Delete a station
  * @param ctx The wmediumd context
@@ -63,6 +138,16 @@ int del_station_by_id(struct wmediumd *ctx, const i32 id);
  */
 int del_station_by_mac(struct wmediumd *ctx, const u8 *addr);
 
+/**
+ * Delete several stations by their addresses
+ * @param ctx The wmediumd context
+ * @param addrs The MAC addresses of the stations
+ * @param count The number of stations
+ * @param results Receives 0 or a negative errno value per station
+ * @return 0 on success otherwise a negative errno value for the whole batch
+ */
+int del_stations_by_mac(struct wmediumd *ctx, const u8 (*addrs)[ETH_ALEN], int count, int *results);
+
 /**
  * Lock for the snr matrix/station list
  */
@@ -0,0 +1,403 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Binary topology snapshots
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "wmsnap.h"
+#include "config.h"
+
+#define FNV_OFFSET_BASIS	0xcbf29ce484222325ULL
+#define FNV_PRIME		0x100000001b3ULL
+
+static u64 align_up(u64 v)
+{
+	return (v + WMSNAP_ALIGN - 1) & ~((u64)WMSNAP_ALIGN - 1);
+}
+
+/*
+ * FNV-1a hash of a whole file, used to detect snapshots that are older
+ * than the config they were generated from.
+ */
+static int hash_file(const char *path, u64 *hash)
+{
+	u8 buf[65536];
+	u64 h = FNV_OFFSET_BASIS;
+	ssize_t len, i;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	while ((len = read(fd, buf, sizeof(buf))) > 0) {
+		for (i = 0; i < len; i++) {
+			h ^= buf[i];
+			h *= FNV_PRIME;
+		}
+	}
+	close(fd);
+	if (len < 0)
+		return -EIO;
+
+	*hash = h;
+	return 0;
+}
+
+bool wmsnap_is_snapshot(const char *path)
+{
+	char magic[sizeof(((struct wmsnap_header *)0)->magic)];
+	bool ret = false;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	if (read(fd, magic, sizeof(magic)) == sizeof(magic))
+		ret = memcmp(magic, WMSNAP_MAGIC, sizeof(magic)) == 0;
+	close(fd);
+	return ret;
+}
+
+bool wmsnap_is_mapped(struct wmediumd *ctx, const void *ptr)
+{
+	const u8 *base = ctx->snapshot_map;
+
+	return base && (const u8 *)ptr >= base &&
+	       (const u8 *)ptr < base + ctx->snapshot_len;
+}
+
+static int write_all(int fd, const void *buf, size_t len)
+{
+	const u8 *p = buf;
+	ssize_t ret;
+
+	while (len) {
+		ret = write(fd, p, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		p += ret;
+		len -= ret;
+	}
+	return 0;
+}
+
+static int write_at(int fd, u64 off, const void *buf, size_t len)
+{
+	if (lseek(fd, off, SEEK_SET) < 0)
+		return -errno;
+	return write_all(fd, buf, len);
+}
+
+int wmsnap_write(struct wmediumd *ctx, const char *path,
+		 const char *config_file)
+{
+	struct wmsnap_header hdr;
+	struct wmsnap_station *stas;
+	char real[PATH_MAX];
+	const char *model;
+	size_t param_size;
+	u64 n = ctx->num_stas;
+	int fd, i, ret;
+
+	if (!config_file)
+		return -EINVAL;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, WMSNAP_MAGIC, sizeof(hdr.magic));
+	hdr.version = WMSNAP_VERSION;
+	hdr.byte_order = WMSNAP_BYTE_ORDER;
+
+	ret = hash_file(config_file, &hdr.config_hash);
+	if (ret)
+		return ret;
+	if (!realpath(config_file, real))
+		return -errno;
+	if (strlen(real) >= sizeof(hdr.config_path))
+		return -ENAMETOOLONG;
+	strcpy(hdr.config_path, real);
+
+	hdr.num_stas = n;
+	hdr.noise_threshold = ctx->noise_threshold;
+	hdr.fading_coefficient = ctx->fading_coefficient;
+	hdr.rng_seed = ctx->rng_seed;
+	if (ctx->error_prob_matrix)
+		hdr.flags |= WMSNAP_F_ERRPROB;
+	if (ctx->intf)
+		hdr.flags |= WMSNAP_F_INTF;
+	if (is_moving_stations(ctx))
+		hdr.flags |= WMSNAP_F_MOVE;
+	if (ctx->enable_medium_detection)
+		hdr.flags |= WMSNAP_F_MEDIUM_DETECTION;
+
+	if (ctx->path_loss_param) {
+		model = get_path_loss_model_name(ctx, &param_size);
+		if (!model || param_size > sizeof(hdr.path_loss_param))
+			return -EINVAL;
+		hdr.flags |= WMSNAP_F_PATH_LOSS;
+		strncpy(hdr.path_loss_model, model,
+			sizeof(hdr.path_loss_model) - 1);
+		hdr.path_loss_param_size = param_size;
+		memcpy(hdr.path_loss_param, ctx->path_loss_param, param_size);
+	}
+
+	hdr.stations_off = align_up(sizeof(hdr));
+	hdr.snr_off = align_up(hdr.stations_off +
+			       n * sizeof(struct wmsnap_station));
+	hdr.errprob_off = align_up(hdr.snr_off + n * n * sizeof(int));
+	hdr.file_size = hdr.errprob_off;
+	if (ctx->error_prob_matrix)
+		hdr.file_size += n * n * sizeof(double);
+
+	stas = calloc(n ? n : 1, sizeof(*stas));
+	if (!stas)
+		return -ENOMEM;
+	for (i = 0; i < ctx->num_stas; i++) {
+		struct station *station = ctx->sta_array[i];
+
+		memcpy(stas[i].addr, station->addr, ETH_ALEN);
+		stas[i].tx_power = station->tx_power;
+		stas[i].gain = station->gain;
+		stas[i].gRandom = station->gRandom;
+		stas[i].isap = station->isap;
+		stas[i].medium_id = station->medium_id;
+		stas[i].x = station->x;
+		stas[i].y = station->y;
+		stas[i].z = station->z;
+		stas[i].dir_x = station->dir_x;
+		stas[i].dir_y = station->dir_y;
+	}
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		free(stas);
+		return -errno;
+	}
+
+	ret = write_at(fd, 0, &hdr, sizeof(hdr));
+	if (!ret)
+		ret = write_at(fd, hdr.stations_off, stas, n * sizeof(*stas));
+	if (!ret)
+		ret = write_at(fd, hdr.snr_off, ctx->snr_matrix,
+			       n * n * sizeof(int));
+	if (!ret && ctx->error_prob_matrix)
+		ret = write_at(fd, hdr.errprob_off, ctx->error_prob_matrix,
+			       n * n * sizeof(double));
+	if (!ret && ftruncate(fd, hdr.file_size))
+		ret = -errno;
+
+	free(stas);
+	if (close(fd) && !ret)
+		ret = -errno;
+	if (ret)
+		unlink(path);
+	return ret;
+}
+
+/* Whether count elements of size bytes at off lie within len bytes */
+static bool section_fits(u64 off, u64 count, u64 size, size_t len)
+{
+	return off <= len && count <= (len - off) / size;
+}
+
+static int validate_header(struct wmediumd *ctx, const struct wmsnap_header *hdr,
+			   size_t len)
+{
+	u64 n = hdr->num_stas;
+	u64 hash;
+
+	if (hdr->version != WMSNAP_VERSION ||
+	    hdr->byte_order != WMSNAP_BYTE_ORDER) {
+		w_flogf(ctx, LOG_ERR, stderr,
+			"Snapshot version or byte order not supported\n");
+		return -EINVAL;
+	}
+
+	/* n is at most 2^32 - 1, so n * n cannot overflow */
+	if (hdr->file_size != len ||
+	    !section_fits(hdr->stations_off, n, sizeof(struct wmsnap_station), len) ||
+	    !section_fits(hdr->snr_off, n * n, sizeof(int), len) ||
+	    ((hdr->flags & WMSNAP_F_ERRPROB) &&
+	     !section_fits(hdr->errprob_off, n * n, sizeof(double), len)) ||
+	    hdr->stations_off % WMSNAP_ALIGN ||
+	    hdr->snr_off % WMSNAP_ALIGN || hdr->errprob_off % WMSNAP_ALIGN ||
+	    hdr->path_loss_param_size > sizeof(hdr->path_loss_param)) {
+		w_flogf(ctx, LOG_ERR, stderr, "Snapshot is truncated or corrupt\n");
+		return -EINVAL;
+	}
+
+	if (memchr(hdr->config_path, 0, sizeof(hdr->config_path)) == NULL ||
+	    memchr(hdr->path_loss_model, 0,
+		   sizeof(hdr->path_loss_model)) == NULL)
+		return -EINVAL;
+
+	if (hash_file(hdr->config_path, &hash)) {
+		w_logf(ctx, LOG_WARNING,
+		       "Config %s of snapshot not found, cannot validate\n",
+		       hdr->config_path);
+	} else if (hash != hdr->config_hash) {
+		w_flogf(ctx, LOG_ERR, stderr,
+			"Snapshot is stale: %s changed since it was written\n",
+			hdr->config_path);
+		return -ESTALE;
+	}
+
+	return 0;
+}
+
+int wmsnap_load(struct wmediumd *ctx, const char *path, const char *per_file)
+{
+	const struct wmsnap_header *hdr;
+	const struct wmsnap_station *stas;
+	struct station *station;
+	struct stat st;
+	void *map;
+	int fd, i, j, ret;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+	if (fstat(fd, &st) || (size_t)st.st_size < sizeof(*hdr)) {
+		close(fd);
+		return -EINVAL;
+	}
+
+	/*
+	 * A private mapping lets the server modify the matrices in place
+	 * without touching the file.
+	 */
+	map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		   fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -errno;
+
+	hdr = map;
+	ret = validate_header(ctx, hdr, st.st_size);
+	if (ret)
+		goto fail;
+
+	ctx->snapshot_map = map;
+	ctx->snapshot_len = st.st_size;
+	ctx->num_stas = hdr->num_stas;
+	ctx->sta_capacity = hdr->num_stas;
+	ctx->noise_threshold = hdr->noise_threshold;
+	ctx->fading_coefficient = hdr->fading_coefficient;
+	ctx->rng_seed = hdr->rng_seed;
+	ctx->enable_medium_detection =
+		!!(hdr->flags & WMSNAP_F_MEDIUM_DETECTION);
+	ctx->snr_matrix = (int *)((u8 *)map + hdr->snr_off);
+	ctx->error_prob_matrix = NULL;
+	if (hdr->flags & WMSNAP_F_ERRPROB)
+		ctx->error_prob_matrix =
+			(double *)((u8 *)map + hdr->errprob_off);
+
+	ctx->path_loss_param = NULL;
+	ctx->calc_path_loss = NULL;
+	if (hdr->flags & WMSNAP_F_PATH_LOSS) {
+		ret = set_path_loss_model(ctx, hdr->path_loss_model,
+					  hdr->path_loss_param,
+					  hdr->path_loss_param_size);
+		if (ret) {
+			w_flogf(ctx, LOG_ERR, stderr,
+				"Unknown path loss model %s in snapshot\n",
+				hdr->path_loss_model);
+			goto fail;
+		}
+	}
+
+	ctx->sta_array = malloc(sizeof(struct station *) * (ctx->num_stas + 1));
+	if (!ctx->sta_array) {
+		ret = -ENOMEM;
+		goto fail;
+	}
+
+	stas = (const struct wmsnap_station *)((u8 *)map + hdr->stations_off);
+	for (i = 0; i < ctx->num_stas; i++) {
+		station = malloc(sizeof(*station));
+		if (!station) {
+			ret = -ENOMEM;
+			goto fail;
+		}
+		memset(station, 0, sizeof(*station));
+		station->index = i;
+		memcpy(station->addr, stas[i].addr, ETH_ALEN);
+		memcpy(station->hwaddr, stas[i].addr, ETH_ALEN);
+		station->tx_power = stas[i].tx_power;
+		station->gain = stas[i].gain;
+		station->gRandom = stas[i].gRandom;
+		station->isap = stas[i].isap;
+		station->medium_id = stas[i].medium_id;
+		station->x = stas[i].x;
+		station->y = stas[i].y;
+		station->z = stas[i].z;
+		station->dir_x = stas[i].dir_x;
+		station->dir_y = stas[i].dir_y;
+		station_init_queues(station);
+		list_add_tail(&station->list, &ctx->stations);
+		ctx->sta_array[i] = station;
+	}
+
+	ctx->intf = NULL;
+	if (hdr->flags & WMSNAP_F_INTF) {
+		ctx->intf = calloc(ctx->num_stas * ctx->num_stas,
+				   sizeof(struct intf_info));
+		if (!ctx->intf) {
+			ret = -ENOMEM;
+			goto fail;
+		}
+		for (i = 0; i < ctx->num_stas; i++)
+			for (j = 0; j < ctx->num_stas; j++)
+				ctx->intf[i * ctx->num_stas + j].signal = -200;
+	}
+
+	init_model_callbacks(ctx, hdr->flags & WMSNAP_F_MOVE);
+
+	ctx->per_matrix = NULL;
+	ctx->per_matrix_row_num = 0;
+	if (per_file && !ctx->error_prob_matrix &&
+	    read_per_file(ctx, per_file)) {
+		ret = -EINVAL;
+		goto fail;
+	}
+
+	w_logf(ctx, LOG_NOTICE, "Loaded snapshot %s: %d stations\n", path,
+	       ctx->num_stas);
+	return 0;
+
+fail:
+	/* the matrices point into the mapping */
+	ctx->snr_matrix = NULL;
+	ctx->error_prob_matrix = NULL;
+	ctx->snapshot_map = NULL;
+	ctx->snapshot_len = 0;
+	munmap(map, st.st_size);
+	return ret;
+}
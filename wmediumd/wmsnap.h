@@ -0,0 +1,113 @@
+/*
+ *	wmediumd, wireless medium simulator for mac80211_hwsim kernel module
+ *
+ *	Binary topology snapshots
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef WMSNAP_H_
+#define WMSNAP_H_
+
+#include "wmediumd.h"
+
+#define WMSNAP_MAGIC		"WMSNAP\r\n"
+#define WMSNAP_VERSION		1
+#define WMSNAP_BYTE_ORDER	0x01020304
+#define WMSNAP_ALIGN		64
+
+#define WMSNAP_F_ERRPROB		(1 << 0)
+#define WMSNAP_F_INTF			(1 << 1)
+#define WMSNAP_F_MOVE			(1 << 2)
+#define WMSNAP_F_MEDIUM_DETECTION	(1 << 3)
+#define WMSNAP_F_PATH_LOSS		(1 << 4)
+
+/*
+ * On-disk layout, in host byte order:
+ *
+ *   struct wmsnap_header
+ *   struct wmsnap_station[num_stas]	at stations_off
+ *   int snr_matrix[num_stas^2]		at snr_off
+ *   double error_prob[num_stas^2]	at errprob_off (WMSNAP_F_ERRPROB)
+ *
+ * All sections are WMSNAP_ALIGN aligned so the matrices can be used
+ * in place from a private file mapping.
+ */
+struct wmsnap_header {
+	char magic[8];
+	u32 version;
+	u32 byte_order;
+	u64 config_hash;		/* FNV-1a of the originating config */
+	char config_path[256];
+	u32 num_stas;
+	u32 flags;
+	int32_t noise_threshold;
+	int32_t fading_coefficient;
+	u64 rng_seed;
+	char path_loss_model[32];
+	u32 path_loss_param_size;
+	u32 reserved;
+	u8 path_loss_param[64];
+	u64 stations_off;
+	u64 snr_off;
+	u64 errprob_off;
+	u64 file_size;
+};
+
+struct wmsnap_station {
+	u8 addr[ETH_ALEN];
+	u8 pad[2];
+	int32_t tx_power;
+	int32_t gain;
+	int32_t gRandom;
+	int32_t isap;
+	int32_t medium_id;
+	double x, y, z;
+	double dir_x, dir_y;
+};
+
+/*
+ * Check whether a file starts with the snapshot magic
+ * @param path The file to check
+ * @return true if it is a snapshot
+ */
+bool wmsnap_is_snapshot(const char *path);
+
+/*
+ * Write the loaded topology of ctx as a snapshot
+ * @param ctx The wmediumd context, loaded from config_file
+ * @param path Where to write the snapshot
+ * @param config_file The config file the topology was loaded from
+ * @return 0 on success otherwise a negative errno value
+ */
+int wmsnap_write(struct wmediumd *ctx, const char *path,
+		 const char *config_file);
+
+/*
+ * Load a snapshot into ctx, mapping the matrices from the file
+ * @param ctx The wmediumd context
+ * @param path The snapshot file
+ * @param per_file Optional PER file, or NULL
+ * @return 0 on success otherwise a negative errno value
+ */
+int wmsnap_load(struct wmediumd *ctx, const char *path, const char *per_file);
+
+/*
+ * Whether ptr points into the mapped snapshot, i.e. must not be freed
+ */
+bool wmsnap_is_mapped(struct wmediumd *ctx, const void *ptr);
+
+#endif /* WMSNAP_H_ */
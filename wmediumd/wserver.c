@@ -26,16 +26,28 @@
 #include <sys/un.h>
 #include <arpa/inet.h>
 #include <pthread.h>
+#include <sys/eventfd.h>
 #include <errno.h>
 #include <event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
 
 #include "wserver.h"
 #include "wmediumd_dynamic.h"
+#include "link_state.h"
 #include "wserver_messages.h"
+#include "wserver_shm.h"
+#include "link_stats.h"
+#include "metrics.h"
+#include "recorder.h"
+#include "probes.h"
 
 
 #define LOG_PREFIX "W_SRV: "
 
+/* Stop reading requests of a client with this much unsent output */
+#define WSERVER_OUTPUT_HIGH_WATER (1 << 20)
+
 /**
  * Global listen socket
  */
@@ -56,6 +68,11 @@ static struct event_base *server_event_base;
  */
 static __sighandler_t old_sig_handler;
 
+/**
+ * Whether handle_sigint is installed
+ */
+static bool sigint_installed;
+
 /**
  * Handle the SIGINT signal
  * @param param The param passed to by signal()
@@ -66,32 +83,285 @@ void handle_sigint(int param) {
     exit(EXIT_SUCCESS);
 }
 
+/**
+ * Queue bytes on the output buffer of the client, unless the request is
+ * quiet and succeeded
+ * @param failed Whether the response reports an error
+ * @return 0 on success otherwise a negative errno value
+ */
+static int reply_bytes(struct request_ctx *ctx, const void *data, size_t len, bool failed) {
+    if (ctx->quiet && !failed) {
+        return WACTION_CONTINUE;
+    }
+    if (evbuffer_add(bufferevent_get_output(ctx->bev), data, len)) {
+        return -ENOMEM;
+    }
+    return WACTION_CONTINUE;
+}
+
+/**
+ * Queue a response for the client. Responses of a batch of requests are
+ * written together once the batch has been processed.
+ * @param ctx The request_ctx context
+ * @param elem The message to send
+ * @param type The response type struct
+ * @return 0 on success otherwise a negative errno value
+ */
+#define wserver_reply(ctx, elem, type) ({ \
+    type packed_; \
+    wserver_pack_msg(&packed_, elem, type); \
+    reply_bytes(ctx, &packed_, sizeof(type), (elem)->update_result != WUPDATE_SUCCESS); \
+})
+
+/**
+ * Queue a bulk response header followed by its entries
+ * @return 0 on success otherwise a negative errno value
+ */
+#define wserver_reply_bulk(ctx, elem, type, entries, count, entrytype) ({ \
+    int ret_ = -ENOMEM; \
+    bool failed_ = false; \
+    for (u32 i_ = 0; i_ < (count); i_++) { \
+        failed_ |= (entries)[i_].update_result != WUPDATE_SUCCESS; \
+    } \
+    u8 *packed_ = malloc(sizeof(type) + sizeof(entrytype) * (count)); \
+    if (packed_) { \
+        size_t len_ = wserver_pack_msg(packed_, elem, type); \
+        len_ += wserver_pack_entries(packed_ + len_, entries, count, entrytype); \
+        ret_ = reply_bytes(ctx, packed_, len_, failed_); \
+        free(packed_); \
+    } \
+    ret_; \
+})
+
+/**
+ * Work deferred to the end of a batch of requests
+ */
+static struct {
+    bool publish; /* link state changed, publish a new snapshot */
+} pending;
+
+/**
+ * Station property updates waiting to be applied together. Only the
+ * latest value of each (station, property) is kept.
+ */
+static struct {
+    struct station_props *updates; /* in order of first arrival */
+    int *results;
+    int num_updates;
+    int capacity;
+    int *slots; /* hash of the address to index + 1 in updates, 2 * capacity entries */
+} coalesced;
+
+/**
+ * Flushes coalesced updates once the update window has passed
+ */
+static struct event *coalesce_timer;
+
 /* Existing link is from from -> to; copy to other dir */
 static void mirror_link_(struct request_ctx *ctx, int from, int to, int signal)
 {
-	ctx->ctx->snr_matrix[ctx->ctx->num_stas * to + from] = signal;
-	ctx->ctx->snr_matrix[ctx->ctx->num_stas * from + to] = signal;
+	ctx->ctx->snr_matrix[ctx->ctx->sta_capacity * to + from] = signal;
+	ctx->ctx->snr_matrix[ctx->ctx->sta_capacity * from + to] = signal;
+}
+
+
+static u8 errno_to_update_result(int err) {
+    switch (err) {
+        case 0:
+            return WUPDATE_SUCCESS;
+        case -EEXIST:
+            return WUPDATE_INTF_DUPLICATE;
+        case -ENODEV:
+            return WUPDATE_INTF_NOTFOUND;
+        default:
+            return WUPDATE_WRONG_MODE;
+    }
+}
+
+static u32 addr_hash(const u8 *addr)
+{
+	u32 hash = 2166136261u;
+	int i;
+
+	for (i = 0; i < ETH_ALEN; i++)
+		hash = (hash ^ addr[i]) * 16777619u;
+	return hash;
+}
+
+/* Find the slot of addr in the coalesced table, or the empty slot for it */
+static int *coalesced_slot(const u8 *addr)
+{
+	u32 mask = coalesced.capacity * 2 - 1;
+	u32 i = addr_hash(addr) & mask;
+
+	while (coalesced.slots[i] &&
+	       memcmp(coalesced.updates[coalesced.slots[i] - 1].addr, addr, ETH_ALEN))
+		i = (i + 1) & mask;
+	return &coalesced.slots[i];
+}
+
+static int grow_coalesced(void)
+{
+	int capacity = coalesced.capacity ? coalesced.capacity * 2 : 64;
+	struct station_props *updates;
+	int *results, *slots, i;
+
+	updates = realloc(coalesced.updates, sizeof(*updates) * capacity);
+	if (!updates)
+		return -ENOMEM;
+	coalesced.updates = updates;
+	results = realloc(coalesced.results, sizeof(*results) * capacity);
+	if (!results)
+		return -ENOMEM;
+	coalesced.results = results;
+	slots = calloc(capacity * 2, sizeof(*slots));
+	if (!slots)
+		return -ENOMEM;
+
+	free(coalesced.slots);
+	coalesced.slots = slots;
+	coalesced.capacity = capacity;
+	for (i = 0; i < coalesced.num_updates; i++)
+		*coalesced_slot(coalesced.updates[i].addr) = i + 1;
+	return 0;
+}
+
+/**
+ * Merge a property update into the coalesced table
+ * @return 0 on success otherwise a negative errno value
+ */
+static int coalesce_update(const struct station_props *props)
+{
+	struct station_props *update;
+	int *slot;
+
+	if (coalesced.num_updates == coalesced.capacity && grow_coalesced())
+		return -ENOMEM;
+
+	slot = coalesced_slot(props->addr);
+	if (!*slot) {
+		update = &coalesced.updates[coalesced.num_updates++];
+		memset(update, 0, sizeof(*update));
+		memcpy(update->addr, props->addr, ETH_ALEN);
+		*slot = coalesced.num_updates;
+	} else {
+		update = &coalesced.updates[*slot - 1];
+	}
+
+	if (props->mask & STATION_PROP_POSITION) {
+		update->x = props->x;
+		update->y = props->y;
+		update->z = props->z;
+	}
+	if (props->mask & STATION_PROP_TXPOWER)
+		update->tx_power = props->tx_power;
+	if (props->mask & STATION_PROP_GAIN)
+		update->gain = props->gain;
+	if (props->mask & STATION_PROP_GAUSSIAN_RANDOM)
+		update->gRandom = props->gRandom;
+	update->mask |= props->mask;
+	return 0;
 }
 
+/**
+ * Publish the link state if requests changed it
+ * @param ctx The wmediumd context
+ */
+static void publish_pending(struct wmediumd *ctx)
+{
+	if (!pending.publish)
+		return;
 
-static void calc_signal(struct request_ctx *ctx)
+	pthread_rwlock_wrlock(&snr_lock);
+	link_state_publish(ctx);
+	pthread_rwlock_unlock(&snr_lock);
+	pending.publish = false;
+}
+
+/**
+ * Apply the coalesced station updates
+ * @param ctx The wmediumd context
+ */
+static void apply_coalesced(struct wmediumd *ctx)
 {
-	int txpower, path_loss, gains, signal, from, to;
-
-	for (from = 0; from < ctx->ctx->num_stas; from++) {
-		for (to = 0; to < ctx->ctx->num_stas; to++) {
-			if (from == to)
-				continue;
-			txpower = ctx->ctx->sta_array[from]->tx_power;
-			if (ctx->ctx->sta_array[to]->isap == 1)
-				txpower = ctx->ctx->sta_array[to]->tx_power;
-			path_loss = ctx->ctx->calc_path_loss(ctx->ctx->path_loss_param,
-					ctx->ctx->sta_array[to], ctx->ctx->sta_array[from]);
-			gains = (txpower + ctx->ctx->sta_array[from]->gain + ctx->ctx->sta_array[to]->gain);
-			signal = gains - path_loss - ctx->ctx->noise_threshold;
-			mirror_link_(ctx, from, to, signal);
-		}
+	if (!coalesced.num_updates)
+		return;
+
+	// publishes the other pending changes as well
+	update_stations(ctx, coalesced.updates, coalesced.num_updates,
+			coalesced.results);
+	for (int i = 0; i < coalesced.num_updates; i++) {
+		if (coalesced.results[i])
+			w_logf(ctx, LOG_INFO, LOG_PREFIX "Station " MAC_FMT
+			       " is gone, dropped its update\n",
+			       MAC_ARGS(coalesced.updates[i].addr));
 	}
+	memset(coalesced.slots, 0, sizeof(int) * coalesced.capacity * 2);
+	coalesced.num_updates = 0;
+	pending.publish = false;
+}
+
+/**
+ * Apply the coalesced station updates and publish everything deferred so far
+ * @param ctx The wmediumd context
+ */
+static void flush_pending(struct wmediumd *ctx)
+{
+	apply_coalesced(ctx);
+	publish_pending(ctx);
+}
+
+static void on_coalesce_timer(int fd, short what, void *ctx) {
+    UNUSED(fd);
+    UNUSED(what);
+    flush_pending(ctx);
+}
+
+/**
+ * Apply or schedule what a batch of requests left pending
+ * @param ctx The wmediumd context
+ */
+static void end_batch(struct wmediumd *ctx) {
+    if (ctx->update_window_ms <= 0) {
+        flush_pending(ctx);
+        return;
+    }
+    // station updates keep being merged until the window has passed
+    publish_pending(ctx);
+    if (coalesced.num_updates && !evtimer_pending(coalesce_timer, NULL)) {
+        struct timeval window = {
+            .tv_sec = ctx->update_window_ms / 1000,
+            .tv_usec = (ctx->update_window_ms % 1000) * 1000,
+        };
+        evtimer_add(coalesce_timer, &window);
+    }
+}
+
+/**
+ * Queue a property change of one station
+ * @param ctx The request_ctx context
+ * @param props The station address and the properties to set
+ * @return A WUPDATE_* constant
+ */
+static u8 queue_station_update(struct request_ctx *ctx, const struct station_props *props) {
+    if (ctx->ctx->error_prob_matrix != NULL) {
+        return WUPDATE_WRONG_MODE;
+    }
+
+    const struct link_state *ls = link_state_acquire(ctx->ctx);
+    bool found = ls && link_state_find(ls, props->addr);
+    link_state_release();
+    if (!found) {
+        return WUPDATE_INTF_NOTFOUND;
+    }
+
+    if (coalesce_update(props)) {
+        // no room to defer it, apply it right away
+        int result;
+        update_stations(ctx->ctx, props, 1, &result);
+        return errno_to_update_result(result);
+    }
+    return WUPDATE_SUCCESS;
 }
 
 /**
@@ -181,11 +451,12 @@ int handle_snr_update_request(struct request_ctx *ctx, const snr_update_request
             mirror_link_(ctx, sender->index, receiver->index, request->snr);
             response.update_result = WUPDATE_SUCCESS;
         }
+        pending.publish = true;
         pthread_rwlock_unlock(&snr_lock);
     } else {
         response.update_result = WUPDATE_WRONG_MODE;
     }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, snr_update_response);
+    int ret = wserver_reply(ctx, &response, snr_update_response);
     if (ret < 0) {
         w_logf(ctx->ctx, LOG_ERR, "Error on SNR update response: %s\n", strerror(abs(ret)));
         return WACTION_ERROR;
@@ -195,127 +466,71 @@ int handle_snr_update_request(struct request_ctx *ctx, const snr_update_request
 
 int handle_position_update_request(struct request_ctx *ctx, const position_update_request *request) {
     position_update_response response;
+    struct station_props props = {
+        .mask = STATION_PROP_POSITION,
+        .x = request->posX,
+        .y = request->posY,
+        .z = request->posZ,
+    };
     response.request = *request;
+    memcpy(props.addr, request->sta_addr, ETH_ALEN);
 
-    if (ctx->ctx->error_prob_matrix == NULL) {
-    	struct station *sender = NULL;
-    	struct station *station;
-
-        pthread_rwlock_wrlock(&snr_lock);
-
-        list_for_each_entry(station, &ctx->ctx->stations, list) {
-			if (memcmp(&request->sta_addr, station->addr, ETH_ALEN) == 0) {
-				sender = station;
-				sender->x = request->posX;
-				sender->y = request->posY;
-				sender->z = request->posZ;
-			}
-        }
-
-        w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Position update: for=" MAC_FMT ", position=%f,%f,%f\n",
-			   MAC_ARGS(request->sta_addr), request->posX, request->posY, request->posZ);
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Position update: for=" MAC_FMT ", position=%f,%f,%f\n",
+           MAC_ARGS(request->sta_addr), request->posX, request->posY, request->posZ);
+    response.update_result = queue_station_update(ctx, &props);
 
-		calc_signal(ctx);
-		response.update_result = WUPDATE_SUCCESS;
-
-        pthread_rwlock_unlock(&snr_lock);
-    } else {
-        response.update_result = WUPDATE_WRONG_MODE;
-    }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, position_update_response);
+    int ret = wserver_reply(ctx, &response, position_update_response);
     return ret;
 }
 
 int handle_txpower_update_request(struct request_ctx *ctx, const txpower_update_request *request) {
     txpower_update_response response;
+    struct station_props props = {
+        .mask = STATION_PROP_TXPOWER,
+        .tx_power = request->txpower_,
+    };
     response.request = *request;
+    memcpy(props.addr, request->sta_addr, ETH_ALEN);
 
-    if (ctx->ctx->error_prob_matrix == NULL) {
-    	struct station *sender = NULL;
-    	struct station *station;
-
-        pthread_rwlock_wrlock(&snr_lock);
-
-        list_for_each_entry(station, &ctx->ctx->stations, list) {
-			if (memcmp(&request->sta_addr, station->addr, ETH_ALEN) == 0) {
-				sender = station;
-				sender->tx_power = request->txpower_;
-			}
-        }
-
-		w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing TxPower update: for=" MAC_FMT ", txpower=%d\n",
-			   MAC_ARGS(request->sta_addr), request->txpower_);
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing TxPower update: for=" MAC_FMT ", txpower=%d\n",
+           MAC_ARGS(request->sta_addr), request->txpower_);
+    response.update_result = queue_station_update(ctx, &props);
 
-		calc_signal(ctx);
-		response.update_result = WUPDATE_SUCCESS;
-
-        pthread_rwlock_unlock(&snr_lock);
-    } else {
-        response.update_result = WUPDATE_WRONG_MODE;
-    }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, txpower_update_response);
+    int ret = wserver_reply(ctx, &response, txpower_update_response);
     return ret;
 }
 
 int handle_gaussian_random_update_request(struct request_ctx *ctx, const gaussian_random_update_request *request) {
-	gaussian_random_update_response response;
+    gaussian_random_update_response response;
+    struct station_props props = {
+        .mask = STATION_PROP_GAUSSIAN_RANDOM,
+        .gRandom = request->gaussian_random_,
+    };
     response.request = *request;
+    memcpy(props.addr, request->sta_addr, ETH_ALEN);
 
-    if (ctx->ctx->error_prob_matrix == NULL) {
-    	struct station *sender = NULL;
-    	struct station *station;
-
-        pthread_rwlock_wrlock(&snr_lock);
-
-        list_for_each_entry(station, &ctx->ctx->stations, list) {
-			if (memcmp(&request->sta_addr, station->addr, ETH_ALEN) == 0) {
-				sender = station;
-				sender->gRandom = request->gaussian_random_;
-			}
-        }
-
-		w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Gaussian Random update: for=" MAC_FMT ", gRandom=%d\n",
-			   MAC_ARGS(request->sta_addr), request->gaussian_random_);
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Gaussian Random update: for=" MAC_FMT ", gRandom=%f\n",
+           MAC_ARGS(request->sta_addr), request->gaussian_random_);
+    response.update_result = queue_station_update(ctx, &props);
 
-		calc_signal(ctx);
-		response.update_result = WUPDATE_SUCCESS;
-
-        pthread_rwlock_unlock(&snr_lock);
-    } else {
-        response.update_result = WUPDATE_WRONG_MODE;
-    }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, gaussian_random_update_response);
+    int ret = wserver_reply(ctx, &response, gaussian_random_update_response);
     return ret;
 }
 
 int handle_gain_update_request(struct request_ctx *ctx, const gain_update_request *request) {
-	gain_update_response response;
+    gain_update_response response;
+    struct station_props props = {
+        .mask = STATION_PROP_GAIN,
+        .gain = request->gain_,
+    };
     response.request = *request;
+    memcpy(props.addr, request->sta_addr, ETH_ALEN);
 
-    if (ctx->ctx->error_prob_matrix == NULL) {
-    	struct station *sender = NULL;
-    	struct station *station;
-
-        pthread_rwlock_wrlock(&snr_lock);
-
-        list_for_each_entry(station, &ctx->ctx->stations, list) {
-			if (memcmp(&request->sta_addr, station->addr, ETH_ALEN) == 0) {
-				sender = station;
-				sender->gain = request->gain_;
-			}
-        }
-
-        w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Gain update: for=" MAC_FMT ", gain=%d\n",
-			   MAC_ARGS(request->sta_addr), request->gain_);
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Gain update: for=" MAC_FMT ", gain=%d\n",
+           MAC_ARGS(request->sta_addr), request->gain_);
+    response.update_result = queue_station_update(ctx, &props);
 
-        calc_signal(ctx);
-		response.update_result = WUPDATE_SUCCESS;
-
-        pthread_rwlock_unlock(&snr_lock);
-    } else {
-        response.update_result = WUPDATE_WRONG_MODE;
-    }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, gain_update_response);
+    int ret = wserver_reply(ctx, &response, gain_update_response);
     return ret;
 }
 
@@ -351,15 +566,16 @@ int handle_errprob_update_request(struct request_ctx *ctx, const errprob_update_
             w_logf(ctx->ctx, LOG_NOTICE,
                    LOG_PREFIX "Performing ERRPROB update: from=" MAC_FMT ", to=" MAC_FMT ", errprob=%f\n",
                    MAC_ARGS(sender->addr), MAC_ARGS(receiver->addr), errprob);
-            ctx->ctx->error_prob_matrix[sender->index * ctx->ctx->num_stas + receiver->index] = errprob;
-            ctx->ctx->error_prob_matrix[receiver->index * ctx->ctx->num_stas + sender->index] = errprob;
+            ctx->ctx->error_prob_matrix[sender->index * ctx->ctx->sta_capacity + receiver->index] = errprob;
+            ctx->ctx->error_prob_matrix[receiver->index * ctx->ctx->sta_capacity + sender->index] = errprob;
             response.update_result = WUPDATE_SUCCESS;
         }
+        pending.publish = true;
         pthread_rwlock_unlock(&snr_lock);
     } else {
         response.update_result = WUPDATE_WRONG_MODE;
     }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, errprob_update_response);
+    int ret = wserver_reply(ctx, &response, errprob_update_response);
     if (ret < 0) {
         w_logf(ctx->ctx, LOG_ERR, "Error on ERRPROB update response: %s\n", strerror(abs(ret)));
         return WACTION_ERROR;
@@ -397,20 +613,16 @@ int handle_specprob_update_request(struct request_ctx *ctx, const specprob_updat
             w_logf(ctx->ctx, LOG_NOTICE,
                    LOG_PREFIX "Performing SPECPROB update: from=" MAC_FMT ", to=" MAC_FMT "\n",
                    MAC_ARGS(sender->addr), MAC_ARGS(receiver->addr));
-            double *specific_mat = malloc(sizeof(double) * SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX);
-            if (!specific_mat) {
+            double specific_mat[SPECIFIC_MATRIX_LEN];
+            for (int i = 0; i < SPECIFIC_MATRIX_LEN; i++) {
+                specific_mat[i] = custom_fixed_point_to_floating_point(request->errprob[i]);
+            }
+            if (set_specific_error_probs(ctx->ctx, sender, receiver, specific_mat)) {
                 w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_specprob_update_request wmediumd/wserver.c\n");
                 // should be different type of error here
                 response.update_result = WUPDATE_WRONG_MODE;
                 goto out;
             }
-            for (int i = 0; i < SPECIFIC_MATRIX_MAX_SIZE_IDX * SPECIFIC_MATRIX_MAX_RATE_IDX; i++) {
-                specific_mat[i] = custom_fixed_point_to_floating_point(request->errprob[i]);
-            }
-            if (ctx->ctx->station_err_matrix[sender->index * ctx->ctx->num_stas + receiver->index] != NULL) {
-                free(ctx->ctx->station_err_matrix[sender->index * ctx->ctx->num_stas + receiver->index]);
-            }
-            ctx->ctx->station_err_matrix[sender->index * ctx->ctx->num_stas + receiver->index] = specific_mat;
             response.update_result = WUPDATE_SUCCESS;
         }
 out:
@@ -418,7 +630,7 @@ out:
     } else {
         response.update_result = WUPDATE_WRONG_MODE;
     }
-    int ret = wserver_send_msg(ctx->sock_fd, &response, specprob_update_response);
+    int ret = wserver_reply(ctx, &response, specprob_update_response);
     if (ret < 0) {
         w_logf(ctx->ctx, LOG_ERR, "Error on SPECPROB update response: %s\n", strerror(abs(ret)));
         return WACTION_ERROR;
@@ -444,7 +656,7 @@ int handle_delete_by_id_request(struct request_ctx *ctx, station_del_by_id_reque
                 "Station with ID %d successfully deleted\n", request->id);
         response.update_result = WUPDATE_SUCCESS;
     }
-    ret = wserver_send_msg(ctx->sock_fd, &response, station_del_by_id_response);
+    ret = wserver_reply(ctx, &response, station_del_by_id_response);
     if (ret < 0) {
         w_logf(ctx->ctx, LOG_ERR, "Error on delete by id response: %s\n", strerror(abs(ret)));
         return WACTION_ERROR;
@@ -470,7 +682,7 @@ int handle_delete_by_mac_request(struct request_ctx *ctx, station_del_by_mac_req
                 "Station with MAC " MAC_FMT " successfully deleted\n", MAC_ARGS(request->addr));
         response.update_result = WUPDATE_SUCCESS;
     }
-    ret = wserver_send_msg(ctx->sock_fd, &response, station_del_by_mac_response);
+    ret = wserver_reply(ctx, &response, station_del_by_mac_response);
     if (ret < 0) {
         w_logf(ctx->ctx, LOG_ERR, "Error on delete by mac response: %s\n", strerror(abs(ret)));
         return WACTION_ERROR;
@@ -498,7 +710,7 @@ int handle_add_request(struct request_ctx *ctx, station_add_request *request) {
         response.created_id = ret;
         response.update_result = WUPDATE_SUCCESS;
     }
-    ret = wserver_send_msg(ctx->sock_fd, &response, station_add_response);
+    ret = wserver_reply(ctx, &response, station_add_response);
     if (ret < 0) {
         w_logf(ctx->ctx, LOG_ERR, "Error on add response: %s\n", strerror(abs(ret)));
         return WACTION_ERROR;
@@ -506,222 +718,1487 @@ int handle_add_request(struct request_ctx *ctx, station_add_request *request) {
     return ret;
 }
 
-int handle_medium_update_request(struct request_ctx *ctx, const medium_update_request *request) {
-    medium_update_response response;
-    response.request = *request;
-    struct station *sender = NULL;
-    struct station *station;
+/**
+ * Convert the WPROP_* fields of a station_bulk_add_entry or
+ * station_update_entry into station_props
+ */
+#define entry_to_station_props(entry, out) \
+    do { \
+        memcpy((out)->addr, (entry)->addr, ETH_ALEN); \
+        (out)->mask = 0; \
+        if ((entry)->props & WPROP_POSITION) { \
+            (out)->mask |= STATION_PROP_POSITION; \
+            (out)->x = (entry)->posX; \
+            (out)->y = (entry)->posY; \
+            (out)->z = (entry)->posZ; \
+        } \
+        if ((entry)->props & WPROP_TXPOWER) { \
+            (out)->mask |= STATION_PROP_TXPOWER; \
+            (out)->tx_power = (entry)->txpower_; \
+        } \
+        if ((entry)->props & WPROP_GAIN) { \
+            (out)->mask |= STATION_PROP_GAIN; \
+            (out)->gain = (entry)->gain_; \
+        } \
+        if ((entry)->props & WPROP_GAUSSIAN_RANDOM) { \
+            (out)->mask |= STATION_PROP_GAUSSIAN_RANDOM; \
+            (out)->gRandom = (entry)->gaussian_random_; \
+        } \
+    } while (0)
+
+int handle_bulk_add_request(struct request_ctx *ctx, const station_bulk_add_request *request,
+                            const station_bulk_add_entry *entries) {
+    station_bulk_add_response response;
+    struct station_props *props = calloc(request->count ? request->count : 1, sizeof(*props));
+    station_bulk_add_result *results = calloc(request->count ? request->count : 1, sizeof(*results));
+    i32 *ids = calloc(request->count ? request->count : 1, sizeof(*ids));
+    int ret;
+
+    if (!props || !results || !ids) {
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_bulk_add_request wmediumd/wserver.c\n");
+        ret = WACTION_ERROR;
+        goto out;
+    }
 
-    list_for_each_entry(station, &ctx->ctx->stations, list) {
-        if (memcmp(&request->sta_addr, station->addr, ETH_ALEN) == 0) {
-            sender = station;
-        }
+    for (u32 i = 0; i < request->count; i++) {
+        entry_to_station_props(&entries[i], &props[i]);
     }
-    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Medium update: for=" MAC_FMT " to #%d\n",
-           MAC_ARGS(request->sta_addr), request->medium_id_);
-    if(sender!=NULL){
-        response.update_result = WUPDATE_SUCCESS;
-        pthread_rwlock_wrlock(&snr_lock);
-        sender->medium_id = request->medium_id_;
-        pthread_rwlock_unlock(&snr_lock);
-    }else{
-        response.update_result = WUPDATE_INTF_NOTFOUND;
+
+    ret = add_stations(ctx->ctx, props, request->count, ids);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on bulk add request: %s\n", strerror(abs(ret)));
+        ret = WACTION_ERROR;
+        goto out;
     }
 
-    int ret = wserver_send_msg(ctx->sock_fd, &response, medium_update_response);
-    return ret;
-}
+    int added = 0;
+    for (u32 i = 0; i < request->count; i++) {
+        results[i].created_id = ids[i] < 0 ? 0 : ids[i];
+        results[i].update_result = errno_to_update_result(ids[i] < 0 ? ids[i] : 0);
+        if (ids[i] >= 0)
+            added++;
+    }
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Added %d of %u stations in bulk\n", added, request->count);
 
-int parse_recv_msg_rest_error(struct wmediumd *ctx, int value) {
-    if (value > 0) {
-        return value;
-    } else {
-        w_logf(ctx, LOG_ERR, "Error on receive msg rest: %s\n", strerror(abs(value)));
-        return WACTION_ERROR;
+    response.count = request->count;
+    ret = wserver_reply_bulk(ctx, &response, station_bulk_add_response,
+                             results, request->count, station_bulk_add_result);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on bulk add response: %s\n", strerror(abs(ret)));
+        ret = WACTION_ERROR;
     }
+
+    out:
+    free(props);
+    free(results);
+    free(ids);
+    return ret;
 }
 
-int receive_handle_request(struct request_ctx *ctx) {
-    wserver_msg base;
-    int recv_type;
-    int ret = wserver_recv_msg_base(ctx->sock_fd, &base, &recv_type);
-    if (ret > 0) {
-        return ret;
-    } else if (ret < 0) {
-        w_logf(ctx->ctx, LOG_ERR, "Error on receive base request: %s\n", strerror(abs(ret)));
-        return WACTION_ERROR;
-    }
-    if (recv_type == WSERVER_SHUTDOWN_REQUEST_TYPE) {
-        return WACTION_CLOSE;
-    } else if (recv_type == WSERVER_SNR_UPDATE_REQUEST_TYPE) {
-        snr_update_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, snr_update_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_snr_update_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_ERRPROB_UPDATE_REQUEST_TYPE) {
-        errprob_update_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, errprob_update_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_errprob_update_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_SPECPROB_UPDATE_REQUEST_TYPE) {
-        specprob_update_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, specprob_update_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_specprob_update_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_DEL_BY_MAC_REQUEST_TYPE) {
-        station_del_by_mac_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, station_del_by_mac_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_delete_by_mac_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_DEL_BY_ID_REQUEST_TYPE) {
-        station_del_by_id_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, station_del_by_id_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_delete_by_id_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_ADD_REQUEST_TYPE) {
-        station_add_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, station_add_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_add_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_POSITION_UPDATE_REQUEST_TYPE) {
-        position_update_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, position_update_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_position_update_request(ctx, &request);
-        }
-    } else if (recv_type == WSERVER_TXPOWER_UPDATE_REQUEST_TYPE) {
-		txpower_update_request request;
-		if ((ret = wserver_recv_msg(ctx->sock_fd, &request, txpower_update_request))) {
-			return parse_recv_msg_rest_error(ctx->ctx, ret);
-		} else {
-			return handle_txpower_update_request(ctx, &request);
-		}
-    } else if (recv_type == WSERVER_GAIN_UPDATE_REQUEST_TYPE) {
-		gain_update_request request;
-		if ((ret = wserver_recv_msg(ctx->sock_fd, &request, gain_update_request))) {
-			return parse_recv_msg_rest_error(ctx->ctx, ret);
-		} else {
-			return handle_gain_update_request(ctx, &request);
-		}
-    } else if (recv_type == WSERVER_GAUSSIAN_RANDOM_UPDATE_REQUEST_TYPE) {
-		gaussian_random_update_request request;
-		if ((ret = wserver_recv_msg(ctx->sock_fd, &request, gaussian_random_update_request))) {
-			return parse_recv_msg_rest_error(ctx->ctx, ret);
-		} else {
-			return handle_gaussian_random_update_request(ctx, &request);
-		}
-    } else if (recv_type == WSERVER_MEDIUM_UPDATE_REQUEST_TYPE) {
-        medium_update_request request;
-        if ((ret = wserver_recv_msg(ctx->sock_fd, &request, medium_update_request))) {
-            return parse_recv_msg_rest_error(ctx->ctx, ret);
-        } else {
-            return handle_medium_update_request(ctx, &request);
-        }
+int handle_bulk_del_request(struct request_ctx *ctx, const station_bulk_del_request *request,
+                            const station_bulk_del_entry *entries) {
+    station_bulk_del_response response;
+    u8 (*addrs)[ETH_ALEN] = calloc(request->count ? request->count : 1, sizeof(*addrs));
+    station_bulk_del_result *results = calloc(request->count ? request->count : 1, sizeof(*results));
+    int *errs = calloc(request->count ? request->count : 1, sizeof(*errs));
+    int ret;
+
+    if (!addrs || !results || !errs) {
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_bulk_del_request wmediumd/wserver.c\n");
+        ret = WACTION_ERROR;
+        goto out;
     }
-    else {
-        return -1;
+
+    for (u32 i = 0; i < request->count; i++) {
+        memcpy(addrs[i], entries[i].addr, ETH_ALEN);
     }
-}
+    del_stations_by_mac(ctx->ctx, (const u8 (*)[ETH_ALEN]) addrs, request->count, errs);
 
-struct accept_context {
-    struct wmediumd *wctx;
-    int server_socket;
-    int client_socket;
-    pthread_t *thread;
-};
+    int deleted = 0;
+    for (u32 i = 0; i < request->count; i++) {
+        results[i].update_result = errno_to_update_result(errs[i]);
+        if (!errs[i])
+            deleted++;
+    }
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Deleted %d of %u stations in bulk\n", deleted, request->count);
 
-void *handle_accepted_connection(void *d_ptr) {
-    struct accept_context *actx = d_ptr;
-    struct request_ctx rctx;
-    rctx.ctx = actx->wctx;
-    rctx.sock_fd = actx->client_socket;
-    w_logf(rctx.ctx, LOG_INFO, LOG_PREFIX "Client connected\n");
-    while (1) {
-        int action_resp;
-        w_logf(rctx.ctx, LOG_INFO, LOG_PREFIX "Waiting for request...\n");
-        action_resp = receive_handle_request(&rctx);
-        if (action_resp == WACTION_DISCONNECTED) {
-            w_logf(rctx.ctx, LOG_INFO, LOG_PREFIX "Client has disconnected\n");
-            break;
-        } else if (action_resp == WACTION_ERROR) {
-            w_logf(rctx.ctx, LOG_INFO, LOG_PREFIX "Disconnecting client because of error\n");
-            break;
-        } else if (action_resp == WACTION_CLOSE) {
-            w_logf(rctx.ctx, LOG_INFO, LOG_PREFIX "Closing server\n");
-            event_base_loopbreak(server_event_base);
-            break;
-        }
+    response.count = request->count;
+    ret = wserver_reply_bulk(ctx, &response, station_bulk_del_response,
+                             results, request->count, station_bulk_del_result);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on bulk delete response: %s\n", strerror(abs(ret)));
+        ret = WACTION_ERROR;
     }
-    close(rctx.sock_fd);
-    free(actx);
-    return NULL;
+
+    out:
+    free(addrs);
+    free(results);
+    free(errs);
+    return ret;
 }
 
-void on_listen_event(int fd, short what, void *wctx) {
-    UNUSED(fd);
-    UNUSED(what);
-    struct accept_context *actx = malloc(sizeof(struct accept_context));
-    if (!actx) {
-        w_logf(wctx, LOG_ERR, "Error during allocation of memory in on_listen_event wmediumd/wserver.c\n");
-        return;
-    }
-    actx->wctx = wctx;
-    actx->server_socket = fd;
-    actx->thread = malloc(sizeof(pthread_t));
-    if (!actx->thread) {
-        w_logf(wctx, LOG_ERR, "Error during allocation of memory in on_listen_event wmediumd/wserver.c\n");
-        free(actx);
-        return;
-    }
-    actx->client_socket = accept_connection(actx->server_socket);
-    if (actx->client_socket < 0) {
-        w_logf(actx->wctx, LOG_ERR, LOG_PREFIX "Accept failed: %s\n", strerror(errno));
-    } else {
-        pthread_create(actx->thread, NULL, handle_accepted_connection, actx);
+/**
+ * Check that the matrix targeted by an upload is in use
+ */
+static bool matrix_in_use(struct wmediumd *ctx, u8 matrix) {
+    switch (matrix) {
+        case WMATRIX_SNR:
+            return ctx->snr_matrix != NULL;
+        case WMATRIX_ERRPROB:
+            return ctx->error_prob_matrix != NULL;
+        default:
+            return false;
     }
 }
 
 /**
- * Run the server using the given wmediumd context
- * @param ctx The wmediumd context
- * @return NULL, required for pthread
+ * Map addresses to matrix indices, -1 for unknown stations
+ * @return The number of unknown stations
  */
-void *run_wserver(void *ctx) {
-    struct event *accept_event;
+static u32 resolve_matrix_addrs(const struct link_state *ls, const matrix_addr_entry *addrs, u32 count,
+                                int *indices) {
+    u32 not_found = 0;
+
+    for (u32 i = 0; i < count; i++) {
+        const struct link_state_station *station = ls ? link_state_find(ls, addrs[i].addr) : NULL;
+        indices[i] = station ? station->index : -1;
+        if (!station)
+            not_found++;
+    }
+    return not_found;
+}
 
-    old_sig_handler = signal(SIGINT, handle_sigint);
+/* Set one link of an uploaded matrix, snr_lock is held for writing */
+static void set_matrix_link(struct wmediumd *ctx, u8 matrix, u8 flags, int from, int to, u32 value)
+{
+	int cap = ctx->sta_capacity;
+
+	if (matrix == WMATRIX_SNR) {
+		ctx->snr_matrix[cap * from + to] = (i32) value;
+		if (flags & WMATRIX_F_SYMMETRIC)
+			ctx->snr_matrix[cap * to + from] = (i32) value;
+	} else {
+		double errprob = custom_fixed_point_to_floating_point(value);
+
+		ctx->error_prob_matrix[cap * from + to] = errprob;
+		if (flags & WMATRIX_F_SYMMETRIC)
+			ctx->error_prob_matrix[cap * to + from] = errprob;
+	}
+}
 
-    listen_soc = create_listen_socket(ctx);
-    if (listen_soc < 0) {
-        return NULL;
-    }
-    w_logf(ctx, LOG_DEBUG, LOG_PREFIX "Listening for incoming connection\n");
+int handle_matrix_rows_request(struct request_ctx *ctx, const matrix_rows_request *request,
+                               const matrix_addr_entry *rows, const matrix_addr_entry *cols,
+                               const matrix_value_entry *values) {
+    matrix_rows_response response = {0};
+    int *indices = malloc(sizeof(int) * (request->num_rows + request->num_cols) + 1);
 
-    evutil_make_socket_nonblocking(listen_soc);
-    server_event_base = event_base_new();
-    accept_event = event_new(server_event_base, listen_soc, EV_READ | EV_PERSIST, on_listen_event, ctx);
-    event_add(accept_event, NULL);
+    if (!indices) {
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_matrix_rows_request wmediumd/wserver.c\n");
+        return WACTION_ERROR;
+    }
 
-    w_logf(ctx, LOG_DEBUG, LOG_PREFIX "Waiting for client to connect...\n");
-    event_base_dispatch(server_event_base);
+    pthread_rwlock_wrlock(&snr_lock);
+    if (!matrix_in_use(ctx->ctx, request->matrix)) {
+        response.update_result = WUPDATE_WRONG_MODE;
+    } else {
+        const struct link_state *ls = link_state_acquire(ctx->ctx);
+        int *row_idx = indices, *col_idx = indices + request->num_rows;
+
+        response.not_found = resolve_matrix_addrs(ls, rows, request->num_rows, row_idx);
+        response.not_found += resolve_matrix_addrs(ls, cols, request->num_cols, col_idx);
+        link_state_release();
+
+        for (u32 r = 0; r < request->num_rows; r++) {
+            if (row_idx[r] < 0)
+                continue;
+            const matrix_value_entry *row = values + (size_t) r * request->num_cols;
+            for (u32 c = 0; c < request->num_cols; c++) {
+                if (col_idx[c] < 0)
+                    continue;
+                set_matrix_link(ctx->ctx, request->matrix, request->flags, row_idx[r], col_idx[c], row[c].value);
+                response.applied++;
+            }
+        }
+        response.update_result = response.not_found ? WUPDATE_INTF_NOTFOUND : WUPDATE_SUCCESS;
+        pending.publish = true;
+    }
+    pthread_rwlock_unlock(&snr_lock);
+    free(indices);
 
-    event_free(accept_event);
-    event_base_free(server_event_base);
-    stop_wserver();
-    return NULL;
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Uploaded %u links of a %ux%u matrix, %u unknown stations\n",
+           response.applied, request->num_rows, request->num_cols, response.not_found);
+    int ret = wserver_reply(ctx, &response, matrix_rows_response);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on matrix rows response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+int handle_matrix_triplets_request(struct request_ctx *ctx, const matrix_triplets_request *request,
+                                   const matrix_triplet_entry *entries) {
+    matrix_triplets_response response = {0};
+
+    pthread_rwlock_wrlock(&snr_lock);
+    if (!matrix_in_use(ctx->ctx, request->matrix)) {
+        response.update_result = WUPDATE_WRONG_MODE;
+    } else {
+        const struct link_state *ls = link_state_acquire(ctx->ctx);
+
+        for (u32 i = 0; i < request->count; i++) {
+            const struct link_state_station *from = ls ? link_state_find(ls, entries[i].from_addr) : NULL;
+            const struct link_state_station *to = ls ? link_state_find(ls, entries[i].to_addr) : NULL;
+            if (!from || !to) {
+                response.not_found++;
+                continue;
+            }
+            set_matrix_link(ctx->ctx, request->matrix, request->flags, from->index, to->index, entries[i].value);
+            response.applied++;
+        }
+        link_state_release();
+        response.update_result = response.not_found ? WUPDATE_INTF_NOTFOUND : WUPDATE_SUCCESS;
+        pending.publish = true;
+    }
+    pthread_rwlock_unlock(&snr_lock);
+
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Uploaded %u of %u links\n", response.applied, request->count);
+    int ret = wserver_reply(ctx, &response, matrix_triplets_response);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on matrix triplets response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+int handle_station_update_request(struct request_ctx *ctx, const station_update_request *request,
+                                  const station_update_entry *entries) {
+    station_update_response response;
+    struct station_props *props = calloc(request->count ? request->count : 1, sizeof(*props));
+    station_update_result *results = calloc(request->count ? request->count : 1, sizeof(*results));
+    int *errs = calloc(request->count ? request->count : 1, sizeof(*errs));
+    int ret;
+
+    if (!props || !results || !errs) {
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_station_update_request wmediumd/wserver.c\n");
+        ret = WACTION_ERROR;
+        goto out;
+    }
+
+    if (ctx->ctx->error_prob_matrix == NULL) {
+        for (u32 i = 0; i < request->count; i++) {
+            entry_to_station_props(&entries[i], &props[i]);
+        }
+        ret = update_stations(ctx->ctx, props, request->count, errs);
+        if (ret < 0) {
+            w_logf(ctx->ctx, LOG_ERR, "Error on station update request: %s\n", strerror(abs(ret)));
+            ret = WACTION_ERROR;
+            goto out;
+        }
+        for (u32 i = 0; i < request->count; i++) {
+            results[i].update_result = errno_to_update_result(errs[i]);
+        }
+        w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing update of %u stations\n", request->count);
+    } else {
+        for (u32 i = 0; i < request->count; i++) {
+            results[i].update_result = WUPDATE_WRONG_MODE;
+        }
+    }
+
+    response.count = request->count;
+    ret = wserver_reply_bulk(ctx, &response, station_update_response,
+                             results, request->count, station_update_result);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on station update response: %s\n", strerror(abs(ret)));
+        ret = WACTION_ERROR;
+    }
+
+    out:
+    free(props);
+    free(results);
+    free(errs);
+    return ret;
+}
+
+int handle_link_query_request(struct request_ctx *ctx, const link_query_request *request) {
+    link_query_response response = {0};
+    response.request = *request;
+
+    const struct link_state *ls = link_state_acquire(ctx->ctx);
+    const struct link_state_station *from = ls ? link_state_find(ls, request->from_addr) : NULL;
+    const struct link_state_station *to = ls ? link_state_find(ls, request->to_addr) : NULL;
+    if (!from || !to) {
+        response.update_result = WUPDATE_INTF_NOTFOUND;
+    } else {
+        response.version = ls->version;
+        response.snr = link_state_snr(ls, from, to);
+        if (ls->error_prob_matrix) {
+            response.errprob = custom_floating_point_to_fixed_point(
+                    ls->error_prob_matrix[from->index * ls->num_slots + to->index]);
+        }
+        response.update_result = WUPDATE_SUCCESS;
+    }
+    link_state_release();
+
+    // queries are answered even when quiet
+    ctx->quiet = false;
+    int ret = wserver_reply(ctx, &response, link_query_response);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on link query response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+/* Value of a link in a matrix query, in the representation of the upload */
+static u32 matrix_query_value(const struct link_state *ls, u8 matrix, int from, int to)
+{
+	size_t offset = (size_t) from * ls->num_slots + to;
+
+	if (matrix == WMATRIX_SNR)
+		return (u32) ls->snr_matrix[offset];
+	return custom_floating_point_to_fixed_point(ls->error_prob_matrix[offset]);
+}
+
+int handle_matrix_query_request(struct request_ctx *ctx, const matrix_query_request *request,
+                                const matrix_addr_entry *rows) {
+    matrix_query_response response = {0};
+    const struct link_state_station **row_stations = NULL;
+    matrix_value_entry *values = NULL;
+    u8 *packed = NULL;
+    int ret = WACTION_ERROR;
+
+    response.matrix = request->matrix;
+    const struct link_state *ls = link_state_acquire(ctx->ctx);
+    if (!ls || (request->matrix == WMATRIX_SNR && !ls->snr_matrix) ||
+        (request->matrix == WMATRIX_ERRPROB && !ls->error_prob_matrix) ||
+        request->matrix > WMATRIX_ERRPROB) {
+        response.update_result = WUPDATE_WRONG_MODE;
+        link_state_release();
+        ctx->quiet = false;
+        ret = wserver_reply(ctx, &response, matrix_query_response);
+        goto out_reply;
+    }
+
+    u32 wanted = request->num_rows ? request->num_rows : (u32) ls->num_stas;
+    row_stations = malloc(sizeof(*row_stations) * wanted + 1);
+    if (!row_stations)
+        goto out_release;
+    for (u32 i = 0; i < wanted; i++) {
+        const struct link_state_station *station = request->num_rows ?
+                link_state_find(ls, rows[i].addr) : &ls->stations[i];
+        if (station) {
+            row_stations[response.num_rows++] = station;
+        } else {
+            response.not_found++;
+        }
+    }
+    response.version = ls->version;
+    response.num_cols = ls->num_stas;
+    response.update_result = response.not_found ? WUPDATE_INTF_NOTFOUND : WUPDATE_SUCCESS;
+
+    size_t num_values = (size_t) response.num_rows * response.num_cols;
+    values = malloc(sizeof(*values) * num_values + 1);
+    packed = malloc(sizeof(matrix_query_response) +
+                    sizeof(matrix_addr_entry) * (response.num_rows + response.num_cols) +
+                    sizeof(matrix_value_entry) * num_values);
+    if (!values || !packed)
+        goto out_release;
+
+    size_t len = wserver_pack_msg(packed, &response, matrix_query_response);
+    for (u32 r = 0; r < response.num_rows; r++) {
+        memcpy(packed + len, row_stations[r]->addr, ETH_ALEN);
+        len += sizeof(matrix_addr_entry);
+    }
+    for (u32 c = 0; c < response.num_cols; c++) {
+        memcpy(packed + len, ls->stations[c].addr, ETH_ALEN);
+        len += sizeof(matrix_addr_entry);
+    }
+    for (u32 r = 0; r < response.num_rows; r++) {
+        matrix_value_entry *row = values + (size_t) r * response.num_cols;
+        for (u32 c = 0; c < response.num_cols; c++) {
+            row[c].value = matrix_query_value(ls, request->matrix, row_stations[r]->index,
+                                              ls->stations[c].index);
+        }
+    }
+    link_state_release();
+    len += wserver_pack_entries(packed + len, values, num_values, matrix_value_entry);
+
+    // queries are answered even when quiet
+    ret = reply_bytes(ctx, packed, len, true);
+    goto out_reply;
+
+    out_release:
+    link_state_release();
+    w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_matrix_query_request wmediumd/wserver.c\n");
+    out_reply:
+    free(row_stations);
+    free(values);
+    free(packed);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on matrix query response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+int handle_station_query_request(struct request_ctx *ctx, const station_query_request *request,
+                                 const matrix_addr_entry *addrs) {
+    station_query_response response = {0};
+    station_info_entry *infos = NULL;
+    int ret;
+
+    const struct link_state *ls = link_state_acquire(ctx->ctx);
+    response.count = request->count ? request->count : (ls ? (u32) ls->num_stas : 0);
+    response.version = ls ? ls->version : 0;
+    infos = calloc(response.count ? response.count : 1, sizeof(*infos));
+    if (!infos) {
+        link_state_release();
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_station_query_request wmediumd/wserver.c\n");
+        return WACTION_ERROR;
+    }
+    for (u32 i = 0; i < response.count; i++) {
+        const struct link_state_station *station = !request->count ? &ls->stations[i] :
+                ls ? link_state_find(ls, addrs[i].addr) : NULL;
+        if (!station) {
+            memcpy(infos[i].addr, addrs[i].addr, ETH_ALEN);
+            infos[i].update_result = WUPDATE_INTF_NOTFOUND;
+            continue;
+        }
+        memcpy(infos[i].addr, station->addr, ETH_ALEN);
+        infos[i].update_result = WUPDATE_SUCCESS;
+        infos[i].posX = station->x;
+        infos[i].posY = station->y;
+        infos[i].posZ = station->z;
+        infos[i].txpower_ = station->tx_power;
+        infos[i].gain_ = station->gain;
+        infos[i].gaussian_random_ = station->gRandom;
+        infos[i].isap = station->isap;
+        infos[i].medium_id_ = station->medium_id;
+    }
+    link_state_release();
+
+    // queries are answered even when quiet
+    ctx->quiet = false;
+    ret = wserver_reply_bulk(ctx, &response, station_query_response,
+                             infos, response.count, station_info_entry);
+    free(infos);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on station query response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+static int compare_addr_entry(const void *a, const void *b) {
+    return memcmp(a, b, ETH_ALEN);
+}
+
+int handle_link_stats_request(struct request_ctx *ctx, const link_stats_request *request,
+                              const matrix_addr_entry *senders) {
+    link_stats_response response = {0};
+    link_stats_entry *entries = NULL;
+    matrix_addr_entry *sorted = NULL;
+    struct link_stats *stats;
+    int ret;
+
+    int num = link_stats_collect(&stats);
+    if (num < 0 || (request->count && !(sorted = malloc(sizeof(*sorted) * request->count)))) {
+        if (num >= 0)
+            free(stats);
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_link_stats_request wmediumd/wserver.c\n");
+        return WACTION_ERROR;
+    }
+    if (request->count) {
+        memcpy(sorted, senders, sizeof(*sorted) * request->count);
+        qsort(sorted, request->count, sizeof(*sorted), compare_addr_entry);
+    }
+
+    entries = malloc(sizeof(*entries) * (num ? num : 1));
+    if (!entries) {
+        free(stats);
+        free(sorted);
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_link_stats_request wmediumd/wserver.c\n");
+        return WACTION_ERROR;
+    }
+    for (int i = 0; i < num; i++) {
+        if (request->count && !bsearch(stats[i].src, sorted, request->count, sizeof(*sorted), compare_addr_entry))
+            continue;
+        response.total++;
+        if (response.count == WSERVER_LINK_STATS_MAX_ENTRIES)
+            continue;
+        link_stats_entry *entry = &entries[response.count++];
+        memcpy(entry->from_addr, stats[i].src, ETH_ALEN);
+        memcpy(entry->to_addr, stats[i].dst, ETH_ALEN);
+        entry->frames = stats[i].c.frames;
+        entry->acked = stats[i].c.acked;
+        entry->failed = stats[i].c.failed;
+        entry->retries = stats[i].c.retries;
+        entry->bytes = stats[i].c.bytes;
+        entry->airtime = stats[i].c.airtime;
+        entry->update_result = WUPDATE_SUCCESS;
+    }
+    free(stats);
+    free(sorted);
+
+    // queries are answered even when quiet
+    ctx->quiet = false;
+    ret = wserver_reply_bulk(ctx, &response, link_stats_response,
+                             entries, response.count, link_stats_entry);
+    free(entries);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on link stats response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+int handle_metrics_request(struct request_ctx *ctx, const metrics_request *request) {
+    metrics_stage_entry entries[METRICS_NUM_STAGES * (IEEE80211_NUM_ACS + 1)];
+    metrics_response response = {0};
+    struct metrics_summary summary;
+    UNUSED(request);
+
+    response.frames = metrics_counter_value(METRICS_FRAMES);
+    response.dropped = metrics_counter_value(METRICS_DROPPED);
+    response.global_errors = metrics_counter_value(METRICS_GLOBAL_ERRORS);
+    response.tx_status_errors = metrics_counter_value(METRICS_TX_STATUS_ERRORS);
+    for (int stage = 0; stage < METRICS_NUM_STAGES; stage++) {
+        for (int ac = METRICS_ALL_ACS; ac >= 0; ac--) {
+            metrics_summarize(stage, ac, &summary);
+            if (ac != METRICS_ALL_ACS && !summary.count) {
+                continue;
+            }
+            metrics_stage_entry *entry = &entries[response.count++];
+            entry->stage = stage;
+            entry->ac = ac == METRICS_ALL_ACS ? 0xff : ac;
+            entry->count = summary.count;
+            entry->sum = summary.sum;
+            entry->max = summary.max;
+            entry->p50 = summary.p50;
+            entry->p90 = summary.p90;
+            entry->p99 = summary.p99;
+            entry->p999 = summary.p999;
+            entry->update_result = WUPDATE_SUCCESS;
+        }
+    }
+
+    // queries are answered even when quiet
+    ctx->quiet = false;
+    int ret = wserver_reply_bulk(ctx, &response, metrics_response, entries, response.count,
+                                 metrics_stage_entry);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on metrics response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+int handle_recorder_request(struct request_ctx *ctx, const recorder_request *request) {
+    recorder_response response = {0};
+    struct recorder_event *events;
+    recorder_entry *entries;
+    u64 total;
+    int max = request->max && request->max < RECORDER_SIZE ? (int)request->max : RECORDER_SIZE;
+
+    events = malloc(sizeof(*events) * max);
+    entries = malloc(sizeof(*entries) * max);
+    if (!events || !entries) {
+        free(events);
+        free(entries);
+        w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_recorder_request wmediumd/wserver.c\n");
+        return WACTION_ERROR;
+    }
+
+    response.count = recorder_snapshot(events, max, &total);
+    response.total = total;
+    for (u32 i = 0; i < response.count; i++) {
+        const struct recorder_event *event = &events[i];
+        recorder_entry *entry = &entries[i];
+
+        entry->cookie = event->cookie;
+        entry->received = event->marks[METRICS_MARK_RECEIVED];
+        entry->parsed = event->marks[METRICS_MARK_PARSED];
+        entry->sent = event->marks[METRICS_MARK_SENT];
+        entry->replied = event->marks[METRICS_MARK_REPLIED];
+        entry->status_sent = event->marks[METRICS_MARK_STATUS_SENT];
+        memcpy(entry->sender_addr, event->sender, ETH_ALEN);
+        memcpy(entry->receiver_addr, event->receiver, ETH_ALEN);
+        entry->freq = event->freq;
+        entry->signal = event->signal;
+        entry->flags = event->flags;
+        entry->data_len = event->data_len;
+        entry->rate_idx = event->rate_idx;
+        entry->attempts = event->attempts;
+        entry->ac = event->ac;
+        entry->outcome = event->outcome;
+        entry->update_result = WUPDATE_SUCCESS;
+    }
+    free(events);
+
+    // queries are answered even when quiet
+    ctx->quiet = false;
+    int ret = wserver_reply_bulk(ctx, &response, recorder_response, entries, response.count,
+                                 recorder_entry);
+    free(entries);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on recorder response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+int handle_medium_update_request(struct request_ctx *ctx, const medium_update_request *request) {
+    medium_update_response response;
+    response.request = *request;
+    struct station *sender = NULL;
+    struct station *station;
+
+    list_for_each_entry(station, &ctx->ctx->stations, list) {
+        if (memcmp(&request->sta_addr, station->addr, ETH_ALEN) == 0) {
+            sender = station;
+        }
+    }
+    w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Performing Medium update: for=" MAC_FMT " to #%d\n",
+           MAC_ARGS(request->sta_addr), request->medium_id_);
+    if(sender!=NULL){
+        response.update_result = WUPDATE_SUCCESS;
+        pthread_rwlock_wrlock(&snr_lock);
+        sender->medium_id = request->medium_id_;
+        pending.publish = true;
+        pthread_rwlock_unlock(&snr_lock);
+    }else{
+        response.update_result = WUPDATE_INTF_NOTFOUND;
+    }
+
+    int ret = wserver_reply(ctx, &response, medium_update_response);
+    return ret;
+}
+
+/**
+ * Size of the request at the head of a connection's input buffer
+ * @param in The input buffer
+ * @return The size, 0 if the request is incomplete or -1 if it is invalid
+ */
+static ssize_t pending_request_size(struct evbuffer *in) {
+    size_t avail = evbuffer_get_length(in);
+    u8 type;
+
+    if (avail < sizeof(wserver_msg)) {
+        return 0;
+    }
+    evbuffer_copyout(in, &type, sizeof(type));
+    type &= WSERVER_TYPE_MASK;
+    ssize_t size = get_msg_size_by_type(type);
+    if (size < 0) {
+        return -1;
+    }
+
+    if (avail < (size_t) size) {
+        return 0;
+    }
+
+    // bulk requests announce the number of entries in their header
+    u8 header[size];
+    evbuffer_copyout(in, header, size);
+    switch (type) {
+        case WSERVER_BULK_ADD_REQUEST_TYPE:
+        case WSERVER_BULK_DEL_REQUEST_TYPE: {
+            station_bulk_add_request bulk;
+            wserver_unpack_msg(header, &bulk, station_bulk_add_request);
+            if (bulk.count > WSERVER_BULK_MAX_STATIONS) {
+                return -1;
+            }
+            if (type == WSERVER_BULK_ADD_REQUEST_TYPE) {
+                size += bulk.count * sizeof(station_bulk_add_entry);
+            } else {
+                size += bulk.count * sizeof(station_bulk_del_entry);
+            }
+            break;
+        }
+        case WSERVER_STATION_UPDATE_REQUEST_TYPE: {
+            station_update_request update;
+            wserver_unpack_msg(header, &update, station_update_request);
+            if (update.count > WSERVER_BULK_MAX_STATIONS) {
+                return -1;
+            }
+            size += update.count * sizeof(station_update_entry);
+            break;
+        }
+        case WSERVER_MATRIX_ROWS_REQUEST_TYPE: {
+            matrix_rows_request rows;
+            wserver_unpack_msg(header, &rows, matrix_rows_request);
+            if (rows.num_rows > WSERVER_BULK_MAX_STATIONS || rows.num_cols > WSERVER_BULK_MAX_STATIONS ||
+                (u64) rows.num_rows * rows.num_cols > WSERVER_MATRIX_MAX_CELLS) {
+                return -1;
+            }
+            size += (rows.num_rows + rows.num_cols) * sizeof(matrix_addr_entry);
+            size += rows.num_rows * rows.num_cols * sizeof(matrix_value_entry);
+            break;
+        }
+        case WSERVER_MATRIX_QUERY_REQUEST_TYPE:
+        case WSERVER_STATION_QUERY_REQUEST_TYPE:
+        case WSERVER_LINK_STATS_REQUEST_TYPE: {
+            u32 count;
+            if (type == WSERVER_MATRIX_QUERY_REQUEST_TYPE) {
+                matrix_query_request query;
+                wserver_unpack_msg(header, &query, matrix_query_request);
+                count = query.num_rows;
+            } else if (type == WSERVER_LINK_STATS_REQUEST_TYPE) {
+                link_stats_request query;
+                wserver_unpack_msg(header, &query, link_stats_request);
+                count = query.count;
+            } else {
+                station_query_request query;
+                wserver_unpack_msg(header, &query, station_query_request);
+                count = query.count;
+            }
+            if (count > WSERVER_BULK_MAX_STATIONS) {
+                return -1;
+            }
+            size += count * sizeof(matrix_addr_entry);
+            break;
+        }
+        case WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE: {
+            matrix_triplets_request triplets;
+            wserver_unpack_msg(header, &triplets, matrix_triplets_request);
+            if (triplets.count > WSERVER_MATRIX_MAX_CELLS) {
+                return -1;
+            }
+            size += triplets.count * sizeof(matrix_triplet_entry);
+            break;
+        }
+        default:
+            break;
+    }
+    return avail < (size_t) size ? 0 : size;
+}
+
+#define dispatch_request(ctx, data, type, handler) \
+    do { \
+        type request_; \
+        wserver_unpack_msg(data, &request_, type); \
+        return handler(ctx, &request_); \
+    } while (0)
+
+#define dispatch_bulk_request(ctx, data, type, entrytype, handler) \
+    do { \
+        type request_; \
+        size_t header_ = wserver_unpack_msg(data, &request_, type); \
+        entrytype *entries_ = malloc(sizeof(entrytype) * request_.count + 1); \
+        if (!entries_) { \
+            return WACTION_ERROR; \
+        } \
+        wserver_unpack_entries(data + header_, entries_, request_.count, entrytype); \
+        int ret_ = handler(ctx, &request_, entries_); \
+        free(entries_); \
+        return ret_; \
+    } while (0)
+
+static int dispatch_matrix_rows_request(struct request_ctx *ctx, const u8 *data) {
+    matrix_rows_request request;
+    const u8 *pos = data + wserver_unpack_msg(data, &request, matrix_rows_request);
+    u32 num_addrs = request.num_rows + request.num_cols;
+    u32 num_values = request.num_rows * request.num_cols;
+    matrix_addr_entry *addrs = malloc(sizeof(matrix_addr_entry) * num_addrs + 1);
+    matrix_value_entry *values = malloc(sizeof(matrix_value_entry) * num_values + 1);
+    int ret = WACTION_ERROR;
+
+    if (addrs && values) {
+        pos += wserver_unpack_entries(pos, addrs, num_addrs, matrix_addr_entry);
+        wserver_unpack_entries(pos, values, num_values, matrix_value_entry);
+        ret = handle_matrix_rows_request(ctx, &request, addrs, addrs + request.num_rows, values);
+    }
+    free(addrs);
+    free(values);
+    return ret;
+}
+
+/**
+ * Handle one complete request
+ * @param ctx The request_ctx context
+ * @param data The request in network byte order, as sized by pending_request_size()
+ * @return A WACTION_* constant, or a negative errno value
+ */
+int handle_request(struct request_ctx *ctx, const u8 *data) {
+    u8 type = data[0] & WSERVER_TYPE_MASK;
+
+    ctx->quiet = data[0] & WSERVER_FLAG_QUIET;
+    switch (type) {
+        case WSERVER_POSITION_UPDATE_REQUEST_TYPE:
+        case WSERVER_TXPOWER_UPDATE_REQUEST_TYPE:
+        case WSERVER_GAIN_UPDATE_REQUEST_TYPE:
+        case WSERVER_GAUSSIAN_RANDOM_UPDATE_REQUEST_TYPE:
+        case WSERVER_MEDIUM_UPDATE_REQUEST_TYPE:
+            // only touch station properties, can share one recomputation
+            break;
+        case WSERVER_DEL_BY_MAC_REQUEST_TYPE:
+        case WSERVER_DEL_BY_ID_REQUEST_TYPE:
+        case WSERVER_BULK_DEL_REQUEST_TYPE:
+            // pending updates of the removed stations are dropped once applied
+            break;
+        case WSERVER_LINK_QUERY_REQUEST_TYPE:
+        case WSERVER_MATRIX_QUERY_REQUEST_TYPE:
+        case WSERVER_STATION_QUERY_REQUEST_TYPE:
+        case WSERVER_SUBSCRIBE_REQUEST_TYPE:
+        case WSERVER_SHM_ATTACH_REQUEST_TYPE:
+            // answered from the published snapshot, which must include earlier requests
+            flush_pending(ctx->ctx);
+            break;
+        default:
+            // may write the link matrices: apply earlier updates first, publish once the batch ends
+            apply_coalesced(ctx->ctx);
+    }
+
+    switch (type) {
+        case WSERVER_SHUTDOWN_REQUEST_TYPE:
+            return WACTION_CLOSE;
+        case WSERVER_SNR_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, snr_update_request, handle_snr_update_request);
+        case WSERVER_ERRPROB_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, errprob_update_request, handle_errprob_update_request);
+        case WSERVER_SPECPROB_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, specprob_update_request, handle_specprob_update_request);
+        case WSERVER_DEL_BY_MAC_REQUEST_TYPE:
+            dispatch_request(ctx, data, station_del_by_mac_request, handle_delete_by_mac_request);
+        case WSERVER_DEL_BY_ID_REQUEST_TYPE:
+            dispatch_request(ctx, data, station_del_by_id_request, handle_delete_by_id_request);
+        case WSERVER_ADD_REQUEST_TYPE:
+            dispatch_request(ctx, data, station_add_request, handle_add_request);
+        case WSERVER_POSITION_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, position_update_request, handle_position_update_request);
+        case WSERVER_TXPOWER_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, txpower_update_request, handle_txpower_update_request);
+        case WSERVER_GAIN_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, gain_update_request, handle_gain_update_request);
+        case WSERVER_GAUSSIAN_RANDOM_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, gaussian_random_update_request, handle_gaussian_random_update_request);
+        case WSERVER_MEDIUM_UPDATE_REQUEST_TYPE:
+            dispatch_request(ctx, data, medium_update_request, handle_medium_update_request);
+        case WSERVER_BULK_ADD_REQUEST_TYPE:
+            dispatch_bulk_request(ctx, data, station_bulk_add_request, station_bulk_add_entry,
+                                  handle_bulk_add_request);
+        case WSERVER_BULK_DEL_REQUEST_TYPE:
+            dispatch_bulk_request(ctx, data, station_bulk_del_request, station_bulk_del_entry,
+                                  handle_bulk_del_request);
+        case WSERVER_STATION_UPDATE_REQUEST_TYPE:
+            dispatch_bulk_request(ctx, data, station_update_request, station_update_entry,
+                                  handle_station_update_request);
+        case WSERVER_LINK_QUERY_REQUEST_TYPE:
+            dispatch_request(ctx, data, link_query_request, handle_link_query_request);
+        case WSERVER_MATRIX_QUERY_REQUEST_TYPE: {
+            matrix_query_request request_;
+            size_t header_ = wserver_unpack_msg(data, &request_, matrix_query_request);
+            matrix_addr_entry *rows_ = malloc(sizeof(matrix_addr_entry) * request_.num_rows + 1);
+            if (!rows_) {
+                return WACTION_ERROR;
+            }
+            wserver_unpack_entries(data + header_, rows_, request_.num_rows, matrix_addr_entry);
+            int ret_ = handle_matrix_query_request(ctx, &request_, rows_);
+            free(rows_);
+            return ret_;
+        }
+        case WSERVER_STATION_QUERY_REQUEST_TYPE:
+            dispatch_bulk_request(ctx, data, station_query_request, matrix_addr_entry,
+                                  handle_station_query_request);
+        case WSERVER_LINK_STATS_REQUEST_TYPE:
+            dispatch_bulk_request(ctx, data, link_stats_request, matrix_addr_entry,
+                                  handle_link_stats_request);
+        case WSERVER_METRICS_REQUEST_TYPE:
+            dispatch_request(ctx, data, metrics_request, handle_metrics_request);
+        case WSERVER_RECORDER_REQUEST_TYPE:
+            dispatch_request(ctx, data, recorder_request, handle_recorder_request);
+        case WSERVER_SUBSCRIBE_REQUEST_TYPE:
+            dispatch_request(ctx, data, subscribe_request, handle_subscribe_request);
+        case WSERVER_SHM_ATTACH_REQUEST_TYPE:
+            dispatch_request(ctx, data, shm_attach_request, handle_shm_attach_request);
+        case WSERVER_MATRIX_ROWS_REQUEST_TYPE:
+            return dispatch_matrix_rows_request(ctx, data);
+        case WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE:
+            dispatch_bulk_request(ctx, data, matrix_triplets_request, matrix_triplet_entry,
+                                  handle_matrix_triplets_request);
+        default:
+            w_logf(ctx->ctx, LOG_ERR, LOG_PREFIX "Unsupported request type %d\n", type);
+            return WACTION_ERROR;
+    }
+}
+
+/**
+ * The links a subscriber was last told about
+ */
+struct link_baseline {
+    u64 version;
+    int num_stas;
+    u8 (*addrs)[ETH_ALEN]; /* sorted */
+    i32 *snr; /* num_stas x num_stas */
+};
+
+/**
+ * A connected client, owned by the server event loop
+ */
+struct client_conn {
+    struct request_ctx rctx;
+    struct list_head list;
+    struct link_baseline *baseline; /* set while subscribed */
+    int threshold;
+    struct wserver_shm *shm; /* set while attached */
+};
+
+/**
+ * All connected clients
+ */
+static struct list_head clients;
+
+static void free_baseline(struct link_baseline *baseline) {
+    if (!baseline)
+        return;
+    free(baseline->addrs);
+    free(baseline->snr);
+    free(baseline);
+}
+
+static struct link_baseline *alloc_baseline(int num_stas) {
+    struct link_baseline *baseline = calloc(1, sizeof(*baseline));
+
+    if (!baseline)
+        return NULL;
+    baseline->num_stas = num_stas;
+    baseline->addrs = malloc(sizeof(*baseline->addrs) * num_stas + 1);
+    baseline->snr = calloc((size_t) num_stas * num_stas + 1, sizeof(*baseline->snr));
+    if (!baseline->addrs || !baseline->snr) {
+        free_baseline(baseline);
+        return NULL;
+    }
+    return baseline;
+}
+
+/**
+ * Collects link_delta_entry and sends them in notifications of at most
+ * WSERVER_DELTA_MAX_ENTRIES
+ */
+struct delta_writer {
+    struct request_ctx *ctx;
+    link_delta_notification header;
+    link_delta_entry *entries;
+    int ret;
+};
+
+static void flush_deltas(struct delta_writer *w) {
+    if (w->header.count && !w->ret) {
+        u8 *packed = malloc(sizeof(link_delta_notification) + sizeof(link_delta_entry) * w->header.count);
+        if (packed) {
+            size_t len = wserver_pack_msg(packed, &w->header, link_delta_notification);
+            len += wserver_pack_entries(packed + len, w->entries, w->header.count, link_delta_entry);
+            w->ret = reply_bytes(w->ctx, packed, len, true);
+            free(packed);
+        } else {
+            w->ret = -ENOMEM;
+        }
+    }
+    // the entries are dropped even if they could not be sent
+    w->header.count = 0;
+}
+
+static void add_delta(struct delta_writer *w, const u8 *from, const u8 *to, i32 old_snr, i32 new_snr) {
+    if (w->ret)
+        return;
+
+    link_delta_entry *entry = &w->entries[w->header.count++];
+
+    memcpy(entry->from_addr, from, ETH_ALEN);
+    memcpy(entry->to_addr, to, ETH_ALEN);
+    entry->old_snr = old_snr;
+    entry->new_snr = new_snr;
+    if (w->header.count == WSERVER_DELTA_MAX_ENTRIES)
+        flush_deltas(w);
+}
+
+/**
+ * Send the links of ls that moved away from the subscriber's baseline by at
+ * least its threshold, and make them the new baseline. Links that moved
+ * less keep their old baseline value, so slow drifts are reported once
+ * they add up.
+ * @return 0 on success otherwise a negative errno value
+ */
+static int notify_subscriber(struct client_conn *conn, const struct link_state *ls,
+                             const struct timespec *now, link_delta_entry *entries) {
+    struct link_baseline *old = conn->baseline, *next;
+    struct delta_writer w = {.ctx = &conn->rctx, .entries = entries};
+    int n = ls->num_stas, *map;
+    bool *kept;
+
+    next = alloc_baseline(n);
+    map = malloc(sizeof(*map) * n + 1);
+    kept = calloc(old->num_stas + 1, sizeof(*kept));
+    if (!next || !map || !kept) {
+        free_baseline(next);
+        free(map);
+        free(kept);
+        return -ENOMEM;
+    }
+
+    // both station lists are sorted by address
+    for (int i = 0, k = 0; i < n; i++) {
+        memcpy(next->addrs[i], ls->stations[i].addr, ETH_ALEN);
+        while (k < old->num_stas && memcmp(old->addrs[k], ls->stations[i].addr, ETH_ALEN) < 0)
+            k++;
+        map[i] = k < old->num_stas && !memcmp(old->addrs[k], ls->stations[i].addr, ETH_ALEN) ? k : -1;
+        if (map[i] >= 0)
+            kept[k] = true;
+    }
+
+    w.header.version = ls->version;
+    w.header.tv_sec = now->tv_sec;
+    w.header.tv_nsec = now->tv_nsec;
+    for (int i = 0; i < n && !w.ret; i++) {
+        for (int j = 0; j < n; j++) {
+            if (i == j)
+                continue;
+            i32 cur = link_state_snr(ls, &ls->stations[i], &ls->stations[j]);
+            i32 *stored = &next->snr[i * n + j];
+            if (map[i] < 0 || map[j] < 0) {
+                add_delta(&w, next->addrs[i], next->addrs[j], WSERVER_SNR_NONE, cur);
+                *stored = cur;
+                continue;
+            }
+            i32 prev = old->snr[map[i] * old->num_stas + map[j]];
+            if (abs(cur - prev) >= conn->threshold) {
+                add_delta(&w, next->addrs[i], next->addrs[j], prev, cur);
+                *stored = cur;
+            } else {
+                *stored = prev;
+            }
+        }
+    }
+    for (int a = 0; a < old->num_stas && !w.ret; a++) {
+        if (kept[a])
+            continue;
+        for (int b = 0; b < old->num_stas; b++) {
+            if (a == b)
+                continue;
+            add_delta(&w, old->addrs[a], old->addrs[b], old->snr[a * old->num_stas + b], WSERVER_SNR_NONE);
+            // links between two removed stations are sent from both ends
+            if (kept[b])
+                add_delta(&w, old->addrs[b], old->addrs[a], old->snr[b * old->num_stas + a], WSERVER_SNR_NONE);
+        }
+    }
+    flush_deltas(&w);
+
+    next->version = ls->version;
+    conn->baseline = next;
+    free_baseline(old);
+    free(map);
+    free(kept);
+    return w.ret;
+}
+
+static void close_client(struct client_conn *conn) {
+    list_del(&conn->list);
+    free_baseline(conn->baseline);
+    wserver_shm_free(conn->shm);
+    free(conn->shm);
+    bufferevent_free(conn->rctx.bev);
+    free(conn);
+}
+
+int handle_subscribe_request(struct request_ctx *ctx, const subscribe_request *request) {
+    struct client_conn *conn = container_of(ctx, struct client_conn, rctx);
+    subscribe_response response = {0};
+    response.request = *request;
+
+    free_baseline(conn->baseline);
+    conn->baseline = NULL;
+    if (request->enable) {
+        const struct link_state *ls = link_state_acquire(ctx->ctx);
+        if (!ls || !ls->snr_matrix) {
+            response.update_result = WUPDATE_WRONG_MODE;
+        } else if (!(conn->baseline = alloc_baseline(ls->num_stas))) {
+            link_state_release();
+            w_logf(ctx->ctx, LOG_ERR, "Error during allocation of memory in handle_subscribe_request wmediumd/wserver.c\n");
+            return WACTION_ERROR;
+        } else {
+            struct link_baseline *baseline = conn->baseline;
+            for (int i = 0; i < ls->num_stas; i++) {
+                memcpy(baseline->addrs[i], ls->stations[i].addr, ETH_ALEN);
+                for (int j = 0; j < ls->num_stas; j++) {
+                    baseline->snr[i * ls->num_stas + j] = link_state_snr(ls, &ls->stations[i], &ls->stations[j]);
+                }
+            }
+            baseline->version = ls->version;
+            conn->threshold = request->threshold > 1 ? request->threshold : 1;
+            response.version = ls->version;
+            response.update_result = WUPDATE_SUCCESS;
+        }
+        link_state_release();
+        w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Client subscribed to link changes of %d dB\n", conn->threshold);
+    } else {
+        response.update_result = WUPDATE_SUCCESS;
+    }
+
+    int ret = wserver_reply(ctx, &response, subscribe_response);
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on subscribe response: %s\n", strerror(abs(ret)));
+        return WACTION_ERROR;
+    }
+    return ret;
+}
+
+/**
+ * Polls the shared memory regions of all clients
+ */
+static struct event *shm_poll_timer;
+
+static void arm_shm_poll(void) {
+    struct timeval interval = {
+        .tv_sec = 0,
+        .tv_usec = WSERVER_SHM_POLL_MS * 1000,
+    };
+    evtimer_add(shm_poll_timer, &interval);
+}
+
+struct shm_poll_ctx {
+    struct wmediumd *ctx;
+    const struct link_state *ls;
+};
+
+static void apply_shm_slot(const struct wserver_shm_slot *slot, void *data) {
+    struct shm_poll_ctx *poll = data;
+    struct station_props props;
+
+    entry_to_station_props(slot, &props);
+    // slots may name stations that are gone or not added yet
+    if (!props.mask || !link_state_find(poll->ls, props.addr))
+        return;
+    if (coalesce_update(&props))
+        w_logf(poll->ctx, LOG_ERR, LOG_PREFIX "Dropped shared memory update of " MAC_FMT "\n",
+               MAC_ARGS(props.addr));
+}
+
+static void on_shm_poll_timer(int fd, short what, void *wctx) {
+    struct wmediumd *ctx = wctx;
+    struct client_conn *conn;
+    bool attached = false;
+    int changed = 0;
+    UNUSED(fd);
+    UNUSED(what);
+
+    struct shm_poll_ctx poll = {ctx, link_state_acquire(ctx)};
+    list_for_each_entry(conn, &clients, list) {
+        if (!conn->shm)
+            continue;
+        attached = true;
+        if (poll.ls && ctx->error_prob_matrix == NULL)
+            changed += wserver_shm_poll(conn->shm, apply_shm_slot, &poll);
+    }
+    link_state_release();
+
+    if (changed)
+        end_batch(ctx);
+    if (attached)
+        arm_shm_poll();
+}
+
+/**
+ * Send a response together with a file descriptor. The descriptor has to
+ * travel with the first byte of the response, so everything queued before
+ * is written out first.
+ * @return 0 on success otherwise a negative errno value
+ */
+static int reply_with_fd(struct request_ctx *ctx, const void *data, size_t len, int fd) {
+    struct evbuffer *out = bufferevent_get_output(ctx->bev);
+    char control[CMSG_SPACE(sizeof(int))] = {0};
+    struct iovec iov = {(void *) data, len};
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof(control),
+    };
+
+    while (evbuffer_get_length(out)) {
+        if (evbuffer_write(out, ctx->sock_fd) <= 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK ? -EAGAIN : -errno;
+        }
+    }
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    ssize_t sent = sendmsg(ctx->sock_fd, &msg, MSG_NOSIGNAL);
+    if (sent < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK ? -EAGAIN : -errno;
+    }
+    if ((size_t) sent < len && evbuffer_add(out, (const u8 *) data + sent, len - sent)) {
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+int handle_shm_attach_request(struct request_ctx *ctx, const shm_attach_request *request) {
+    struct client_conn *conn = container_of(ctx, struct client_conn, rctx);
+    shm_attach_response response = {0};
+    struct wserver_shm *shm = NULL;
+    response.request = *request;
+
+    // the descriptor has to reach the client, whether it asked quietly or not
+    ctx->quiet = false;
+    if (ctx->ctx->error_prob_matrix != NULL) {
+        response.update_result = WUPDATE_WRONG_MODE;
+    } else if (request->num_slots == 0 || request->num_slots > WSERVER_BULK_MAX_STATIONS) {
+        response.update_result = WUPDATE_WRONG_MODE;
+    } else {
+        int ret = -ENOMEM;
+        shm = malloc(sizeof(*shm));
+        if (!shm || (ret = wserver_shm_create(shm, request->num_slots))) {
+            w_logf(ctx->ctx, LOG_ERR, LOG_PREFIX "Cannot create shared memory: %s\n", strerror(abs(ret)));
+            free(shm);
+            return WACTION_ERROR;
+        }
+        response.size = shm->size;
+        response.update_result = WUPDATE_SUCCESS;
+    }
+
+    int ret;
+    if (shm) {
+        shm_attach_response packed;
+        wserver_pack_msg(&packed, &response, shm_attach_response);
+        ret = reply_with_fd(ctx, &packed, sizeof(packed), shm->fd);
+        if (ret == -EAGAIN) {
+            // the client still has responses to read, it may ask again later
+            wserver_shm_free(shm);
+            free(shm);
+            shm = NULL;
+            response.size = 0;
+            response.update_result = WUPDATE_WRONG_MODE;
+            ret = wserver_reply(ctx, &response, shm_attach_response);
+        }
+    } else {
+        ret = wserver_reply(ctx, &response, shm_attach_response);
+    }
+    if (ret < 0) {
+        w_logf(ctx->ctx, LOG_ERR, "Error on shm attach response: %s\n", strerror(abs(ret)));
+        wserver_shm_free(shm);
+        free(shm);
+        return WACTION_ERROR;
+    }
+
+    if (shm) {
+        // the client has its own descriptor now, a new region replaces the old one
+        wserver_shm_free(conn->shm);
+        free(conn->shm);
+        conn->shm = shm;
+        if (!evtimer_pending(shm_poll_timer, NULL))
+            arm_shm_poll();
+        w_logf(ctx->ctx, LOG_NOTICE, LOG_PREFIX "Client attached shared memory of %u slots\n",
+               request->num_slots);
+    }
+    return WACTION_CONTINUE;
+}
+
+/**
+ * Signalled by link_state_publish(), from any thread
+ */
+static int publish_fd = -1;
+
+static void notify_publish(void *data) {
+    u64 one = 1;
+    UNUSED(data);
+    if (write(publish_fd, &one, sizeof(one)) < 0) {
+        // the counter is already non-zero, the server will look anyway
+    }
+}
+
+static void on_publish_event(int fd, short what, void *wctx) {
+    struct client_conn *conn, *tmp;
+    link_delta_entry *entries = NULL;
+    struct timespec now;
+    u64 count;
+    UNUSED(what);
+
+    if (read(fd, &count, sizeof(count)) < 0)
+        return;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    const struct link_state *ls = link_state_acquire(wctx);
+    list_for_each_entry_safe(conn, tmp, &clients, list) {
+        // subscribers that do not keep up get the sum of the changes later
+        if (!conn->baseline || !ls || !ls->snr_matrix || conn->baseline->version == ls->version ||
+            evbuffer_get_length(bufferevent_get_output(conn->rctx.bev)) >= WSERVER_OUTPUT_HIGH_WATER)
+            continue;
+        if (!entries && !(entries = malloc(sizeof(*entries) * WSERVER_DELTA_MAX_ENTRIES)))
+            break;
+        if (notify_subscriber(conn, ls, &now, entries)) {
+            w_logf(wctx, LOG_INFO, LOG_PREFIX "Disconnecting subscriber because of error\n");
+            close_client(conn);
+        }
+    }
+    link_state_release();
+    free(entries);
+}
+
+/**
+ * Handle the complete requests in the input buffer of a client
+ * @return A WACTION_* constant, or WACTION_DISCONNECTED if the client was closed
+ */
+static int handle_pending_requests(struct client_conn *conn) {
+    struct bufferevent *bev = conn->rctx.bev;
+    struct evbuffer *in = bufferevent_get_input(bev);
+    struct evbuffer *out = bufferevent_get_output(bev);
+
+    while (evbuffer_get_length(out) < WSERVER_OUTPUT_HIGH_WATER) {
+        ssize_t size = pending_request_size(in);
+        if (size == 0) {
+            return WACTION_CONTINUE;
+        } else if (size < 0) {
+            w_logf(conn->rctx.ctx, LOG_INFO, LOG_PREFIX "Disconnecting client because of invalid request\n");
+            close_client(conn);
+            return WACTION_DISCONNECTED;
+        }
+
+        const u8 *data = evbuffer_pullup(in, size);
+        WMEDIUMD_PROBE2(request_start, data[0] & WSERVER_TYPE_MASK, size);
+        int action = handle_request(&conn->rctx, data);
+        WMEDIUMD_PROBE2(request_done, data[0] & WSERVER_TYPE_MASK, action);
+        evbuffer_drain(in, size);
+        if (action == WACTION_CLOSE) {
+            return action;
+        } else if (action != WACTION_CONTINUE) {
+            w_logf(conn->rctx.ctx, LOG_INFO, LOG_PREFIX "Disconnecting client because of error\n");
+            close_client(conn);
+            return WACTION_DISCONNECTED;
+        }
+    }
+
+    // The client does not read its responses: stop reading until it does
+    bufferevent_disable(bev, EV_READ);
+    return WACTION_CONTINUE;
+}
+
+static void on_client_read(struct bufferevent *bev, void *arg) {
+    struct client_conn *conn = arg;
+    struct request_ctx rctx = conn->rctx;
+    UNUSED(bev);
+
+    // Everything the client has sent so far is one batch: the recomputation
+    // runs once at its end and the responses leave in as few writes as possible
+    int action = handle_pending_requests(conn);
+    end_batch(rctx.ctx);
+    if (action == WACTION_CLOSE) {
+        w_logf(rctx.ctx, LOG_INFO, LOG_PREFIX "Closing server\n");
+        event_base_loopbreak(server_event_base);
+    }
+}
+
+static void on_client_write(struct bufferevent *bev, void *arg) {
+    // Called once the output has drained below the low watermark
+    if (!(bufferevent_get_enabled(bev) & EV_READ)) {
+        bufferevent_enable(bev, EV_READ);
+        on_client_read(bev, arg);
+    }
+}
+
+static void on_client_event(struct bufferevent *bev, short what, void *arg) {
+    struct client_conn *conn = arg;
+    UNUSED(bev);
+
+    if (what & BEV_EVENT_EOF) {
+        w_logf(conn->rctx.ctx, LOG_INFO, LOG_PREFIX "Client has disconnected\n");
+        close_client(conn);
+    } else if (what & BEV_EVENT_ERROR) {
+        w_logf(conn->rctx.ctx, LOG_INFO, LOG_PREFIX "Disconnecting client because of error: %s\n",
+               strerror(errno));
+        close_client(conn);
+    }
+}
+
+void on_listen_event(int fd, short what, void *wctx) {
+    UNUSED(what);
+    int client_socket = accept_connection(fd);
+    if (client_socket < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            w_logf(wctx, LOG_ERR, LOG_PREFIX "Accept failed: %s\n", strerror(errno));
+        }
+        return;
+    }
+
+    struct client_conn *conn = malloc(sizeof(struct client_conn));
+    if (!conn) {
+        w_logf(wctx, LOG_ERR, "Error during allocation of memory in on_listen_event wmediumd/wserver.c\n");
+        close(client_socket);
+        return;
+    }
+    evutil_make_socket_nonblocking(client_socket);
+    conn->rctx.ctx = wctx;
+    conn->rctx.sock_fd = client_socket;
+    conn->baseline = NULL;
+    conn->shm = NULL;
+    conn->rctx.bev = bufferevent_socket_new(server_event_base, client_socket, BEV_OPT_CLOSE_ON_FREE);
+    if (!conn->rctx.bev) {
+        w_logf(wctx, LOG_ERR, "Error during allocation of memory in on_listen_event wmediumd/wserver.c\n");
+        close(client_socket);
+        free(conn);
+        return;
+    }
+    list_add_tail(&conn->list, &clients);
+    bufferevent_setcb(conn->rctx.bev, on_client_read, on_client_write, on_client_event, conn);
+    bufferevent_setwatermark(conn->rctx.bev, EV_WRITE, WSERVER_OUTPUT_HIGH_WATER / 2, 0);
+    bufferevent_enable(conn->rctx.bev, EV_READ | EV_WRITE);
+    w_logf(wctx, LOG_INFO, LOG_PREFIX "Client connected\n");
+}
+
+/**
+ * Run the server using the given wmediumd context
+ * @param ctx The wmediumd context
+ * @return NULL, required for pthread
+ */
+void *run_wserver(void *ctx) {
+    struct event *accept_event;
+
+    // Leave SIGINT to wmediumd if it already handles it, e.g. to finish a capture
+    struct sigaction sigint_action;
+    if (sigaction(SIGINT, NULL, &sigint_action) == 0 && sigint_action.sa_handler == SIG_DFL) {
+        old_sig_handler = signal(SIGINT, handle_sigint);
+        sigint_installed = true;
+    }
+
+    listen_soc = create_listen_socket(ctx);
+    if (listen_soc < 0) {
+        return NULL;
+    }
+    w_logf(ctx, LOG_DEBUG, LOG_PREFIX "Listening for incoming connection\n");
+
+    evutil_make_socket_nonblocking(listen_soc);
+    INIT_LIST_HEAD(&clients);
+    server_event_base = event_base_new();
+    accept_event = event_new(server_event_base, listen_soc, EV_READ | EV_PERSIST, on_listen_event, ctx);
+    event_add(accept_event, NULL);
+    coalesce_timer = evtimer_new(server_event_base, on_coalesce_timer, ctx);
+    shm_poll_timer = evtimer_new(server_event_base, on_shm_poll_timer, ctx);
+    publish_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct event *publish_event = event_new(server_event_base, publish_fd, EV_READ | EV_PERSIST,
+                                            on_publish_event, ctx);
+    event_add(publish_event, NULL);
+    link_state_set_notify(notify_publish, NULL);
+
+    w_logf(ctx, LOG_DEBUG, LOG_PREFIX "Waiting for client to connect...\n");
+    event_base_dispatch(server_event_base);
+
+    struct client_conn *conn, *tmp;
+    list_for_each_entry_safe(conn, tmp, &clients, list) {
+        close_client(conn);
+    }
+    flush_pending(ctx);
+    link_state_set_notify(NULL, NULL);
+    event_free(publish_event);
+    close(publish_fd);
+    event_free(shm_poll_timer);
+    event_free(coalesce_timer);
+    event_free(accept_event);
+    event_base_free(server_event_base);
+    stop_wserver();
+    return NULL;
 }
 
 int start_wserver(struct wmediumd *ctx) {
@@ -729,7 +2206,10 @@ int start_wserver(struct wmediumd *ctx) {
 }
 
 void stop_wserver() {
-    signal(SIGINT, old_sig_handler);
+    if (sigint_installed) {
+        signal(SIGINT, old_sig_handler);
+        sigint_installed = false;
+    }
     pthread_cancel(server_thread);
     pthread_detach(server_thread);
     printf("\n" LOG_PREFIX "shutting down wserver\n");
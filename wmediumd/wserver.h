@@ -24,9 +24,13 @@
 #include "wmediumd.h"
 #include "wserver_messages.h"
 
+struct bufferevent;
+
 struct request_ctx {
     struct wmediumd *ctx;
     int sock_fd;
+    struct bufferevent *bev;
+    bool quiet; /* current request has WSERVER_FLAG_QUIET */
 };
 
 /**
@@ -41,6 +45,14 @@ int start_wserver(struct wmediumd *ctx);
  */
 void stop_wserver();
 
+/**
+ * Handle one complete request received from a client
+ * @param ctx The request_ctx context
+ * @param data The request in network byte order
+ * @return A WACTION_* constant, or a negative errno value
+ */
+int handle_request(struct request_ctx *ctx, const u8 *data);
+
 /**
  * Handle a snr_update_request and pass it to wmediumd
  * @param ctx The request_ctx context
@@ -111,4 +123,116 @@ int handle_delete_by_mac_request(struct request_ctx *ctx, station_del_by_mac_req
  */
 int handle_add_request(struct request_ctx *ctx, station_add_request *request);
 
+/**
+ * Handle a station_bulk_add_request and pass it to wmediumd
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param entries The request->count entries following the request
+ */
+int handle_bulk_add_request(struct request_ctx *ctx, const station_bulk_add_request *request,
+                            const station_bulk_add_entry *entries);
+
+/**
+ * Handle a station_bulk_del_request and pass it to wmediumd
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param entries The request->count entries following the request
+ */
+int handle_bulk_del_request(struct request_ctx *ctx, const station_bulk_del_request *request,
+                            const station_bulk_del_entry *entries);
+
+/**
+ * Handle a station_update_request and pass it to wmediumd
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param entries The request->count entries following the request
+ */
+int handle_station_update_request(struct request_ctx *ctx, const station_update_request *request,
+                                  const station_update_entry *entries);
+
+/**
+ * Handle a matrix_rows_request and pass it to wmediumd
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param rows The request->num_rows senders
+ * @param cols The request->num_cols receivers
+ * @param values The rows * cols values in row-major order
+ */
+int handle_matrix_rows_request(struct request_ctx *ctx, const matrix_rows_request *request,
+                               const matrix_addr_entry *rows, const matrix_addr_entry *cols,
+                               const matrix_value_entry *values);
+
+/**
+ * Handle a matrix_triplets_request and pass it to wmediumd
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param entries The request->count entries following the request
+ */
+int handle_matrix_triplets_request(struct request_ctx *ctx, const matrix_triplets_request *request,
+                                   const matrix_triplet_entry *entries);
+
+/**
+ * Answer a link_query_request from the current link state snapshot
+ * @param ctx The request_ctx context
+ * @param request The received request
+ */
+int handle_link_query_request(struct request_ctx *ctx, const link_query_request *request);
+
+/**
+ * Answer a matrix_query_request from the current link state snapshot
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param rows The request->num_rows senders to return
+ */
+int handle_matrix_query_request(struct request_ctx *ctx, const matrix_query_request *request,
+                                const matrix_addr_entry *rows);
+
+/**
+ * Answer a station_query_request from the current link state snapshot
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param addrs The request->count stations to return
+ */
+int handle_station_query_request(struct request_ctx *ctx, const station_query_request *request,
+                                 const matrix_addr_entry *addrs);
+
+/**
+ * Answer a link_stats_request with the traffic counted so far
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @param senders The request->count senders to return the links of
+ */
+int handle_link_stats_request(struct request_ctx *ctx, const link_stats_request *request,
+                              const matrix_addr_entry *senders);
+
+/**
+ * Answer a metrics_request with the frame path counters and latencies
+ * @param ctx The request_ctx context
+ * @param request The received request
+ */
+int handle_metrics_request(struct request_ctx *ctx, const metrics_request *request);
+
+/**
+ * Answer a recorder_request with the latest frames of the flight recorder
+ * @param ctx The request_ctx context
+ * @param request The received request
+ */
+int handle_recorder_request(struct request_ctx *ctx, const recorder_request *request);
+
+/**
+ * Handle a subscribe_request, the client then receives link_delta_notification
+ * @param ctx The request_ctx context
+ * @param request The received request
+ */
+int handle_subscribe_request(struct request_ctx *ctx, const subscribe_request *request);
+
+/**
+ * Handle a shm_attach_request: create a shared memory region for station
+ * updates and pass its descriptor to the client
+ * @param ctx The request_ctx context
+ * @param request The received request
+ * @return A positive WACTION_* constant, or a negative errno value
+ */
+int handle_shm_attach_request(struct request_ctx *ctx, const shm_attach_request *request);
+
 #endif //WMEDIUMD_SERVER_H
@@ -18,6 +18,7 @@
  *	02110-1301, USA.
  */
 
+#include <errno.h>
 #include <sys/socket.h>
 #include <memory.h>
 #include "wserver_messages.h"
@@ -38,6 +39,60 @@
     elem->base.type = typeint; \
     return ret;
 
+#define WSERVER_ENTRY_CHUNK 256
+
+#define align_send_entries(sock_fd, entries, count, type) \
+    type tosend[WSERVER_ENTRY_CHUNK]; \
+    u32 done = 0; \
+    while (done < count) { \
+        u32 chunk = count - done < WSERVER_ENTRY_CHUNK ? count - done : WSERVER_ENTRY_CHUNK; \
+        memcpy(tosend, entries + done, sizeof(type) * chunk); \
+        for (u32 i = 0; i < chunk; i++) { \
+            hton_type(&tosend[i], type); \
+        } \
+        int ret = sendfull(sock_fd, tosend, sizeof(type) * chunk, 0, MSG_NOSIGNAL); \
+        if (ret) \
+            return ret; \
+        done += chunk; \
+    } \
+    return WACTION_CONTINUE;
+
+#define align_recv_entries(sock_fd, entries, count, type) \
+    int ret = recvfull(sock_fd, entries, sizeof(type) * count, 0, 0); \
+    if (ret) \
+        return ret; \
+    for (u32 i = 0; i < count; i++) { \
+        ntoh_type(&entries[i], type); \
+    } \
+    return WACTION_CONTINUE;
+#define align_pack_msg(buf, elem, elemtype, typeint) \
+    elemtype topack; \
+    memcpy(&topack, elem, sizeof(elemtype)); \
+    topack.base.type = typeint; \
+    hton_type(&topack, elemtype); \
+    memcpy(buf, &topack, sizeof(elemtype)); \
+    return sizeof(elemtype);
+
+#define align_unpack_msg(buf, elem, elemtype) \
+    memcpy(elem, buf, sizeof(elemtype)); \
+    ntoh_type(elem, elemtype); \
+    return sizeof(elemtype);
+
+#define align_pack_entries(buf, entries, count, elemtype) \
+    for (u32 i = 0; i < count; i++) { \
+        elemtype topack = entries[i]; \
+        hton_type(&topack, elemtype); \
+        memcpy((u8 *) buf + sizeof(elemtype) * i, &topack, sizeof(elemtype)); \
+    } \
+    return sizeof(elemtype) * count;
+
+#define align_unpack_entries(buf, entries, count, elemtype) \
+    memcpy(entries, buf, sizeof(elemtype) * count); \
+    for (u32 i = 0; i < count; i++) { \
+        ntoh_type(&entries[i], elemtype); \
+    } \
+    return sizeof(elemtype) * count;
+
 
 int send_snr_update_request(int sock, const snr_update_request *elem) {
     align_send_msg(sock, elem, snr_update_request, WSERVER_SNR_UPDATE_REQUEST_TYPE)
@@ -215,6 +270,838 @@ int recv_medium_update_response(int sock, medium_update_response *elem) {
     align_recv_msg(sock, elem, medium_update_response , WSERVER_MEDIUM_UPDATE_RESPONSE_TYPE)
 }
 
+int send_station_bulk_add_request(int sock, const station_bulk_add_request *elem) {
+    align_send_msg(sock, elem, station_bulk_add_request, WSERVER_BULK_ADD_REQUEST_TYPE)
+}
+
+int send_station_bulk_add_response(int sock, const station_bulk_add_response *elem) {
+    align_send_msg(sock, elem, station_bulk_add_response, WSERVER_BULK_ADD_RESPONSE_TYPE)
+}
+
+int send_station_bulk_del_request(int sock, const station_bulk_del_request *elem) {
+    align_send_msg(sock, elem, station_bulk_del_request, WSERVER_BULK_DEL_REQUEST_TYPE)
+}
+
+int send_station_bulk_del_response(int sock, const station_bulk_del_response *elem) {
+    align_send_msg(sock, elem, station_bulk_del_response, WSERVER_BULK_DEL_RESPONSE_TYPE)
+}
+
+int recv_station_bulk_add_request(int sock, station_bulk_add_request *elem) {
+    align_recv_msg(sock, elem, station_bulk_add_request, WSERVER_BULK_ADD_REQUEST_TYPE)
+}
+
+int recv_station_bulk_add_response(int sock, station_bulk_add_response *elem) {
+    align_recv_msg(sock, elem, station_bulk_add_response, WSERVER_BULK_ADD_RESPONSE_TYPE)
+}
+
+int recv_station_bulk_del_request(int sock, station_bulk_del_request *elem) {
+    align_recv_msg(sock, elem, station_bulk_del_request, WSERVER_BULK_DEL_REQUEST_TYPE)
+}
+
+int recv_station_bulk_del_response(int sock, station_bulk_del_response *elem) {
+    align_recv_msg(sock, elem, station_bulk_del_response, WSERVER_BULK_DEL_RESPONSE_TYPE)
+}
+
+int send_station_bulk_add_entrys(int sock, const station_bulk_add_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_bulk_add_entry)
+}
+
+int send_station_bulk_add_results(int sock, const station_bulk_add_result *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_bulk_add_result)
+}
+
+int send_station_bulk_del_entrys(int sock, const station_bulk_del_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_bulk_del_entry)
+}
+
+int send_station_bulk_del_results(int sock, const station_bulk_del_result *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_bulk_del_result)
+}
+
+int recv_station_bulk_add_entrys(int sock, station_bulk_add_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_bulk_add_entry)
+}
+
+int recv_station_bulk_add_results(int sock, station_bulk_add_result *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_bulk_add_result)
+}
+
+int recv_station_bulk_del_entrys(int sock, station_bulk_del_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_bulk_del_entry)
+}
+
+int recv_station_bulk_del_results(int sock, station_bulk_del_result *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_bulk_del_result)
+}
+
+size_t pack_snr_update_request(void *buf, const snr_update_request *elem) {
+    align_pack_msg(buf, elem, snr_update_request, WSERVER_SNR_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_snr_update_response(void *buf, const snr_update_response *elem) {
+    align_pack_msg(buf, elem, snr_update_response, WSERVER_SNR_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_position_update_request(void *buf, const position_update_request *elem) {
+    align_pack_msg(buf, elem, position_update_request, WSERVER_POSITION_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_position_update_response(void *buf, const position_update_response *elem) {
+    align_pack_msg(buf, elem, position_update_response, WSERVER_POSITION_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_txpower_update_request(void *buf, const txpower_update_request *elem) {
+    align_pack_msg(buf, elem, txpower_update_request, WSERVER_TXPOWER_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_txpower_update_response(void *buf, const txpower_update_response *elem) {
+    align_pack_msg(buf, elem, txpower_update_response, WSERVER_TXPOWER_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_gaussian_random_update_request(void *buf, const gaussian_random_update_request *elem) {
+    align_pack_msg(buf, elem, gaussian_random_update_request, WSERVER_GAUSSIAN_RANDOM_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_gaussian_random_update_response(void *buf, const gaussian_random_update_response *elem) {
+    align_pack_msg(buf, elem, gaussian_random_update_response, WSERVER_GAUSSIAN_RANDOM_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_gain_update_request(void *buf, const gain_update_request *elem) {
+    align_pack_msg(buf, elem, gain_update_request, WSERVER_GAIN_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_gain_update_response(void *buf, const gain_update_response *elem) {
+    align_pack_msg(buf, elem, gain_update_response, WSERVER_GAIN_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_errprob_update_request(void *buf, const errprob_update_request *elem) {
+    align_pack_msg(buf, elem, errprob_update_request, WSERVER_ERRPROB_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_errprob_update_response(void *buf, const errprob_update_response *elem) {
+    align_pack_msg(buf, elem, errprob_update_response, WSERVER_ERRPROB_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_specprob_update_request(void *buf, const specprob_update_request *elem) {
+    align_pack_msg(buf, elem, specprob_update_request, WSERVER_SPECPROB_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_specprob_update_response(void *buf, const specprob_update_response *elem) {
+    align_pack_msg(buf, elem, specprob_update_response, WSERVER_SPECPROB_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_station_del_by_mac_request(void *buf, const station_del_by_mac_request *elem) {
+    align_pack_msg(buf, elem, station_del_by_mac_request, WSERVER_DEL_BY_MAC_REQUEST_TYPE)
+}
+
+size_t pack_station_del_by_mac_response(void *buf, const station_del_by_mac_response *elem) {
+    align_pack_msg(buf, elem, station_del_by_mac_response, WSERVER_DEL_BY_MAC_RESPONSE_TYPE)
+}
+
+size_t pack_station_del_by_id_request(void *buf, const station_del_by_id_request *elem) {
+    align_pack_msg(buf, elem, station_del_by_id_request, WSERVER_DEL_BY_ID_REQUEST_TYPE)
+}
+
+size_t pack_station_del_by_id_response(void *buf, const station_del_by_id_response *elem) {
+    align_pack_msg(buf, elem, station_del_by_id_response, WSERVER_DEL_BY_ID_RESPONSE_TYPE)
+}
+
+size_t pack_station_add_request(void *buf, const station_add_request *elem) {
+    align_pack_msg(buf, elem, station_add_request, WSERVER_ADD_REQUEST_TYPE)
+}
+
+size_t pack_station_add_response(void *buf, const station_add_response *elem) {
+    align_pack_msg(buf, elem, station_add_response, WSERVER_ADD_RESPONSE_TYPE)
+}
+
+size_t pack_medium_update_request(void *buf, const medium_update_request *elem) {
+    align_pack_msg(buf, elem, medium_update_request, WSERVER_MEDIUM_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_medium_update_response(void *buf, const medium_update_response *elem) {
+    align_pack_msg(buf, elem, medium_update_response, WSERVER_MEDIUM_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_station_bulk_add_request(void *buf, const station_bulk_add_request *elem) {
+    align_pack_msg(buf, elem, station_bulk_add_request, WSERVER_BULK_ADD_REQUEST_TYPE)
+}
+
+size_t pack_station_bulk_add_response(void *buf, const station_bulk_add_response *elem) {
+    align_pack_msg(buf, elem, station_bulk_add_response, WSERVER_BULK_ADD_RESPONSE_TYPE)
+}
+
+size_t pack_station_bulk_del_request(void *buf, const station_bulk_del_request *elem) {
+    align_pack_msg(buf, elem, station_bulk_del_request, WSERVER_BULK_DEL_REQUEST_TYPE)
+}
+
+size_t pack_station_bulk_del_response(void *buf, const station_bulk_del_response *elem) {
+    align_pack_msg(buf, elem, station_bulk_del_response, WSERVER_BULK_DEL_RESPONSE_TYPE)
+}
+
+size_t unpack_snr_update_request(const void *buf, snr_update_request *elem) {
+    align_unpack_msg(buf, elem, snr_update_request)
+}
+
+size_t unpack_snr_update_response(const void *buf, snr_update_response *elem) {
+    align_unpack_msg(buf, elem, snr_update_response)
+}
+
+size_t unpack_position_update_request(const void *buf, position_update_request *elem) {
+    align_unpack_msg(buf, elem, position_update_request)
+}
+
+size_t unpack_position_update_response(const void *buf, position_update_response *elem) {
+    align_unpack_msg(buf, elem, position_update_response)
+}
+
+size_t unpack_txpower_update_request(const void *buf, txpower_update_request *elem) {
+    align_unpack_msg(buf, elem, txpower_update_request)
+}
+
+size_t unpack_txpower_update_response(const void *buf, txpower_update_response *elem) {
+    align_unpack_msg(buf, elem, txpower_update_response)
+}
+
+size_t unpack_gaussian_random_update_request(const void *buf, gaussian_random_update_request *elem) {
+    align_unpack_msg(buf, elem, gaussian_random_update_request)
+}
+
+size_t unpack_gaussian_random_update_response(const void *buf, gaussian_random_update_response *elem) {
+    align_unpack_msg(buf, elem, gaussian_random_update_response)
+}
+
+size_t unpack_gain_update_request(const void *buf, gain_update_request *elem) {
+    align_unpack_msg(buf, elem, gain_update_request)
+}
+
+size_t unpack_gain_update_response(const void *buf, gain_update_response *elem) {
+    align_unpack_msg(buf, elem, gain_update_response)
+}
+
+size_t unpack_errprob_update_request(const void *buf, errprob_update_request *elem) {
+    align_unpack_msg(buf, elem, errprob_update_request)
+}
+
+size_t unpack_errprob_update_response(const void *buf, errprob_update_response *elem) {
+    align_unpack_msg(buf, elem, errprob_update_response)
+}
+
+size_t unpack_specprob_update_request(const void *buf, specprob_update_request *elem) {
+    align_unpack_msg(buf, elem, specprob_update_request)
+}
+
+size_t unpack_specprob_update_response(const void *buf, specprob_update_response *elem) {
+    align_unpack_msg(buf, elem, specprob_update_response)
+}
+
+size_t unpack_station_del_by_mac_request(const void *buf, station_del_by_mac_request *elem) {
+    align_unpack_msg(buf, elem, station_del_by_mac_request)
+}
+
+size_t unpack_station_del_by_mac_response(const void *buf, station_del_by_mac_response *elem) {
+    align_unpack_msg(buf, elem, station_del_by_mac_response)
+}
+
+size_t unpack_station_del_by_id_request(const void *buf, station_del_by_id_request *elem) {
+    align_unpack_msg(buf, elem, station_del_by_id_request)
+}
+
+size_t unpack_station_del_by_id_response(const void *buf, station_del_by_id_response *elem) {
+    align_unpack_msg(buf, elem, station_del_by_id_response)
+}
+
+size_t unpack_station_add_request(const void *buf, station_add_request *elem) {
+    align_unpack_msg(buf, elem, station_add_request)
+}
+
+size_t unpack_station_add_response(const void *buf, station_add_response *elem) {
+    align_unpack_msg(buf, elem, station_add_response)
+}
+
+size_t unpack_medium_update_request(const void *buf, medium_update_request *elem) {
+    align_unpack_msg(buf, elem, medium_update_request)
+}
+
+size_t unpack_medium_update_response(const void *buf, medium_update_response *elem) {
+    align_unpack_msg(buf, elem, medium_update_response)
+}
+
+size_t unpack_station_bulk_add_request(const void *buf, station_bulk_add_request *elem) {
+    align_unpack_msg(buf, elem, station_bulk_add_request)
+}
+
+size_t unpack_station_bulk_add_response(const void *buf, station_bulk_add_response *elem) {
+    align_unpack_msg(buf, elem, station_bulk_add_response)
+}
+
+size_t unpack_station_bulk_del_request(const void *buf, station_bulk_del_request *elem) {
+    align_unpack_msg(buf, elem, station_bulk_del_request)
+}
+
+size_t unpack_station_bulk_del_response(const void *buf, station_bulk_del_response *elem) {
+    align_unpack_msg(buf, elem, station_bulk_del_response)
+}
+
+size_t pack_station_bulk_add_entrys(void *buf, const station_bulk_add_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_bulk_add_entry)
+}
+
+size_t pack_station_bulk_add_results(void *buf, const station_bulk_add_result *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_bulk_add_result)
+}
+
+size_t pack_station_bulk_del_entrys(void *buf, const station_bulk_del_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_bulk_del_entry)
+}
+
+size_t pack_station_bulk_del_results(void *buf, const station_bulk_del_result *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_bulk_del_result)
+}
+
+size_t unpack_station_bulk_add_entrys(const void *buf, station_bulk_add_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_bulk_add_entry)
+}
+
+size_t unpack_station_bulk_add_results(const void *buf, station_bulk_add_result *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_bulk_add_result)
+}
+
+size_t unpack_station_bulk_del_entrys(const void *buf, station_bulk_del_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_bulk_del_entry)
+}
+
+size_t unpack_station_bulk_del_results(const void *buf, station_bulk_del_result *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_bulk_del_result)
+}
+
+int send_matrix_rows_request(int sock, const matrix_rows_request *elem) {
+    align_send_msg(sock, elem, matrix_rows_request, WSERVER_MATRIX_ROWS_REQUEST_TYPE)
+}
+
+int recv_matrix_rows_request(int sock, matrix_rows_request *elem) {
+    align_recv_msg(sock, elem, matrix_rows_request, WSERVER_MATRIX_ROWS_REQUEST_TYPE)
+}
+
+size_t pack_matrix_rows_request(void *buf, const matrix_rows_request *elem) {
+    align_pack_msg(buf, elem, matrix_rows_request, WSERVER_MATRIX_ROWS_REQUEST_TYPE)
+}
+
+size_t unpack_matrix_rows_request(const void *buf, matrix_rows_request *elem) {
+    align_unpack_msg(buf, elem, matrix_rows_request)
+}
+
+int send_matrix_rows_response(int sock, const matrix_rows_response *elem) {
+    align_send_msg(sock, elem, matrix_rows_response, WSERVER_MATRIX_ROWS_RESPONSE_TYPE)
+}
+
+int recv_matrix_rows_response(int sock, matrix_rows_response *elem) {
+    align_recv_msg(sock, elem, matrix_rows_response, WSERVER_MATRIX_ROWS_RESPONSE_TYPE)
+}
+
+size_t pack_matrix_rows_response(void *buf, const matrix_rows_response *elem) {
+    align_pack_msg(buf, elem, matrix_rows_response, WSERVER_MATRIX_ROWS_RESPONSE_TYPE)
+}
+
+size_t unpack_matrix_rows_response(const void *buf, matrix_rows_response *elem) {
+    align_unpack_msg(buf, elem, matrix_rows_response)
+}
+
+int send_matrix_triplets_request(int sock, const matrix_triplets_request *elem) {
+    align_send_msg(sock, elem, matrix_triplets_request, WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE)
+}
+
+int recv_matrix_triplets_request(int sock, matrix_triplets_request *elem) {
+    align_recv_msg(sock, elem, matrix_triplets_request, WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE)
+}
+
+size_t pack_matrix_triplets_request(void *buf, const matrix_triplets_request *elem) {
+    align_pack_msg(buf, elem, matrix_triplets_request, WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE)
+}
+
+size_t unpack_matrix_triplets_request(const void *buf, matrix_triplets_request *elem) {
+    align_unpack_msg(buf, elem, matrix_triplets_request)
+}
+
+int send_matrix_triplets_response(int sock, const matrix_triplets_response *elem) {
+    align_send_msg(sock, elem, matrix_triplets_response, WSERVER_MATRIX_TRIPLETS_RESPONSE_TYPE)
+}
+
+int recv_matrix_triplets_response(int sock, matrix_triplets_response *elem) {
+    align_recv_msg(sock, elem, matrix_triplets_response, WSERVER_MATRIX_TRIPLETS_RESPONSE_TYPE)
+}
+
+size_t pack_matrix_triplets_response(void *buf, const matrix_triplets_response *elem) {
+    align_pack_msg(buf, elem, matrix_triplets_response, WSERVER_MATRIX_TRIPLETS_RESPONSE_TYPE)
+}
+
+size_t unpack_matrix_triplets_response(const void *buf, matrix_triplets_response *elem) {
+    align_unpack_msg(buf, elem, matrix_triplets_response)
+}
+
+int send_matrix_addr_entrys(int sock, const matrix_addr_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, matrix_addr_entry)
+}
+
+int recv_matrix_addr_entrys(int sock, matrix_addr_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, matrix_addr_entry)
+}
+
+size_t pack_matrix_addr_entrys(void *buf, const matrix_addr_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, matrix_addr_entry)
+}
+
+size_t unpack_matrix_addr_entrys(const void *buf, matrix_addr_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, matrix_addr_entry)
+}
+
+int send_matrix_value_entrys(int sock, const matrix_value_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, matrix_value_entry)
+}
+
+int recv_matrix_value_entrys(int sock, matrix_value_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, matrix_value_entry)
+}
+
+size_t pack_matrix_value_entrys(void *buf, const matrix_value_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, matrix_value_entry)
+}
+
+size_t unpack_matrix_value_entrys(const void *buf, matrix_value_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, matrix_value_entry)
+}
+
+int send_matrix_triplet_entrys(int sock, const matrix_triplet_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, matrix_triplet_entry)
+}
+
+int recv_matrix_triplet_entrys(int sock, matrix_triplet_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, matrix_triplet_entry)
+}
+
+size_t pack_matrix_triplet_entrys(void *buf, const matrix_triplet_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, matrix_triplet_entry)
+}
+
+size_t unpack_matrix_triplet_entrys(const void *buf, matrix_triplet_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, matrix_triplet_entry)
+}
+
+int send_station_update_request(int sock, const station_update_request *elem) {
+    align_send_msg(sock, elem, station_update_request, WSERVER_STATION_UPDATE_REQUEST_TYPE)
+}
+
+int recv_station_update_request(int sock, station_update_request *elem) {
+    align_recv_msg(sock, elem, station_update_request, WSERVER_STATION_UPDATE_REQUEST_TYPE)
+}
+
+size_t pack_station_update_request(void *buf, const station_update_request *elem) {
+    align_pack_msg(buf, elem, station_update_request, WSERVER_STATION_UPDATE_REQUEST_TYPE)
+}
+
+size_t unpack_station_update_request(const void *buf, station_update_request *elem) {
+    align_unpack_msg(buf, elem, station_update_request)
+}
+
+int send_station_update_response(int sock, const station_update_response *elem) {
+    align_send_msg(sock, elem, station_update_response, WSERVER_STATION_UPDATE_RESPONSE_TYPE)
+}
+
+int recv_station_update_response(int sock, station_update_response *elem) {
+    align_recv_msg(sock, elem, station_update_response, WSERVER_STATION_UPDATE_RESPONSE_TYPE)
+}
+
+size_t pack_station_update_response(void *buf, const station_update_response *elem) {
+    align_pack_msg(buf, elem, station_update_response, WSERVER_STATION_UPDATE_RESPONSE_TYPE)
+}
+
+size_t unpack_station_update_response(const void *buf, station_update_response *elem) {
+    align_unpack_msg(buf, elem, station_update_response)
+}
+
+int send_station_update_entrys(int sock, const station_update_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_update_entry)
+}
+
+int recv_station_update_entrys(int sock, station_update_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_update_entry)
+}
+
+size_t pack_station_update_entrys(void *buf, const station_update_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_update_entry)
+}
+
+size_t unpack_station_update_entrys(const void *buf, station_update_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_update_entry)
+}
+
+int send_station_update_results(int sock, const station_update_result *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_update_result)
+}
+
+int recv_station_update_results(int sock, station_update_result *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_update_result)
+}
+
+size_t pack_station_update_results(void *buf, const station_update_result *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_update_result)
+}
+
+size_t unpack_station_update_results(const void *buf, station_update_result *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_update_result)
+}
+
+int send_link_query_request(int sock, const link_query_request *elem) {
+    align_send_msg(sock, elem, link_query_request, WSERVER_LINK_QUERY_REQUEST_TYPE)
+}
+
+int recv_link_query_request(int sock, link_query_request *elem) {
+    align_recv_msg(sock, elem, link_query_request, WSERVER_LINK_QUERY_REQUEST_TYPE)
+}
+
+size_t pack_link_query_request(void *buf, const link_query_request *elem) {
+    align_pack_msg(buf, elem, link_query_request, WSERVER_LINK_QUERY_REQUEST_TYPE)
+}
+
+size_t unpack_link_query_request(const void *buf, link_query_request *elem) {
+    align_unpack_msg(buf, elem, link_query_request)
+}
+
+int send_link_query_response(int sock, const link_query_response *elem) {
+    align_send_msg(sock, elem, link_query_response, WSERVER_LINK_QUERY_RESPONSE_TYPE)
+}
+
+int recv_link_query_response(int sock, link_query_response *elem) {
+    align_recv_msg(sock, elem, link_query_response, WSERVER_LINK_QUERY_RESPONSE_TYPE)
+}
+
+size_t pack_link_query_response(void *buf, const link_query_response *elem) {
+    align_pack_msg(buf, elem, link_query_response, WSERVER_LINK_QUERY_RESPONSE_TYPE)
+}
+
+size_t unpack_link_query_response(const void *buf, link_query_response *elem) {
+    align_unpack_msg(buf, elem, link_query_response)
+}
+
+int send_matrix_query_request(int sock, const matrix_query_request *elem) {
+    align_send_msg(sock, elem, matrix_query_request, WSERVER_MATRIX_QUERY_REQUEST_TYPE)
+}
+
+int recv_matrix_query_request(int sock, matrix_query_request *elem) {
+    align_recv_msg(sock, elem, matrix_query_request, WSERVER_MATRIX_QUERY_REQUEST_TYPE)
+}
+
+size_t pack_matrix_query_request(void *buf, const matrix_query_request *elem) {
+    align_pack_msg(buf, elem, matrix_query_request, WSERVER_MATRIX_QUERY_REQUEST_TYPE)
+}
+
+size_t unpack_matrix_query_request(const void *buf, matrix_query_request *elem) {
+    align_unpack_msg(buf, elem, matrix_query_request)
+}
+
+int send_matrix_query_response(int sock, const matrix_query_response *elem) {
+    align_send_msg(sock, elem, matrix_query_response, WSERVER_MATRIX_QUERY_RESPONSE_TYPE)
+}
+
+int recv_matrix_query_response(int sock, matrix_query_response *elem) {
+    align_recv_msg(sock, elem, matrix_query_response, WSERVER_MATRIX_QUERY_RESPONSE_TYPE)
+}
+
+size_t pack_matrix_query_response(void *buf, const matrix_query_response *elem) {
+    align_pack_msg(buf, elem, matrix_query_response, WSERVER_MATRIX_QUERY_RESPONSE_TYPE)
+}
+
+size_t unpack_matrix_query_response(const void *buf, matrix_query_response *elem) {
+    align_unpack_msg(buf, elem, matrix_query_response)
+}
+
+int send_station_query_request(int sock, const station_query_request *elem) {
+    align_send_msg(sock, elem, station_query_request, WSERVER_STATION_QUERY_REQUEST_TYPE)
+}
+
+int recv_station_query_request(int sock, station_query_request *elem) {
+    align_recv_msg(sock, elem, station_query_request, WSERVER_STATION_QUERY_REQUEST_TYPE)
+}
+
+size_t pack_station_query_request(void *buf, const station_query_request *elem) {
+    align_pack_msg(buf, elem, station_query_request, WSERVER_STATION_QUERY_REQUEST_TYPE)
+}
+
+size_t unpack_station_query_request(const void *buf, station_query_request *elem) {
+    align_unpack_msg(buf, elem, station_query_request)
+}
+
+int send_station_query_response(int sock, const station_query_response *elem) {
+    align_send_msg(sock, elem, station_query_response, WSERVER_STATION_QUERY_RESPONSE_TYPE)
+}
+
+int recv_station_query_response(int sock, station_query_response *elem) {
+    align_recv_msg(sock, elem, station_query_response, WSERVER_STATION_QUERY_RESPONSE_TYPE)
+}
+
+size_t pack_station_query_response(void *buf, const station_query_response *elem) {
+    align_pack_msg(buf, elem, station_query_response, WSERVER_STATION_QUERY_RESPONSE_TYPE)
+}
+
+size_t unpack_station_query_response(const void *buf, station_query_response *elem) {
+    align_unpack_msg(buf, elem, station_query_response)
+}
+
+int send_station_info_entrys(int sock, const station_info_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, station_info_entry)
+}
+
+int recv_station_info_entrys(int sock, station_info_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, station_info_entry)
+}
+
+size_t pack_station_info_entrys(void *buf, const station_info_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, station_info_entry)
+}
+
+size_t unpack_station_info_entrys(const void *buf, station_info_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, station_info_entry)
+}
+
+int send_subscribe_request(int sock, const subscribe_request *elem) {
+    align_send_msg(sock, elem, subscribe_request, WSERVER_SUBSCRIBE_REQUEST_TYPE)
+}
+
+int recv_subscribe_request(int sock, subscribe_request *elem) {
+    align_recv_msg(sock, elem, subscribe_request, WSERVER_SUBSCRIBE_REQUEST_TYPE)
+}
+
+size_t pack_subscribe_request(void *buf, const subscribe_request *elem) {
+    align_pack_msg(buf, elem, subscribe_request, WSERVER_SUBSCRIBE_REQUEST_TYPE)
+}
+
+size_t unpack_subscribe_request(const void *buf, subscribe_request *elem) {
+    align_unpack_msg(buf, elem, subscribe_request)
+}
+
+int send_subscribe_response(int sock, const subscribe_response *elem) {
+    align_send_msg(sock, elem, subscribe_response, WSERVER_SUBSCRIBE_RESPONSE_TYPE)
+}
+
+int recv_subscribe_response(int sock, subscribe_response *elem) {
+    align_recv_msg(sock, elem, subscribe_response, WSERVER_SUBSCRIBE_RESPONSE_TYPE)
+}
+
+size_t pack_subscribe_response(void *buf, const subscribe_response *elem) {
+    align_pack_msg(buf, elem, subscribe_response, WSERVER_SUBSCRIBE_RESPONSE_TYPE)
+}
+
+size_t unpack_subscribe_response(const void *buf, subscribe_response *elem) {
+    align_unpack_msg(buf, elem, subscribe_response)
+}
+
+int send_link_delta_notification(int sock, const link_delta_notification *elem) {
+    align_send_msg(sock, elem, link_delta_notification, WSERVER_LINK_DELTA_NOTIFICATION_TYPE)
+}
+
+int recv_link_delta_notification(int sock, link_delta_notification *elem) {
+    align_recv_msg(sock, elem, link_delta_notification, WSERVER_LINK_DELTA_NOTIFICATION_TYPE)
+}
+
+size_t pack_link_delta_notification(void *buf, const link_delta_notification *elem) {
+    align_pack_msg(buf, elem, link_delta_notification, WSERVER_LINK_DELTA_NOTIFICATION_TYPE)
+}
+
+size_t unpack_link_delta_notification(const void *buf, link_delta_notification *elem) {
+    align_unpack_msg(buf, elem, link_delta_notification)
+}
+
+int send_link_delta_entrys(int sock, const link_delta_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, link_delta_entry)
+}
+
+int recv_link_delta_entrys(int sock, link_delta_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, link_delta_entry)
+}
+
+size_t pack_link_delta_entrys(void *buf, const link_delta_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, link_delta_entry)
+}
+
+size_t unpack_link_delta_entrys(const void *buf, link_delta_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, link_delta_entry)
+}
+
+int send_shm_attach_request(int sock, const shm_attach_request *elem) {
+    align_send_msg(sock, elem, shm_attach_request, WSERVER_SHM_ATTACH_REQUEST_TYPE)
+}
+
+int recv_shm_attach_request(int sock, shm_attach_request *elem) {
+    align_recv_msg(sock, elem, shm_attach_request, WSERVER_SHM_ATTACH_REQUEST_TYPE)
+}
+
+size_t pack_shm_attach_request(void *buf, const shm_attach_request *elem) {
+    align_pack_msg(buf, elem, shm_attach_request, WSERVER_SHM_ATTACH_REQUEST_TYPE)
+}
+
+size_t unpack_shm_attach_request(const void *buf, shm_attach_request *elem) {
+    align_unpack_msg(buf, elem, shm_attach_request)
+}
+
+int send_shm_attach_response(int sock, const shm_attach_response *elem) {
+    align_send_msg(sock, elem, shm_attach_response, WSERVER_SHM_ATTACH_RESPONSE_TYPE)
+}
+
+int recv_shm_attach_response(int sock, shm_attach_response *elem) {
+    align_recv_msg(sock, elem, shm_attach_response, WSERVER_SHM_ATTACH_RESPONSE_TYPE)
+}
+
+size_t pack_shm_attach_response(void *buf, const shm_attach_response *elem) {
+    align_pack_msg(buf, elem, shm_attach_response, WSERVER_SHM_ATTACH_RESPONSE_TYPE)
+}
+
+size_t unpack_shm_attach_response(const void *buf, shm_attach_response *elem) {
+    align_unpack_msg(buf, elem, shm_attach_response)
+}
+
+int send_link_stats_request(int sock, const link_stats_request *elem) {
+    align_send_msg(sock, elem, link_stats_request, WSERVER_LINK_STATS_REQUEST_TYPE)
+}
+
+int recv_link_stats_request(int sock, link_stats_request *elem) {
+    align_recv_msg(sock, elem, link_stats_request, WSERVER_LINK_STATS_REQUEST_TYPE)
+}
+
+size_t pack_link_stats_request(void *buf, const link_stats_request *elem) {
+    align_pack_msg(buf, elem, link_stats_request, WSERVER_LINK_STATS_REQUEST_TYPE)
+}
+
+size_t unpack_link_stats_request(const void *buf, link_stats_request *elem) {
+    align_unpack_msg(buf, elem, link_stats_request)
+}
+
+int send_link_stats_response(int sock, const link_stats_response *elem) {
+    align_send_msg(sock, elem, link_stats_response, WSERVER_LINK_STATS_RESPONSE_TYPE)
+}
+
+int recv_link_stats_response(int sock, link_stats_response *elem) {
+    align_recv_msg(sock, elem, link_stats_response, WSERVER_LINK_STATS_RESPONSE_TYPE)
+}
+
+size_t pack_link_stats_response(void *buf, const link_stats_response *elem) {
+    align_pack_msg(buf, elem, link_stats_response, WSERVER_LINK_STATS_RESPONSE_TYPE)
+}
+
+size_t unpack_link_stats_response(const void *buf, link_stats_response *elem) {
+    align_unpack_msg(buf, elem, link_stats_response)
+}
+
+int send_link_stats_entrys(int sock, const link_stats_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, link_stats_entry)
+}
+
+int recv_link_stats_entrys(int sock, link_stats_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, link_stats_entry)
+}
+
+size_t pack_link_stats_entrys(void *buf, const link_stats_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, link_stats_entry)
+}
+
+size_t unpack_link_stats_entrys(const void *buf, link_stats_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, link_stats_entry)
+}
+
+int send_metrics_request(int sock, const metrics_request *elem) {
+    align_send_msg(sock, elem, metrics_request, WSERVER_METRICS_REQUEST_TYPE)
+}
+
+int recv_metrics_request(int sock, metrics_request *elem) {
+    align_recv_msg(sock, elem, metrics_request, WSERVER_METRICS_REQUEST_TYPE)
+}
+
+size_t pack_metrics_request(void *buf, const metrics_request *elem) {
+    align_pack_msg(buf, elem, metrics_request, WSERVER_METRICS_REQUEST_TYPE)
+}
+
+size_t unpack_metrics_request(const void *buf, metrics_request *elem) {
+    align_unpack_msg(buf, elem, metrics_request)
+}
+
+int send_metrics_response(int sock, const metrics_response *elem) {
+    align_send_msg(sock, elem, metrics_response, WSERVER_METRICS_RESPONSE_TYPE)
+}
+
+int recv_metrics_response(int sock, metrics_response *elem) {
+    align_recv_msg(sock, elem, metrics_response, WSERVER_METRICS_RESPONSE_TYPE)
+}
+
+size_t pack_metrics_response(void *buf, const metrics_response *elem) {
+    align_pack_msg(buf, elem, metrics_response, WSERVER_METRICS_RESPONSE_TYPE)
+}
+
+size_t unpack_metrics_response(const void *buf, metrics_response *elem) {
+    align_unpack_msg(buf, elem, metrics_response)
+}
+
+int send_metrics_stage_entrys(int sock, const metrics_stage_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, metrics_stage_entry)
+}
+
+int recv_metrics_stage_entrys(int sock, metrics_stage_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, metrics_stage_entry)
+}
+
+size_t pack_metrics_stage_entrys(void *buf, const metrics_stage_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, metrics_stage_entry)
+}
+
+size_t unpack_metrics_stage_entrys(const void *buf, metrics_stage_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, metrics_stage_entry)
+}
+
+int send_recorder_request(int sock, const recorder_request *elem) {
+    align_send_msg(sock, elem, recorder_request, WSERVER_RECORDER_REQUEST_TYPE)
+}
+
+int recv_recorder_request(int sock, recorder_request *elem) {
+    align_recv_msg(sock, elem, recorder_request, WSERVER_RECORDER_REQUEST_TYPE)
+}
+
+size_t pack_recorder_request(void *buf, const recorder_request *elem) {
+    align_pack_msg(buf, elem, recorder_request, WSERVER_RECORDER_REQUEST_TYPE)
+}
+
+size_t unpack_recorder_request(const void *buf, recorder_request *elem) {
+    align_unpack_msg(buf, elem, recorder_request)
+}
+
+int send_recorder_response(int sock, const recorder_response *elem) {
+    align_send_msg(sock, elem, recorder_response, WSERVER_RECORDER_RESPONSE_TYPE)
+}
+
+int recv_recorder_response(int sock, recorder_response *elem) {
+    align_recv_msg(sock, elem, recorder_response, WSERVER_RECORDER_RESPONSE_TYPE)
+}
+
+size_t pack_recorder_response(void *buf, const recorder_response *elem) {
+    align_pack_msg(buf, elem, recorder_response, WSERVER_RECORDER_RESPONSE_TYPE)
+}
+
+size_t unpack_recorder_response(const void *buf, recorder_response *elem) {
+    align_unpack_msg(buf, elem, recorder_response)
+}
+
+int send_recorder_entrys(int sock, const recorder_entry *entries, u32 count) {
+    align_send_entries(sock, entries, count, recorder_entry)
+}
+
+int recv_recorder_entrys(int sock, recorder_entry *entries, u32 count) {
+    align_recv_entries(sock, entries, count, recorder_entry)
+}
+
+size_t pack_recorder_entrys(void *buf, const recorder_entry *entries, u32 count) {
+    align_pack_entries(buf, entries, count, recorder_entry)
+}
+
+size_t unpack_recorder_entrys(const void *buf, recorder_entry *entries, u32 count) {
+    align_unpack_entries(buf, entries, count, recorder_entry)
+}
+
 int wserver_recv_msg_base(int sock_fd, wserver_msg *base, int *recv_type) {
     int ret = recvfull(sock_fd, base, sizeof(wserver_msg), 0, 0);
     if (ret) {
@@ -226,6 +1113,34 @@ int wserver_recv_msg_base(int sock_fd, wserver_msg *base, int *recv_type) {
     return 0;
 }
 
+int wserver_recv_msg_base_fd(int sock_fd, wserver_msg *base, int *recv_type, int *fd) {
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = {base, sizeof(wserver_msg)};
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof(control),
+    };
+
+    *fd = -1;
+    ssize_t ret = recvmsg(sock_fd, &msg, MSG_CMSG_CLOEXEC);
+    if (ret < 0) {
+        return errno == ECONNRESET ? WACTION_DISCONNECTED : -errno;
+    } else if (ret == 0) {
+        return WACTION_DISCONNECTED;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    ntoh_base(base);
+    *recv_type = base->type;
+    hton_base(base);
+    return 0;
+}
+
 ssize_t get_msg_size_by_type(int type) {
     switch (type) {
         case WSERVER_SHUTDOWN_REQUEST_TYPE:
@@ -250,6 +1165,18 @@ ssize_t get_msg_size_by_type(int type) {
             return sizeof(errprob_update_request);
         case WSERVER_ERRPROB_UPDATE_RESPONSE_TYPE:
             return sizeof(errprob_update_response);
+        case WSERVER_SPECPROB_UPDATE_REQUEST_TYPE:
+            return sizeof(specprob_update_request);
+        case WSERVER_SPECPROB_UPDATE_RESPONSE_TYPE:
+            return sizeof(specprob_update_response);
+        case WSERVER_GAUSSIAN_RANDOM_UPDATE_REQUEST_TYPE:
+            return sizeof(gaussian_random_update_request);
+        case WSERVER_GAUSSIAN_RANDOM_UPDATE_RESPONSE_TYPE:
+            return sizeof(gaussian_random_update_response);
+        case WSERVER_HEIGHT_UPDATE_REQUEST_TYPE:
+            return sizeof(height_update_request);
+        case WSERVER_HEIGHT_UPDATE_RESPONSE_TYPE:
+            return sizeof(height_update_response);
         case WSERVER_POSITION_UPDATE_REQUEST_TYPE:
 			return sizeof(position_update_request);
 		case WSERVER_POSITION_UPDATE_RESPONSE_TYPE:
@@ -266,6 +1193,60 @@ ssize_t get_msg_size_by_type(int type) {
             return sizeof(medium_update_request);
         case WSERVER_MEDIUM_UPDATE_RESPONSE_TYPE:
             return sizeof(medium_update_response);
+        case WSERVER_BULK_ADD_REQUEST_TYPE:
+            return sizeof(station_bulk_add_request);
+        case WSERVER_BULK_ADD_RESPONSE_TYPE:
+            return sizeof(station_bulk_add_response);
+        case WSERVER_BULK_DEL_REQUEST_TYPE:
+            return sizeof(station_bulk_del_request);
+        case WSERVER_BULK_DEL_RESPONSE_TYPE:
+            return sizeof(station_bulk_del_response);
+        case WSERVER_MATRIX_ROWS_REQUEST_TYPE:
+            return sizeof(matrix_rows_request);
+        case WSERVER_MATRIX_ROWS_RESPONSE_TYPE:
+            return sizeof(matrix_rows_response);
+        case WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE:
+            return sizeof(matrix_triplets_request);
+        case WSERVER_MATRIX_TRIPLETS_RESPONSE_TYPE:
+            return sizeof(matrix_triplets_response);
+        case WSERVER_STATION_UPDATE_REQUEST_TYPE:
+            return sizeof(station_update_request);
+        case WSERVER_STATION_UPDATE_RESPONSE_TYPE:
+            return sizeof(station_update_response);
+        case WSERVER_LINK_QUERY_REQUEST_TYPE:
+            return sizeof(link_query_request);
+        case WSERVER_LINK_QUERY_RESPONSE_TYPE:
+            return sizeof(link_query_response);
+        case WSERVER_MATRIX_QUERY_REQUEST_TYPE:
+            return sizeof(matrix_query_request);
+        case WSERVER_MATRIX_QUERY_RESPONSE_TYPE:
+            return sizeof(matrix_query_response);
+        case WSERVER_STATION_QUERY_REQUEST_TYPE:
+            return sizeof(station_query_request);
+        case WSERVER_STATION_QUERY_RESPONSE_TYPE:
+            return sizeof(station_query_response);
+        case WSERVER_SUBSCRIBE_REQUEST_TYPE:
+            return sizeof(subscribe_request);
+        case WSERVER_SUBSCRIBE_RESPONSE_TYPE:
+            return sizeof(subscribe_response);
+        case WSERVER_LINK_DELTA_NOTIFICATION_TYPE:
+            return sizeof(link_delta_notification);
+        case WSERVER_SHM_ATTACH_REQUEST_TYPE:
+            return sizeof(shm_attach_request);
+        case WSERVER_SHM_ATTACH_RESPONSE_TYPE:
+            return sizeof(shm_attach_response);
+        case WSERVER_LINK_STATS_REQUEST_TYPE:
+            return sizeof(link_stats_request);
+        case WSERVER_LINK_STATS_RESPONSE_TYPE:
+            return sizeof(link_stats_response);
+        case WSERVER_METRICS_REQUEST_TYPE:
+            return sizeof(metrics_request);
+        case WSERVER_METRICS_RESPONSE_TYPE:
+            return sizeof(metrics_response);
+        case WSERVER_RECORDER_REQUEST_TYPE:
+            return sizeof(recorder_request);
+        case WSERVER_RECORDER_RESPONSE_TYPE:
+            return sizeof(recorder_response);
         default:
             return -1;
     }
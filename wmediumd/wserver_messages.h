@@ -39,6 +39,10 @@
  * http://www.pathname.com/fhs/pub/fhs-2.3.html#PURPOSE46 */
 #define WSERVER_SOCKET_PATH "/var/run/wmediumd.sock"
 
+/* Flags carried in the high bit of a request's type byte */
+#define WSERVER_TYPE_MASK 0x7f
+#define WSERVER_FLAG_QUIET 0x80 /* only respond if the request failed */
+
 #define WSERVER_SHUTDOWN_REQUEST_TYPE 0
 #define WSERVER_SNR_UPDATE_REQUEST_TYPE 1
 #define WSERVER_SNR_UPDATE_RESPONSE_TYPE 2
@@ -64,6 +68,61 @@
 #define WSERVER_GAUSSIAN_RANDOM_UPDATE_RESPONSE_TYPE 22
 #define WSERVER_MEDIUM_UPDATE_REQUEST_TYPE 23
 #define WSERVER_MEDIUM_UPDATE_RESPONSE_TYPE 24
+#define WSERVER_BULK_ADD_REQUEST_TYPE 25
+#define WSERVER_BULK_ADD_RESPONSE_TYPE 26
+#define WSERVER_BULK_DEL_REQUEST_TYPE 27
+#define WSERVER_BULK_DEL_RESPONSE_TYPE 28
+#define WSERVER_MATRIX_ROWS_REQUEST_TYPE 29
+#define WSERVER_MATRIX_ROWS_RESPONSE_TYPE 30
+#define WSERVER_MATRIX_TRIPLETS_REQUEST_TYPE 31
+#define WSERVER_MATRIX_TRIPLETS_RESPONSE_TYPE 32
+#define WSERVER_STATION_UPDATE_REQUEST_TYPE 33
+#define WSERVER_STATION_UPDATE_RESPONSE_TYPE 34
+#define WSERVER_LINK_QUERY_REQUEST_TYPE 35
+#define WSERVER_LINK_QUERY_RESPONSE_TYPE 36
+#define WSERVER_MATRIX_QUERY_REQUEST_TYPE 37
+#define WSERVER_MATRIX_QUERY_RESPONSE_TYPE 38
+#define WSERVER_STATION_QUERY_REQUEST_TYPE 39
+#define WSERVER_STATION_QUERY_RESPONSE_TYPE 40
+#define WSERVER_SUBSCRIBE_REQUEST_TYPE 41
+#define WSERVER_SUBSCRIBE_RESPONSE_TYPE 42
+#define WSERVER_LINK_DELTA_NOTIFICATION_TYPE 43
+#define WSERVER_SHM_ATTACH_REQUEST_TYPE 44
+#define WSERVER_SHM_ATTACH_RESPONSE_TYPE 45
+#define WSERVER_LINK_STATS_REQUEST_TYPE 46
+#define WSERVER_LINK_STATS_RESPONSE_TYPE 47
+#define WSERVER_METRICS_REQUEST_TYPE 48
+#define WSERVER_METRICS_RESPONSE_TYPE 49
+#define WSERVER_RECORDER_REQUEST_TYPE 50
+#define WSERVER_RECORDER_RESPONSE_TYPE 51
+
+/* Maximum number of stations in one bulk request */
+#define WSERVER_BULK_MAX_STATIONS 65536
+
+/* Properties set by a station_bulk_add_entry or station_update_entry */
+#define WPROP_POSITION (1 << 0)
+#define WPROP_TXPOWER (1 << 1)
+#define WPROP_GAIN (1 << 2)
+#define WPROP_GAUSSIAN_RANDOM (1 << 3)
+
+/* Matrix targeted by a matrix upload */
+#define WMATRIX_SNR 0 /* values are i32 SNR in dB */
+#define WMATRIX_ERRPROB 1 /* values are fixed point error probabilities */
+
+/* Flags of a matrix upload */
+#define WMATRIX_F_SYMMETRIC (1 << 0) /* also set to -> from */
+
+/* Maximum number of values in one matrix upload */
+#define WSERVER_MATRIX_MAX_CELLS (1 << 24)
+
+/* SNR of a link that did not exist before, or does not exist anymore */
+#define WSERVER_SNR_NONE INT32_MIN
+
+/* Maximum number of entries in one link_delta_notification */
+#define WSERVER_DELTA_MAX_ENTRIES 65536
+
+/* At most this many links in a link_stats_response */
+#define WSERVER_LINK_STATS_MAX_ENTRIES 65536
 
 #define SPECIFIC_MATRIX_MAX_SIZE_IDX (12)
 #define SPECIFIC_MATRIX_MAX_RATE_IDX (12)
@@ -78,6 +137,7 @@ typedef uint8_t u8;
 typedef int32_t i32;
 typedef float f32;
 typedef uint32_t u32;
+typedef uint64_t u64;
 
 /*
  * Macro for unused parameters
@@ -238,6 +298,412 @@ typedef struct __packed {
     u8 update_result;
 } medium_update_response;
 
+/*
+ * Bulk messages consist of a fixed header followed by count entries
+ */
+typedef struct __packed {
+    u8 addr[ETH_ALEN];
+    u8 props; /* WPROP_* */
+    f32 posX;
+    f32 posY;
+    f32 posZ;
+    i32 txpower_;
+    i32 gain_;
+    f32 gaussian_random_;
+} station_bulk_add_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_bulk_add_request;
+
+typedef struct __packed {
+    i32 created_id;
+    u8 update_result;
+} station_bulk_add_result;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_bulk_add_response;
+
+typedef struct __packed {
+    u8 addr[ETH_ALEN];
+} station_bulk_del_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_bulk_del_request;
+
+typedef struct __packed {
+    u8 update_result;
+} station_bulk_del_result;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_bulk_del_response;
+
+/*
+ * A matrix_rows_request is followed by num_rows matrix_addr_entry naming
+ * the senders, num_cols matrix_addr_entry naming the receivers, and then
+ * num_rows * num_cols matrix_value_entry in row-major order. Uploading a
+ * full matrix names every station as both row and column.
+ */
+typedef struct __packed {
+    u8 addr[ETH_ALEN];
+} matrix_addr_entry;
+
+typedef struct __packed {
+    u32 value; /* i32 SNR or fixed point errprob, see WMATRIX_* */
+} matrix_value_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u8 matrix; /* WMATRIX_* */
+    u8 flags; /* WMATRIX_F_* */
+    u32 num_rows;
+    u32 num_cols;
+} matrix_rows_request;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 applied; /* number of links set */
+    u32 not_found; /* number of addresses without station */
+    u8 update_result;
+} matrix_rows_response;
+
+/*
+ * A matrix_triplets_request is followed by count matrix_triplet_entry
+ */
+typedef struct __packed {
+    u8 from_addr[ETH_ALEN];
+    u8 to_addr[ETH_ALEN];
+    u32 value; /* i32 SNR or fixed point errprob, see WMATRIX_* */
+} matrix_triplet_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u8 matrix; /* WMATRIX_* */
+    u8 flags; /* WMATRIX_F_* */
+    u32 count;
+} matrix_triplets_request;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 applied; /* number of links set */
+    u32 not_found; /* number of triplets naming an unknown station */
+    u8 update_result;
+} matrix_triplets_response;
+
+/*
+ * A station_update_request is followed by count station_update_entry, all
+ * applied together. The response is followed by count station_update_result.
+ */
+typedef struct __packed {
+    u8 addr[ETH_ALEN];
+    u8 props; /* WPROP_* */
+    f32 posX;
+    f32 posY;
+    f32 posZ;
+    i32 txpower_;
+    i32 gain_;
+    f32 gaussian_random_;
+} station_update_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_update_request;
+
+typedef struct __packed {
+    u8 update_result;
+} station_update_result;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_update_response;
+
+/*
+ * Queries are answered from one link state snapshot, identified by the low
+ * 32 bits of its version, without blocking the frame path.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u8 from_addr[ETH_ALEN];
+    u8 to_addr[ETH_ALEN];
+} link_query_request;
+
+typedef struct __packed {
+    wserver_msg base;
+    link_query_request request;
+    u32 version;
+    i32 snr;
+    u32 errprob; /* fixed point, 0 without an error probability matrix */
+    u8 update_result;
+} link_query_response;
+
+/*
+ * A matrix_query_request is followed by num_rows matrix_addr_entry naming
+ * the senders to return, none for all of them. The response is followed
+ * by num_rows and num_cols matrix_addr_entry and num_rows * num_cols
+ * matrix_value_entry, laid out like a matrix_rows_request.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u8 matrix; /* WMATRIX_* */
+    u32 num_rows;
+} matrix_query_request;
+
+typedef struct __packed {
+    wserver_msg base;
+    u8 matrix; /* WMATRIX_* */
+    u32 version;
+    u32 num_rows;
+    u32 num_cols;
+    u32 not_found; /* number of requested rows without station */
+    u8 update_result;
+} matrix_query_response;
+
+/*
+ * A station_query_request is followed by count matrix_addr_entry, none for
+ * all stations. The response is followed by count station_info_entry.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} station_query_request;
+
+typedef struct __packed {
+    u8 addr[ETH_ALEN];
+    u8 update_result;
+    f32 posX;
+    f32 posY;
+    f32 posZ;
+    i32 txpower_;
+    i32 gain_;
+    f32 gaussian_random_;
+    i32 isap;
+    i32 medium_id_;
+} station_info_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 version;
+    u32 count;
+} station_query_response;
+
+/*
+ * After a successful subscribe_request the server pushes a
+ * link_delta_notification, followed by count link_delta_entry, whenever
+ * published links moved by at least threshold dB from what the client was
+ * last told. Large changes are split over several notifications.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u8 enable; /* 0 to unsubscribe */
+    i32 threshold; /* in dB, at least 1 */
+} subscribe_request;
+
+typedef struct __packed {
+    wserver_msg base;
+    subscribe_request request;
+    u32 version; /* snapshot the deltas start from */
+    u8 update_result;
+} subscribe_response;
+
+typedef struct __packed {
+    u8 from_addr[ETH_ALEN];
+    u8 to_addr[ETH_ALEN];
+    i32 old_snr; /* WSERVER_SNR_NONE for a new link */
+    i32 new_snr; /* WSERVER_SNR_NONE for a removed link */
+} link_delta_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 version;
+    u32 tv_sec; /* CLOCK_REALTIME of the change */
+    u32 tv_nsec;
+    u32 count;
+} link_delta_notification;
+
+/*
+ * A successful shm_attach_response carries a memfd (SCM_RIGHTS, receive the
+ * response with wserver_recv_msg_base_fd()) of size bytes: a
+ * wserver_shm_header followed by num_slots wserver_shm_slot. The region
+ * lives as long as the connection it was requested on.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u32 num_slots;
+} shm_attach_request;
+
+typedef struct __packed {
+    wserver_msg base;
+    shm_attach_request request;
+    u32 size;
+    u8 update_result;
+} shm_attach_response;
+
+/*
+ * Shared memory control plane, in host byte order. Each slot is owned by
+ * the writing process: it sets addr and the WPROP_* fields in props, and
+ * brackets every change with wserver_shm_slot_begin()/_end(). The server
+ * polls the slots and applies a slot again whenever seq has moved on to a
+ * new even value, so seq doubles as the slot's generation counter.
+ */
+#define WSERVER_SHM_MAGIC 0x48534d57 /* "WMSH" */
+#define WSERVER_SHM_VERSION 1
+
+struct wserver_shm_header {
+    u32 magic;
+    u32 version;
+    u32 num_slots;
+    u32 slot_size;
+    u32 reserved[12];
+};
+
+struct wserver_shm_slot {
+    u32 seq; /* odd while the writer is changing the slot */
+    u32 props; /* WPROP_* set by this slot */
+    u8 addr[8]; /* ETH_ALEN used */
+    f32 posX;
+    f32 posY;
+    f32 posZ;
+    i32 txpower_;
+    i32 gain_;
+    f32 gaussian_random_;
+    u32 reserved[6];
+};
+
+/**
+ * Start changing a shared memory slot
+ */
+static inline void wserver_shm_slot_begin(struct wserver_shm_slot *slot) {
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * Publish the changes to a shared memory slot
+ */
+static inline void wserver_shm_slot_end(struct wserver_shm_slot *slot) {
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * A link_stats_request is followed by count matrix_addr_entry naming the
+ * senders of interest, none for all. The response is followed by count
+ * link_stats_entry, one per link that carried frames, sorted by sender and
+ * receiver. Per station totals are the sums over the entries of a sender.
+ * Group frames are counted on the link to ff:ff:ff:ff:ff:ff.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+} link_stats_request;
+
+typedef struct __packed {
+    u8 from_addr[ETH_ALEN];
+    u8 to_addr[ETH_ALEN];
+    u64 frames;
+    u64 acked;
+    u64 failed;
+    u64 retries;
+    u64 bytes;
+    u64 airtime; /* usec */
+    u8 update_result;
+} link_stats_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u32 count;
+    u32 total; /* links matching the request, count is capped */
+} link_stats_response;
+
+/*
+ * A metrics_response carries the frame path counters and is followed by
+ * count metrics_stage_entry: per stage one for all access categories
+ * (ac 0xff) and one for each access category that saw frames. Stages and
+ * access categories are numbered as enum metrics_stage and enum
+ * ieee80211_ac_number, latencies are in ns.
+ */
+typedef struct __packed {
+    wserver_msg base;
+} metrics_request;
+
+typedef struct __packed {
+    u8 stage;
+    u8 ac;
+    u64 count;
+    u64 sum;
+    u64 max;
+    u64 p50;
+    u64 p90;
+    u64 p99;
+    u64 p999;
+    u8 update_result;
+} metrics_stage_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u64 frames;
+    u64 dropped;
+    u64 global_errors;
+    u64 tx_status_errors;
+    u32 count;
+} metrics_response;
+
+/*
+ * A recorder_request asks for the latest max frames of the flight
+ * recorder, 0 for all it holds. The response is followed by count
+ * recorder_entry, oldest first. The stage times are CLOCK_MONOTONIC ns
+ * and 0 for stages the frame did not reach; outcome and ac are numbered
+ * as enum recorder_outcome and enum ieee80211_ac_number.
+ */
+typedef struct __packed {
+    wserver_msg base;
+    u32 max;
+} recorder_request;
+
+typedef struct __packed {
+    u64 cookie;
+    u64 received;
+    u64 parsed;
+    u64 sent;
+    u64 replied;
+    u64 status_sent;
+    u8 sender_addr[ETH_ALEN];
+    u8 receiver_addr[ETH_ALEN];
+    u32 freq;
+    i32 signal;
+    u32 flags;
+    u32 data_len;
+    i32 rate_idx;
+    u8 attempts;
+    u8 ac;
+    u8 outcome;
+    u8 update_result;
+} recorder_entry;
+
+typedef struct __packed {
+    wserver_msg base;
+    u64 total; /* frames recorded since the start */
+    u32 count;
+} recorder_response;
+
+/**
+ * Receive the wserver_msg from a socket along with a passed file descriptor
+ * @param sock_fd The socket file descriptor
+ * @param base Where to store the wserver_msg
+ * @param recv_type The received WSERVER_*_TYPE
+ * @param fd Receives the passed descriptor, or -1 if there was none
+ * @return A positive WACTION_* constant, or a negative errno value
+ */
+int wserver_recv_msg_base_fd(int sock_fd, wserver_msg *base, int *recv_type, int *fd);
+
 /**
  * Receive the wserver_msg from a socket
  * @param sock_fd The socket file descriptor
@@ -267,8 +733,80 @@ int wserver_recv_msg_base(int sock_fd, wserver_msg *base, int *recv_type);
 #define wserver_recv_msg(sock_fd, elem, type) \
     recv_##type(sock_fd, elem)
 
+/**
+ * Send the entries following a bulk message header
+ * @param sock_fd The socket file descriptor
+ * @param entries The entries to send
+ * @param count The number of entries
+ * @param type The entry type struct
+ * @return 0 on success
+ */
+#define wserver_send_entries(sock_fd, entries, count, type) \
+    send_##type##s(sock_fd, entries, count)
+
+/**
+ * Receive the entries following a bulk message header
+ * @param sock_fd The socket file descriptor
+ * @param entries Where to store count entries
+ * @param count The number of entries
+ * @param type The entry type struct
+ * @return A positive WACTION_* constant, or a negative errno value
+ */
+#define wserver_recv_entries(sock_fd, entries, count, type) \
+    recv_##type##s(sock_fd, entries, count)
+
+/**
+ * Encode a wserver msg into a buffer in network byte order
+ * @param buf Where to store the message, at least sizeof(type) bytes
+ * @param elem The message to encode
+ * @param type The message type struct
+ * @return The number of bytes written
+ */
+#define wserver_pack_msg(buf, elem, type) \
+    pack_##type(buf, elem)
+
+/**
+ * Encode a request with WSERVER_FLAG_QUIET set, the server then only
+ * responds if it fails. Requests may be written back-to-back without
+ * waiting for responses, they are processed in order.
+ * @param buf Where to write, at least sizeof(type) bytes
+ * @param elem The request to encode
+ * @param type The request type struct
+ * @return The number of bytes written
+ */
+#define wserver_pack_quiet_msg(buf, elem, type) ({ \
+    size_t len_ = pack_##type(buf, elem); \
+    *(u8 *) (buf) |= WSERVER_FLAG_QUIET; \
+    len_; \
+})
+
+/**
+ * Decode a wserver msg from a buffer in network byte order
+ * @param buf The received bytes, at least sizeof(type)
+ * @param elem Where to store the msg
+ * @param type The message type struct
+ * @return The number of bytes consumed
+ */
+#define wserver_unpack_msg(buf, elem, type) \
+    unpack_##type(buf, elem)
+
+/**
+ * Encode the entries following a bulk message header into a buffer
+ * @return The number of bytes written
+ */
+#define wserver_pack_entries(buf, entries, count, type) \
+    pack_##type##s(buf, entries, count)
+
+/**
+ * Decode the entries following a bulk message header from a buffer
+ * @return The number of bytes consumed
+ */
+#define wserver_unpack_entries(buf, entries, count, type) \
+    unpack_##type##s(buf, entries, count)
+
 /**
  * Get the size of a request/response based on its type
+ * For bulk messages this is the size of the header without the entries
  * @param type The WSERVER_*_TYPE
  * @return The size or -1 if not found
  */
@@ -370,6 +908,422 @@ int recv_medium_update_request(int sock, medium_update_request *elem);
 
 int recv_medium_update_response(int sock, medium_update_response *elem);
 
+int send_station_bulk_add_request(int sock, const station_bulk_add_request *elem);
+
+int recv_station_bulk_add_request(int sock, station_bulk_add_request *elem);
+
+int send_station_bulk_add_response(int sock, const station_bulk_add_response *elem);
+
+int recv_station_bulk_add_response(int sock, station_bulk_add_response *elem);
+
+int send_station_bulk_del_request(int sock, const station_bulk_del_request *elem);
+
+int recv_station_bulk_del_request(int sock, station_bulk_del_request *elem);
+
+int send_station_bulk_del_response(int sock, const station_bulk_del_response *elem);
+
+int recv_station_bulk_del_response(int sock, station_bulk_del_response *elem);
+
+int send_station_bulk_add_entrys(int sock, const station_bulk_add_entry *entries, u32 count);
+
+int recv_station_bulk_add_entrys(int sock, station_bulk_add_entry *entries, u32 count);
+
+int send_station_bulk_add_results(int sock, const station_bulk_add_result *entries, u32 count);
+
+int recv_station_bulk_add_results(int sock, station_bulk_add_result *entries, u32 count);
+
+int send_station_bulk_del_entrys(int sock, const station_bulk_del_entry *entries, u32 count);
+
+int recv_station_bulk_del_entrys(int sock, station_bulk_del_entry *entries, u32 count);
+
+int send_station_bulk_del_results(int sock, const station_bulk_del_result *entries, u32 count);
+
+int recv_station_bulk_del_results(int sock, station_bulk_del_result *entries, u32 count);
+
+size_t pack_snr_update_request(void *buf, const snr_update_request *elem);
+
+size_t pack_snr_update_response(void *buf, const snr_update_response *elem);
+
+size_t pack_position_update_request(void *buf, const position_update_request *elem);
+
+size_t pack_position_update_response(void *buf, const position_update_response *elem);
+
+size_t pack_txpower_update_request(void *buf, const txpower_update_request *elem);
+
+size_t pack_txpower_update_response(void *buf, const txpower_update_response *elem);
+
+size_t pack_gaussian_random_update_request(void *buf, const gaussian_random_update_request *elem);
+
+size_t pack_gaussian_random_update_response(void *buf, const gaussian_random_update_response *elem);
+
+size_t pack_gain_update_request(void *buf, const gain_update_request *elem);
+
+size_t pack_gain_update_response(void *buf, const gain_update_response *elem);
+
+size_t pack_errprob_update_request(void *buf, const errprob_update_request *elem);
+
+size_t pack_errprob_update_response(void *buf, const errprob_update_response *elem);
+
+size_t pack_specprob_update_request(void *buf, const specprob_update_request *elem);
+
+size_t pack_specprob_update_response(void *buf, const specprob_update_response *elem);
+
+size_t pack_station_del_by_mac_request(void *buf, const station_del_by_mac_request *elem);
+
+size_t pack_station_del_by_mac_response(void *buf, const station_del_by_mac_response *elem);
+
+size_t pack_station_del_by_id_request(void *buf, const station_del_by_id_request *elem);
+
+size_t pack_station_del_by_id_response(void *buf, const station_del_by_id_response *elem);
+
+size_t pack_station_add_request(void *buf, const station_add_request *elem);
+
+size_t pack_station_add_response(void *buf, const station_add_response *elem);
+
+size_t pack_medium_update_request(void *buf, const medium_update_request *elem);
+
+size_t pack_medium_update_response(void *buf, const medium_update_response *elem);
+
+size_t pack_station_bulk_add_request(void *buf, const station_bulk_add_request *elem);
+
+size_t pack_station_bulk_add_response(void *buf, const station_bulk_add_response *elem);
+
+size_t pack_station_bulk_del_request(void *buf, const station_bulk_del_request *elem);
+
+size_t pack_station_bulk_del_response(void *buf, const station_bulk_del_response *elem);
+
+size_t unpack_snr_update_request(const void *buf, snr_update_request *elem);
+
+size_t unpack_snr_update_response(const void *buf, snr_update_response *elem);
+
+size_t unpack_position_update_request(const void *buf, position_update_request *elem);
+
+size_t unpack_position_update_response(const void *buf, position_update_response *elem);
+
+size_t unpack_txpower_update_request(const void *buf, txpower_update_request *elem);
+
+size_t unpack_txpower_update_response(const void *buf, txpower_update_response *elem);
+
+size_t unpack_gaussian_random_update_request(const void *buf, gaussian_random_update_request *elem);
+
+size_t unpack_gaussian_random_update_response(const void *buf, gaussian_random_update_response *elem);
+
+size_t unpack_gain_update_request(const void *buf, gain_update_request *elem);
+
+size_t unpack_gain_update_response(const void *buf, gain_update_response *elem);
+
+size_t unpack_errprob_update_request(const void *buf, errprob_update_request *elem);
+
+size_t unpack_errprob_update_response(const void *buf, errprob_update_response *elem);
+
+size_t unpack_specprob_update_request(const void *buf, specprob_update_request *elem);
+
+size_t unpack_specprob_update_response(const void *buf, specprob_update_response *elem);
+
+size_t unpack_station_del_by_mac_request(const void *buf, station_del_by_mac_request *elem);
+
+size_t unpack_station_del_by_mac_response(const void *buf, station_del_by_mac_response *elem);
+
+size_t unpack_station_del_by_id_request(const void *buf, station_del_by_id_request *elem);
+
+size_t unpack_station_del_by_id_response(const void *buf, station_del_by_id_response *elem);
+
+size_t unpack_station_add_request(const void *buf, station_add_request *elem);
+
+size_t unpack_station_add_response(const void *buf, station_add_response *elem);
+
+size_t unpack_medium_update_request(const void *buf, medium_update_request *elem);
+
+size_t unpack_medium_update_response(const void *buf, medium_update_response *elem);
+
+size_t unpack_station_bulk_add_request(const void *buf, station_bulk_add_request *elem);
+
+size_t unpack_station_bulk_add_response(const void *buf, station_bulk_add_response *elem);
+
+size_t unpack_station_bulk_del_request(const void *buf, station_bulk_del_request *elem);
+
+size_t unpack_station_bulk_del_response(const void *buf, station_bulk_del_response *elem);
+
+size_t pack_station_bulk_add_entrys(void *buf, const station_bulk_add_entry *entries, u32 count);
+
+size_t pack_station_bulk_add_results(void *buf, const station_bulk_add_result *entries, u32 count);
+
+size_t pack_station_bulk_del_entrys(void *buf, const station_bulk_del_entry *entries, u32 count);
+
+size_t pack_station_bulk_del_results(void *buf, const station_bulk_del_result *entries, u32 count);
+
+size_t unpack_station_bulk_add_entrys(const void *buf, station_bulk_add_entry *entries, u32 count);
+
+size_t unpack_station_bulk_add_results(const void *buf, station_bulk_add_result *entries, u32 count);
+
+size_t unpack_station_bulk_del_entrys(const void *buf, station_bulk_del_entry *entries, u32 count);
+
+size_t unpack_station_bulk_del_results(const void *buf, station_bulk_del_result *entries, u32 count);
+
+int send_matrix_rows_request(int sock, const matrix_rows_request *elem);
+
+int recv_matrix_rows_request(int sock, matrix_rows_request *elem);
+
+size_t pack_matrix_rows_request(void *buf, const matrix_rows_request *elem);
+
+size_t unpack_matrix_rows_request(const void *buf, matrix_rows_request *elem);
+
+int send_matrix_rows_response(int sock, const matrix_rows_response *elem);
+
+int recv_matrix_rows_response(int sock, matrix_rows_response *elem);
+
+size_t pack_matrix_rows_response(void *buf, const matrix_rows_response *elem);
+
+size_t unpack_matrix_rows_response(const void *buf, matrix_rows_response *elem);
+
+int send_matrix_triplets_request(int sock, const matrix_triplets_request *elem);
+
+int recv_matrix_triplets_request(int sock, matrix_triplets_request *elem);
+
+size_t pack_matrix_triplets_request(void *buf, const matrix_triplets_request *elem);
+
+size_t unpack_matrix_triplets_request(const void *buf, matrix_triplets_request *elem);
+
+int send_matrix_triplets_response(int sock, const matrix_triplets_response *elem);
+
+int recv_matrix_triplets_response(int sock, matrix_triplets_response *elem);
+
+size_t pack_matrix_triplets_response(void *buf, const matrix_triplets_response *elem);
+
+size_t unpack_matrix_triplets_response(const void *buf, matrix_triplets_response *elem);
+
+int send_matrix_addr_entrys(int sock, const matrix_addr_entry *entries, u32 count);
+
+int recv_matrix_addr_entrys(int sock, matrix_addr_entry *entries, u32 count);
+
+size_t pack_matrix_addr_entrys(void *buf, const matrix_addr_entry *entries, u32 count);
+
+size_t unpack_matrix_addr_entrys(const void *buf, matrix_addr_entry *entries, u32 count);
+
+int send_matrix_value_entrys(int sock, const matrix_value_entry *entries, u32 count);
+
+int recv_matrix_value_entrys(int sock, matrix_value_entry *entries, u32 count);
+
+size_t pack_matrix_value_entrys(void *buf, const matrix_value_entry *entries, u32 count);
+
+size_t unpack_matrix_value_entrys(const void *buf, matrix_value_entry *entries, u32 count);
+
+int send_matrix_triplet_entrys(int sock, const matrix_triplet_entry *entries, u32 count);
+
+int recv_matrix_triplet_entrys(int sock, matrix_triplet_entry *entries, u32 count);
+
+size_t pack_matrix_triplet_entrys(void *buf, const matrix_triplet_entry *entries, u32 count);
+
+size_t unpack_matrix_triplet_entrys(const void *buf, matrix_triplet_entry *entries, u32 count);
+
+int send_station_update_request(int sock, const station_update_request *elem);
+
+int recv_station_update_request(int sock, station_update_request *elem);
+
+size_t pack_station_update_request(void *buf, const station_update_request *elem);
+
+size_t unpack_station_update_request(const void *buf, station_update_request *elem);
+
+int send_station_update_response(int sock, const station_update_response *elem);
+
+int recv_station_update_response(int sock, station_update_response *elem);
+
+size_t pack_station_update_response(void *buf, const station_update_response *elem);
+
+size_t unpack_station_update_response(const void *buf, station_update_response *elem);
+
+int send_station_update_entrys(int sock, const station_update_entry *entries, u32 count);
+
+int recv_station_update_entrys(int sock, station_update_entry *entries, u32 count);
+
+size_t pack_station_update_entrys(void *buf, const station_update_entry *entries, u32 count);
+
+size_t unpack_station_update_entrys(const void *buf, station_update_entry *entries, u32 count);
+
+int send_station_update_results(int sock, const station_update_result *entries, u32 count);
+
+int recv_station_update_results(int sock, station_update_result *entries, u32 count);
+
+size_t pack_station_update_results(void *buf, const station_update_result *entries, u32 count);
+
+size_t unpack_station_update_results(const void *buf, station_update_result *entries, u32 count);
+
+int send_link_query_request(int sock, const link_query_request *elem);
+
+int recv_link_query_request(int sock, link_query_request *elem);
+
+size_t pack_link_query_request(void *buf, const link_query_request *elem);
+
+size_t unpack_link_query_request(const void *buf, link_query_request *elem);
+
+int send_link_query_response(int sock, const link_query_response *elem);
+
+int recv_link_query_response(int sock, link_query_response *elem);
+
+size_t pack_link_query_response(void *buf, const link_query_response *elem);
+
+size_t unpack_link_query_response(const void *buf, link_query_response *elem);
+
+int send_matrix_query_request(int sock, const matrix_query_request *elem);
+
+int recv_matrix_query_request(int sock, matrix_query_request *elem);
+
+size_t pack_matrix_query_request(void *buf, const matrix_query_request *elem);
+
+size_t unpack_matrix_query_request(const void *buf, matrix_query_request *elem);
+
+int send_matrix_query_response(int sock, const matrix_query_response *elem);
+
+int recv_matrix_query_response(int sock, matrix_query_response *elem);
+
+size_t pack_matrix_query_response(void *buf, const matrix_query_response *elem);
+
+size_t unpack_matrix_query_response(const void *buf, matrix_query_response *elem);
+
+int send_station_query_request(int sock, const station_query_request *elem);
+
+int recv_station_query_request(int sock, station_query_request *elem);
+
+size_t pack_station_query_request(void *buf, const station_query_request *elem);
+
+size_t unpack_station_query_request(const void *buf, station_query_request *elem);
+
+int send_station_query_response(int sock, const station_query_response *elem);
+
+int recv_station_query_response(int sock, station_query_response *elem);
+
+size_t pack_station_query_response(void *buf, const station_query_response *elem);
+
+size_t unpack_station_query_response(const void *buf, station_query_response *elem);
+
+int send_station_info_entrys(int sock, const station_info_entry *entries, u32 count);
+
+int recv_station_info_entrys(int sock, station_info_entry *entries, u32 count);
+
+size_t pack_station_info_entrys(void *buf, const station_info_entry *entries, u32 count);
+
+size_t unpack_station_info_entrys(const void *buf, station_info_entry *entries, u32 count);
+
+int send_subscribe_request(int sock, const subscribe_request *elem);
+
+int recv_subscribe_request(int sock, subscribe_request *elem);
+
+size_t pack_subscribe_request(void *buf, const subscribe_request *elem);
+
+size_t unpack_subscribe_request(const void *buf, subscribe_request *elem);
+
+int send_subscribe_response(int sock, const subscribe_response *elem);
+
+int recv_subscribe_response(int sock, subscribe_response *elem);
+
+size_t pack_subscribe_response(void *buf, const subscribe_response *elem);
+
+size_t unpack_subscribe_response(const void *buf, subscribe_response *elem);
+
+int send_link_delta_notification(int sock, const link_delta_notification *elem);
+
+int recv_link_delta_notification(int sock, link_delta_notification *elem);
+
+size_t pack_link_delta_notification(void *buf, const link_delta_notification *elem);
+
+size_t unpack_link_delta_notification(const void *buf, link_delta_notification *elem);
+
+int send_link_delta_entrys(int sock, const link_delta_entry *entries, u32 count);
+
+int recv_link_delta_entrys(int sock, link_delta_entry *entries, u32 count);
+
+size_t pack_link_delta_entrys(void *buf, const link_delta_entry *entries, u32 count);
+
+size_t unpack_link_delta_entrys(const void *buf, link_delta_entry *entries, u32 count);
+
+int send_shm_attach_request(int sock, const shm_attach_request *elem);
+
+int recv_shm_attach_request(int sock, shm_attach_request *elem);
+
+size_t pack_shm_attach_request(void *buf, const shm_attach_request *elem);
+
+size_t unpack_shm_attach_request(const void *buf, shm_attach_request *elem);
+
+int send_shm_attach_response(int sock, const shm_attach_response *elem);
+
+int recv_shm_attach_response(int sock, shm_attach_response *elem);
+
+size_t pack_shm_attach_response(void *buf, const shm_attach_response *elem);
+
+size_t unpack_shm_attach_response(const void *buf, shm_attach_response *elem);
+
+int send_link_stats_request(int sock, const link_stats_request *elem);
+
+int recv_link_stats_request(int sock, link_stats_request *elem);
+
+size_t pack_link_stats_request(void *buf, const link_stats_request *elem);
+
+size_t unpack_link_stats_request(const void *buf, link_stats_request *elem);
+
+int send_link_stats_response(int sock, const link_stats_response *elem);
+
+int recv_link_stats_response(int sock, link_stats_response *elem);
+
+size_t pack_link_stats_response(void *buf, const link_stats_response *elem);
+
+size_t unpack_link_stats_response(const void *buf, link_stats_response *elem);
+
+int send_link_stats_entrys(int sock, const link_stats_entry *entries, u32 count);
+
+int recv_link_stats_entrys(int sock, link_stats_entry *entries, u32 count);
+
+size_t pack_link_stats_entrys(void *buf, const link_stats_entry *entries, u32 count);
+
+size_t unpack_link_stats_entrys(const void *buf, link_stats_entry *entries, u32 count);
+
+int send_metrics_request(int sock, const metrics_request *elem);
+
+int recv_metrics_request(int sock, metrics_request *elem);
+
+size_t pack_metrics_request(void *buf, const metrics_request *elem);
+
+size_t unpack_metrics_request(const void *buf, metrics_request *elem);
+
+int send_metrics_response(int sock, const metrics_response *elem);
+
+int recv_metrics_response(int sock, metrics_response *elem);
+
+size_t pack_metrics_response(void *buf, const metrics_response *elem);
+
+size_t unpack_metrics_response(const void *buf, metrics_response *elem);
+
+int send_metrics_stage_entrys(int sock, const metrics_stage_entry *entries, u32 count);
+
+int recv_metrics_stage_entrys(int sock, metrics_stage_entry *entries, u32 count);
+
+size_t pack_metrics_stage_entrys(void *buf, const metrics_stage_entry *entries, u32 count);
+
+size_t unpack_metrics_stage_entrys(const void *buf, metrics_stage_entry *entries, u32 count);
+
+int send_recorder_request(int sock, const recorder_request *elem);
+
+int recv_recorder_request(int sock, recorder_request *elem);
+
+size_t pack_recorder_request(void *buf, const recorder_request *elem);
+
+size_t unpack_recorder_request(const void *buf, recorder_request *elem);
+
+int send_recorder_response(int sock, const recorder_response *elem);
+
+int recv_recorder_response(int sock, recorder_response *elem);
+
+size_t pack_recorder_response(void *buf, const recorder_response *elem);
+
+size_t unpack_recorder_response(const void *buf, recorder_response *elem);
+
+int send_recorder_entrys(int sock, const recorder_entry *entries, u32 count);
+
+int recv_recorder_entrys(int sock, recorder_entry *entries, u32 count);
+
+size_t pack_recorder_entrys(void *buf, const recorder_entry *entries, u32 count);
+
+size_t unpack_recorder_entrys(const void *buf, recorder_entry *entries, u32 count);
+
 double custom_fixed_point_to_floating_point(u32 fixed_point);
 
 u32 custom_floating_point_to_fixed_point(double floating_point);
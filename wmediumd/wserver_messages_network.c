@@ -19,7 +19,9 @@
  */
 
 #include <netinet/in.h>
+#include <endian.h>
 #include <errno.h>
+#include <string.h>
 #include "wserver_messages_network.h"
 
 
@@ -79,6 +81,21 @@ void ntohi_wrapper(i32 *value) {
     *value = ntohl(*value);
 }
 
+/* Floats and other 32 bit fields that may sit unaligned in a packed message */
+void htonf_wrapper(void *value) {
+    u32 bits;
+    memcpy(&bits, value, sizeof(bits));
+    bits = htonl(bits);
+    memcpy(value, &bits, sizeof(bits));
+}
+
+void ntohf_wrapper(void *value) {
+    u32 bits;
+    memcpy(&bits, value, sizeof(bits));
+    bits = ntohl(bits);
+    memcpy(value, &bits, sizeof(bits));
+}
+
 void hton_base(wserver_msg *elem) {
     UNUSED(elem);
 }
@@ -195,6 +212,255 @@ void hton_medium_update_response(medium_update_response *elem) {
     hton_medium_update_request(&elem->request);
 }
 
+void hton_station_bulk_add_request(station_bulk_add_request *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_bulk_add_response(station_bulk_add_response *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_bulk_add_entry(station_bulk_add_entry *elem) {
+    htonf_wrapper(&elem->posX);
+    htonf_wrapper(&elem->posY);
+    htonf_wrapper(&elem->posZ);
+    elem->txpower_ = htonl(elem->txpower_);
+    elem->gain_ = htonl(elem->gain_);
+    htonf_wrapper(&elem->gaussian_random_);
+}
+
+void hton_station_bulk_add_result(station_bulk_add_result *elem) {
+    elem->created_id = htonl(elem->created_id);
+}
+
+void hton_station_bulk_del_request(station_bulk_del_request *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_bulk_del_response(station_bulk_del_response *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_bulk_del_entry(station_bulk_del_entry *elem) {
+    UNUSED(elem);
+}
+
+void hton_station_bulk_del_result(station_bulk_del_result *elem) {
+    UNUSED(elem);
+}
+
+void hton_matrix_rows_request(matrix_rows_request *elem) {
+    hton_base(&elem->base);
+    elem->num_rows = htonl(elem->num_rows);
+    elem->num_cols = htonl(elem->num_cols);
+}
+
+void hton_matrix_rows_response(matrix_rows_response *elem) {
+    hton_base(&elem->base);
+    elem->applied = htonl(elem->applied);
+    elem->not_found = htonl(elem->not_found);
+}
+
+void hton_matrix_triplets_request(matrix_triplets_request *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_matrix_triplets_response(matrix_triplets_response *elem) {
+    hton_base(&elem->base);
+    elem->applied = htonl(elem->applied);
+    elem->not_found = htonl(elem->not_found);
+}
+
+void hton_matrix_addr_entry(matrix_addr_entry *elem) {
+    UNUSED(elem);
+}
+
+void hton_matrix_value_entry(matrix_value_entry *elem) {
+    elem->value = htonl(elem->value);
+}
+
+void hton_matrix_triplet_entry(matrix_triplet_entry *elem) {
+    elem->value = htonl(elem->value);
+}
+
+void hton_station_update_request(station_update_request *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_update_response(station_update_response *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_update_entry(station_update_entry *elem) {
+    htonf_wrapper(&elem->posX);
+    htonf_wrapper(&elem->posY);
+    htonf_wrapper(&elem->posZ);
+    elem->txpower_ = htonl(elem->txpower_);
+    elem->gain_ = htonl(elem->gain_);
+    htonf_wrapper(&elem->gaussian_random_);
+}
+
+void hton_station_update_result(station_update_result *elem) {
+    UNUSED(elem);
+}
+
+void hton_link_query_request(link_query_request *elem) {
+    hton_base(&elem->base);
+}
+
+void hton_link_query_response(link_query_response *elem) {
+    hton_base(&elem->base);
+    hton_link_query_request(&elem->request);
+    elem->version = htonl(elem->version);
+    elem->snr = htonl(elem->snr);
+    elem->errprob = htonl(elem->errprob);
+}
+
+void hton_matrix_query_request(matrix_query_request *elem) {
+    hton_base(&elem->base);
+    elem->num_rows = htonl(elem->num_rows);
+}
+
+void hton_matrix_query_response(matrix_query_response *elem) {
+    hton_base(&elem->base);
+    elem->version = htonl(elem->version);
+    elem->num_rows = htonl(elem->num_rows);
+    elem->num_cols = htonl(elem->num_cols);
+    elem->not_found = htonl(elem->not_found);
+}
+
+void hton_station_query_request(station_query_request *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_query_response(station_query_response *elem) {
+    hton_base(&elem->base);
+    elem->version = htonl(elem->version);
+    elem->count = htonl(elem->count);
+}
+
+void hton_station_info_entry(station_info_entry *elem) {
+    htonf_wrapper(&elem->posX);
+    htonf_wrapper(&elem->posY);
+    htonf_wrapper(&elem->posZ);
+    elem->txpower_ = htonl(elem->txpower_);
+    elem->gain_ = htonl(elem->gain_);
+    htonf_wrapper(&elem->gaussian_random_);
+    elem->isap = htonl(elem->isap);
+    elem->medium_id_ = htonl(elem->medium_id_);
+}
+
+void hton_subscribe_request(subscribe_request *elem) {
+    hton_base(&elem->base);
+    elem->threshold = htonl(elem->threshold);
+}
+
+void hton_subscribe_response(subscribe_response *elem) {
+    hton_base(&elem->base);
+    hton_subscribe_request(&elem->request);
+    elem->version = htonl(elem->version);
+}
+
+void hton_link_delta_notification(link_delta_notification *elem) {
+    hton_base(&elem->base);
+    elem->version = htonl(elem->version);
+    elem->tv_sec = htonl(elem->tv_sec);
+    elem->tv_nsec = htonl(elem->tv_nsec);
+    elem->count = htonl(elem->count);
+}
+
+void hton_link_delta_entry(link_delta_entry *elem) {
+    elem->old_snr = htonl(elem->old_snr);
+    elem->new_snr = htonl(elem->new_snr);
+}
+
+void hton_shm_attach_request(shm_attach_request *elem) {
+    hton_base(&elem->base);
+    elem->num_slots = htonl(elem->num_slots);
+}
+
+void hton_shm_attach_response(shm_attach_response *elem) {
+    hton_base(&elem->base);
+    hton_shm_attach_request(&elem->request);
+    elem->size = htonl(elem->size);
+}
+
+void hton_link_stats_request(link_stats_request *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+}
+
+void hton_link_stats_response(link_stats_response *elem) {
+    hton_base(&elem->base);
+    elem->count = htonl(elem->count);
+    elem->total = htonl(elem->total);
+}
+
+void hton_link_stats_entry(link_stats_entry *elem) {
+    elem->frames = htobe64(elem->frames);
+    elem->acked = htobe64(elem->acked);
+    elem->failed = htobe64(elem->failed);
+    elem->retries = htobe64(elem->retries);
+    elem->bytes = htobe64(elem->bytes);
+    elem->airtime = htobe64(elem->airtime);
+}
+
+void hton_metrics_request(metrics_request *elem) {
+    hton_base(&elem->base);
+}
+
+void hton_metrics_response(metrics_response *elem) {
+    hton_base(&elem->base);
+    elem->frames = htobe64(elem->frames);
+    elem->dropped = htobe64(elem->dropped);
+    elem->global_errors = htobe64(elem->global_errors);
+    elem->tx_status_errors = htobe64(elem->tx_status_errors);
+    elem->count = htonl(elem->count);
+}
+
+void hton_metrics_stage_entry(metrics_stage_entry *elem) {
+    elem->count = htobe64(elem->count);
+    elem->sum = htobe64(elem->sum);
+    elem->max = htobe64(elem->max);
+    elem->p50 = htobe64(elem->p50);
+    elem->p90 = htobe64(elem->p90);
+    elem->p99 = htobe64(elem->p99);
+    elem->p999 = htobe64(elem->p999);
+}
+
+void hton_recorder_request(recorder_request *elem) {
+    hton_base(&elem->base);
+    elem->max = htonl(elem->max);
+}
+
+void hton_recorder_response(recorder_response *elem) {
+    hton_base(&elem->base);
+    elem->total = htobe64(elem->total);
+    elem->count = htonl(elem->count);
+}
+
+void hton_recorder_entry(recorder_entry *elem) {
+    elem->cookie = htobe64(elem->cookie);
+    elem->received = htobe64(elem->received);
+    elem->parsed = htobe64(elem->parsed);
+    elem->sent = htobe64(elem->sent);
+    elem->replied = htobe64(elem->replied);
+    elem->status_sent = htobe64(elem->status_sent);
+    elem->freq = htonl(elem->freq);
+    elem->signal = htonl(elem->signal);
+    elem->flags = htonl(elem->flags);
+    elem->data_len = htonl(elem->data_len);
+    elem->rate_idx = htonl(elem->rate_idx);
+}
+
 void ntoh_base(wserver_msg *elem) {
     UNUSED(elem);
 }
@@ -309,4 +575,253 @@ void ntoh_medium_update_request(medium_update_request *elem) {
 void ntoh_medium_update_response(medium_update_response *elem) {
     ntoh_base(&elem->base);
     ntoh_medium_update_request(&elem->request);
-}
\ No newline at end of file
+}
+
+void ntoh_station_bulk_add_request(station_bulk_add_request *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_bulk_add_response(station_bulk_add_response *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_bulk_add_entry(station_bulk_add_entry *elem) {
+    ntohf_wrapper(&elem->posX);
+    ntohf_wrapper(&elem->posY);
+    ntohf_wrapper(&elem->posZ);
+    elem->txpower_ = ntohl(elem->txpower_);
+    elem->gain_ = ntohl(elem->gain_);
+    ntohf_wrapper(&elem->gaussian_random_);
+}
+
+void ntoh_station_bulk_add_result(station_bulk_add_result *elem) {
+    elem->created_id = ntohl(elem->created_id);
+}
+
+void ntoh_station_bulk_del_request(station_bulk_del_request *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_bulk_del_response(station_bulk_del_response *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_bulk_del_entry(station_bulk_del_entry *elem) {
+    UNUSED(elem);
+}
+
+void ntoh_station_bulk_del_result(station_bulk_del_result *elem) {
+    UNUSED(elem);
+}
+
+void ntoh_matrix_rows_request(matrix_rows_request *elem) {
+    ntoh_base(&elem->base);
+    elem->num_rows = ntohl(elem->num_rows);
+    elem->num_cols = ntohl(elem->num_cols);
+}
+
+void ntoh_matrix_rows_response(matrix_rows_response *elem) {
+    ntoh_base(&elem->base);
+    elem->applied = ntohl(elem->applied);
+    elem->not_found = ntohl(elem->not_found);
+}
+
+void ntoh_matrix_triplets_request(matrix_triplets_request *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_matrix_triplets_response(matrix_triplets_response *elem) {
+    ntoh_base(&elem->base);
+    elem->applied = ntohl(elem->applied);
+    elem->not_found = ntohl(elem->not_found);
+}
+
+void ntoh_matrix_addr_entry(matrix_addr_entry *elem) {
+    UNUSED(elem);
+}
+
+void ntoh_matrix_value_entry(matrix_value_entry *elem) {
+    elem->value = ntohl(elem->value);
+}
+
+void ntoh_matrix_triplet_entry(matrix_triplet_entry *elem) {
+    elem->value = ntohl(elem->value);
+}
+
+void ntoh_station_update_request(station_update_request *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_update_response(station_update_response *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_update_entry(station_update_entry *elem) {
+    ntohf_wrapper(&elem->posX);
+    ntohf_wrapper(&elem->posY);
+    ntohf_wrapper(&elem->posZ);
+    elem->txpower_ = ntohl(elem->txpower_);
+    elem->gain_ = ntohl(elem->gain_);
+    ntohf_wrapper(&elem->gaussian_random_);
+}
+
+void ntoh_station_update_result(station_update_result *elem) {
+    UNUSED(elem);
+}
+
+void ntoh_link_query_request(link_query_request *elem) {
+    ntoh_base(&elem->base);
+}
+
+void ntoh_link_query_response(link_query_response *elem) {
+    ntoh_base(&elem->base);
+    ntoh_link_query_request(&elem->request);
+    elem->version = ntohl(elem->version);
+    elem->snr = ntohl(elem->snr);
+    elem->errprob = ntohl(elem->errprob);
+}
+
+void ntoh_matrix_query_request(matrix_query_request *elem) {
+    ntoh_base(&elem->base);
+    elem->num_rows = ntohl(elem->num_rows);
+}
+
+void ntoh_matrix_query_response(matrix_query_response *elem) {
+    ntoh_base(&elem->base);
+    elem->version = ntohl(elem->version);
+    elem->num_rows = ntohl(elem->num_rows);
+    elem->num_cols = ntohl(elem->num_cols);
+    elem->not_found = ntohl(elem->not_found);
+}
+
+void ntoh_station_query_request(station_query_request *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_query_response(station_query_response *elem) {
+    ntoh_base(&elem->base);
+    elem->version = ntohl(elem->version);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_station_info_entry(station_info_entry *elem) {
+    ntohf_wrapper(&elem->posX);
+    ntohf_wrapper(&elem->posY);
+    ntohf_wrapper(&elem->posZ);
+    elem->txpower_ = ntohl(elem->txpower_);
+    elem->gain_ = ntohl(elem->gain_);
+    ntohf_wrapper(&elem->gaussian_random_);
+    elem->isap = ntohl(elem->isap);
+    elem->medium_id_ = ntohl(elem->medium_id_);
+}
+
+void ntoh_subscribe_request(subscribe_request *elem) {
+    ntoh_base(&elem->base);
+    elem->threshold = ntohl(elem->threshold);
+}
+
+void ntoh_subscribe_response(subscribe_response *elem) {
+    ntoh_base(&elem->base);
+    ntoh_subscribe_request(&elem->request);
+    elem->version = ntohl(elem->version);
+}
+
+void ntoh_link_delta_notification(link_delta_notification *elem) {
+    ntoh_base(&elem->base);
+    elem->version = ntohl(elem->version);
+    elem->tv_sec = ntohl(elem->tv_sec);
+    elem->tv_nsec = ntohl(elem->tv_nsec);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_link_delta_entry(link_delta_entry *elem) {
+    elem->old_snr = ntohl(elem->old_snr);
+    elem->new_snr = ntohl(elem->new_snr);
+}
+
+void ntoh_shm_attach_request(shm_attach_request *elem) {
+    ntoh_base(&elem->base);
+    elem->num_slots = ntohl(elem->num_slots);
+}
+
+void ntoh_shm_attach_response(shm_attach_response *elem) {
+    ntoh_base(&elem->base);
+    ntoh_shm_attach_request(&elem->request);
+    elem->size = ntohl(elem->size);
+}
+
+void ntoh_link_stats_request(link_stats_request *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_link_stats_response(link_stats_response *elem) {
+    ntoh_base(&elem->base);
+    elem->count = ntohl(elem->count);
+    elem->total = ntohl(elem->total);
+}
+
+void ntoh_link_stats_entry(link_stats_entry *elem) {
+    elem->frames = be64toh(elem->frames);
+    elem->acked = be64toh(elem->acked);
+    elem->failed = be64toh(elem->failed);
+    elem->retries = be64toh(elem->retries);
+    elem->bytes = be64toh(elem->bytes);
+    elem->airtime = be64toh(elem->airtime);
+}
+
+void ntoh_metrics_request(metrics_request *elem) {
+    ntoh_base(&elem->base);
+}
+
+void ntoh_metrics_response(metrics_response *elem) {
+    ntoh_base(&elem->base);
+    elem->frames = be64toh(elem->frames);
+    elem->dropped = be64toh(elem->dropped);
+    elem->global_errors = be64toh(elem->global_errors);
+    elem->tx_status_errors = be64toh(elem->tx_status_errors);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_metrics_stage_entry(metrics_stage_entry *elem) {
+    elem->count = be64toh(elem->count);
+    elem->sum = be64toh(elem->sum);
+    elem->max = be64toh(elem->max);
+    elem->p50 = be64toh(elem->p50);
+    elem->p90 = be64toh(elem->p90);
+    elem->p99 = be64toh(elem->p99);
+    elem->p999 = be64toh(elem->p999);
+}
+
+void ntoh_recorder_request(recorder_request *elem) {
+    ntoh_base(&elem->base);
+    elem->max = ntohl(elem->max);
+}
+
+void ntoh_recorder_response(recorder_response *elem) {
+    ntoh_base(&elem->base);
+    elem->total = be64toh(elem->total);
+    elem->count = ntohl(elem->count);
+}
+
+void ntoh_recorder_entry(recorder_entry *elem) {
+    elem->cookie = be64toh(elem->cookie);
+    elem->received = be64toh(elem->received);
+    elem->parsed = be64toh(elem->parsed);
+    elem->sent = be64toh(elem->sent);
+    elem->replied = be64toh(elem->replied);
+    elem->status_sent = be64toh(elem->status_sent);
+    elem->freq = ntohl(elem->freq);
+    elem->signal = ntohl(elem->signal);
+    elem->flags = ntohl(elem->flags);
+    elem->data_len = ntohl(elem->data_len);
+    elem->rate_idx = ntohl(elem->rate_idx);
+}
@@ -153,4 +153,168 @@ void ntoh_medium_update_request(medium_update_request *elem);
 
 void ntoh_medium_update_response(medium_update_response *elem);
 
+void hton_station_bulk_add_request(station_bulk_add_request *elem);
+
+void hton_station_bulk_add_response(station_bulk_add_response *elem);
+
+void hton_station_bulk_add_entry(station_bulk_add_entry *elem);
+
+void hton_station_bulk_add_result(station_bulk_add_result *elem);
+
+void hton_station_bulk_del_request(station_bulk_del_request *elem);
+
+void hton_station_bulk_del_response(station_bulk_del_response *elem);
+
+void hton_station_bulk_del_entry(station_bulk_del_entry *elem);
+
+void hton_station_bulk_del_result(station_bulk_del_result *elem);
+
+void ntoh_station_bulk_add_request(station_bulk_add_request *elem);
+
+void ntoh_station_bulk_add_response(station_bulk_add_response *elem);
+
+void ntoh_station_bulk_add_entry(station_bulk_add_entry *elem);
+
+void ntoh_station_bulk_add_result(station_bulk_add_result *elem);
+
+void ntoh_station_bulk_del_request(station_bulk_del_request *elem);
+
+void ntoh_station_bulk_del_response(station_bulk_del_response *elem);
+
+void ntoh_station_bulk_del_entry(station_bulk_del_entry *elem);
+
+void ntoh_station_bulk_del_result(station_bulk_del_result *elem);
+
+void hton_matrix_rows_request(matrix_rows_request *elem);
+
+void hton_matrix_rows_response(matrix_rows_response *elem);
+
+void hton_matrix_triplets_request(matrix_triplets_request *elem);
+
+void hton_matrix_triplets_response(matrix_triplets_response *elem);
+
+void hton_matrix_addr_entry(matrix_addr_entry *elem);
+
+void hton_matrix_value_entry(matrix_value_entry *elem);
+
+void hton_matrix_triplet_entry(matrix_triplet_entry *elem);
+
+void ntoh_matrix_rows_request(matrix_rows_request *elem);
+
+void ntoh_matrix_rows_response(matrix_rows_response *elem);
+
+void ntoh_matrix_triplets_request(matrix_triplets_request *elem);
+
+void ntoh_matrix_triplets_response(matrix_triplets_response *elem);
+
+void ntoh_matrix_addr_entry(matrix_addr_entry *elem);
+
+void ntoh_matrix_value_entry(matrix_value_entry *elem);
+
+void ntoh_matrix_triplet_entry(matrix_triplet_entry *elem);
+
+void hton_station_update_request(station_update_request *elem);
+
+void hton_station_update_response(station_update_response *elem);
+
+void hton_station_update_entry(station_update_entry *elem);
+
+void hton_station_update_result(station_update_result *elem);
+
+void ntoh_station_update_request(station_update_request *elem);
+
+void ntoh_station_update_response(station_update_response *elem);
+
+void ntoh_station_update_entry(station_update_entry *elem);
+
+void ntoh_station_update_result(station_update_result *elem);
+
+void hton_link_query_request(link_query_request *elem);
+
+void hton_link_query_response(link_query_response *elem);
+
+void hton_matrix_query_request(matrix_query_request *elem);
+
+void hton_matrix_query_response(matrix_query_response *elem);
+
+void hton_station_query_request(station_query_request *elem);
+
+void hton_station_query_response(station_query_response *elem);
+
+void hton_station_info_entry(station_info_entry *elem);
+
+void ntoh_link_query_request(link_query_request *elem);
+
+void ntoh_link_query_response(link_query_response *elem);
+
+void ntoh_matrix_query_request(matrix_query_request *elem);
+
+void ntoh_matrix_query_response(matrix_query_response *elem);
+
+void ntoh_station_query_request(station_query_request *elem);
+
+void ntoh_station_query_response(station_query_response *elem);
+
+void ntoh_station_info_entry(station_info_entry *elem);
+
+void hton_subscribe_request(subscribe_request *elem);
+
+void hton_subscribe_response(subscribe_response *elem);
+
+void hton_link_delta_notification(link_delta_notification *elem);
+
+void hton_link_delta_entry(link_delta_entry *elem);
+
+void ntoh_subscribe_request(subscribe_request *elem);
+
+void ntoh_subscribe_response(subscribe_response *elem);
+
+void ntoh_link_delta_notification(link_delta_notification *elem);
+
+void ntoh_link_delta_entry(link_delta_entry *elem);
+
+void hton_shm_attach_request(shm_attach_request *elem);
+
+void hton_shm_attach_response(shm_attach_response *elem);
+
+void ntoh_shm_attach_request(shm_attach_request *elem);
+
+void ntoh_shm_attach_response(shm_attach_response *elem);
+
+void hton_link_stats_request(link_stats_request *elem);
+
+void hton_link_stats_response(link_stats_response *elem);
+
+void hton_link_stats_entry(link_stats_entry *elem);
+
+void ntoh_link_stats_request(link_stats_request *elem);
+
+void ntoh_link_stats_response(link_stats_response *elem);
+
+void ntoh_link_stats_entry(link_stats_entry *elem);
+
+void hton_metrics_request(metrics_request *elem);
+
+void hton_metrics_response(metrics_response *elem);
+
+void hton_metrics_stage_entry(metrics_stage_entry *elem);
+
+void ntoh_metrics_request(metrics_request *elem);
+
+void ntoh_metrics_response(metrics_response *elem);
+
+void ntoh_metrics_stage_entry(metrics_stage_entry *elem);
+
+void hton_recorder_request(recorder_request *elem);
+
+void hton_recorder_response(recorder_response *elem);
+
+void hton_recorder_entry(recorder_entry *elem);
+
+void ntoh_recorder_request(recorder_request *elem);
+
+void ntoh_recorder_response(recorder_response *elem);
+
+void ntoh_recorder_entry(recorder_entry *elem);
+
 #endif //WMEDIUMD_WSERVER_MESSAGES_NETWORK_H
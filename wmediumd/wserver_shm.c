@@ -0,0 +1,117 @@
+/*
+ *	wmediumd_server - server for on-the-fly modifications for wmediumd
+ *	Shared memory control plane
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#define _GNU_SOURCE /* memfd_create */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "wserver_shm.h"
+
+_Static_assert(sizeof(struct wserver_shm_header) == 64, "shm header must fill a cache line");
+_Static_assert(sizeof(struct wserver_shm_slot) == 64, "shm slots must not share cache lines");
+
+int wserver_shm_create(struct wserver_shm *shm, u32 num_slots) {
+    memset(shm, 0, sizeof(*shm));
+    shm->size = sizeof(struct wserver_shm_header) + sizeof(struct wserver_shm_slot) * (size_t) num_slots;
+    shm->num_slots = num_slots;
+    shm->seen = calloc(num_slots + 1, sizeof(*shm->seen));
+    if (!shm->seen) {
+        return -ENOMEM;
+    }
+
+    shm->fd = memfd_create("wmediumd-ctl", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (shm->fd < 0) {
+        int ret = -errno;
+        free(shm->seen);
+        return ret;
+    }
+    void *map = MAP_FAILED;
+    if (ftruncate(shm->fd, shm->size) == 0) {
+        map = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+    }
+    // the writer must not be able to pull the pages from under us
+    if (map == MAP_FAILED || fcntl(shm->fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+        int ret = -errno;
+        if (map != MAP_FAILED) {
+            munmap(map, shm->size);
+        }
+        close(shm->fd);
+        free(shm->seen);
+        return ret;
+    }
+
+    shm->header = map;
+    shm->slots = (struct wserver_shm_slot *) (shm->header + 1);
+    shm->header->magic = WSERVER_SHM_MAGIC;
+    shm->header->version = WSERVER_SHM_VERSION;
+    shm->header->num_slots = num_slots;
+    shm->header->slot_size = sizeof(struct wserver_shm_slot);
+    return 0;
+}
+
+void wserver_shm_free(struct wserver_shm *shm) {
+    if (!shm) {
+        return;
+    }
+    munmap(shm->header, shm->size);
+    close(shm->fd);
+    free(shm->seen);
+}
+
+/**
+ * Copy a slot while the writer may be changing it
+ * @return true if the copy is consistent and newer than the last one applied
+ */
+static bool read_slot(const struct wserver_shm_slot *slot, u32 seen, struct wserver_shm_slot *copy) {
+    const u32 *src = (const u32 *) slot;
+    u32 *dst = (u32 *) copy;
+
+    u32 seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if ((seq & 1) || seq == seen) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(*slot) / sizeof(u32); i++) {
+        dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    // a torn copy is retried on the next poll
+    return __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq && copy->seq == seq;
+}
+
+int wserver_shm_poll(struct wserver_shm *shm,
+                     void (*apply)(const struct wserver_shm_slot *slot, void *data), void *data) {
+    struct wserver_shm_slot copy;
+    int changed = 0;
+
+    for (u32 i = 0; i < shm->num_slots; i++) {
+        if (!read_slot(&shm->slots[i], shm->seen[i], &copy)) {
+            continue;
+        }
+        shm->seen[i] = copy.seq;
+        apply(&copy, data);
+        changed++;
+    }
+    return changed;
+}
@@ -0,0 +1,68 @@
+/*
+ *	wmediumd_server - server for on-the-fly modifications for wmediumd
+ *	Shared memory control plane
+ *
+ *	This program is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU General Public License
+ *	as published by the Free Software Foundation; either version 2
+ *	of the License, or (at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *	02110-1301, USA.
+ */
+
+#ifndef WMEDIUMD_SERVER_SHM_H
+#define WMEDIUMD_SERVER_SHM_H
+
+#include <stddef.h>
+#include "wserver_messages.h"
+
+/**
+ * How often the shared memory regions are looked at
+ */
+#define WSERVER_SHM_POLL_MS 10
+
+/**
+ * A shared memory region handed out to a client
+ */
+struct wserver_shm {
+    int fd;
+    size_t size;
+    struct wserver_shm_header *header;
+    struct wserver_shm_slot *slots;
+    u32 num_slots;
+    u32 *seen; /* last applied seq per slot */
+};
+
+/**
+ * Create a sealed memfd region with num_slots empty slots
+ * @param shm The region to set up
+ * @param num_slots The number of slots
+ * @return 0 on success otherwise a negative errno value
+ */
+int wserver_shm_create(struct wserver_shm *shm, u32 num_slots);
+
+/**
+ * Unmap the region and close its descriptor
+ * @param shm The region, may be NULL
+ */
+void wserver_shm_free(struct wserver_shm *shm);
+
+/**
+ * Look for slots that were written since the last poll
+ * @param shm The region
+ * @param apply Called with a consistent copy of every changed slot
+ * @param data Passed to apply
+ * @return The number of changed slots
+ */
+int wserver_shm_poll(struct wserver_shm *shm,
+                     void (*apply)(const struct wserver_shm_slot *slot, void *data), void *data);
+
+#endif //WMEDIUMD_SERVER_SHM_H